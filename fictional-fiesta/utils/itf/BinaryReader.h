@@ -0,0 +1,120 @@
+#ifndef INCLUDE_FICTIONAL_FIESTA_UTILS_BINARY_READER_H
+#define INCLUDE_FICTIONAL_FIESTA_UTILS_BINARY_READER_H
+
+#include "fictional-fiesta/utils/itf/BinaryWriter.h"
+
+#include <experimental/filesystem>
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace fictionalfiesta
+{
+
+/// @class BinaryReader
+/// @brief Class that reads a binary file written by a BinaryWriter.
+/// @details The file is mapped in memory (POSIX mmap), so the arrays are not parsed nor copied:
+///   readArray returns a pointer into the mapping, which is valid while the reader lives. The
+///   reads past the end of the file throw.
+class BinaryReader
+{
+  public:
+
+    /// @brief Constructor from the path of the file to be read.
+    /// @param filePath Path of the file.
+    /// @throw fictionalfiesta::Exception if the file cannot be mapped.
+    explicit BinaryReader(const std::experimental::filesystem::path& filePath);
+
+    BinaryReader(const BinaryReader&) = delete;
+
+    BinaryReader& operator=(const BinaryReader&) = delete;
+
+    /// @brief Destructor. Unmaps the file.
+    ~BinaryReader();
+
+    /// @brief Reads a value.
+    /// @tparam T Trivially copyable type of the value.
+    /// @return Value read.
+    /// @throw fictionalfiesta::Exception if the file ends before.
+    template <typename T>
+    T read();
+
+    /// @brief Reads a string written by BinaryWriter::writeString.
+    /// @return String read.
+    /// @throw fictionalfiesta::Exception if the file ends before.
+    std::string readString();
+
+    /// @brief Reads an array written by BinaryWriter::writeArray.
+    /// @tparam T Trivially copyable type of the elements.
+    /// @param count Number of elements.
+    /// @return Pointer to the first element, inside the mapping of the file.
+    /// @throw fictionalfiesta::Exception if the file ends before.
+    template <typename T>
+    const T* readArray(std::size_t count);
+
+    /// @brief Skips the padding up to a multiple of a given alignment.
+    /// @param alignment Alignment in bytes.
+    /// @throw fictionalfiesta::Exception if the file ends before.
+    void align(std::size_t alignment);
+
+    /// @brief Gets the number of bytes read.
+    /// @return Offset of the next byte from the start of the file.
+    std::size_t tell() const noexcept;
+
+    /// @brief Gets the size of the file.
+    /// @return Number of bytes of the file.
+    std::size_t size() const noexcept;
+
+  private:
+
+    /// @brief Reads raw bytes.
+    /// @param size Number of bytes.
+    /// @return Pointer to the first byte, inside the mapping of the file.
+    /// @throw fictionalfiesta::Exception if the file ends before.
+    const char* readBytes(std::size_t size);
+
+    /// @brief Throws the exception of a read past the end of the file.
+    /// @throw fictionalfiesta::Exception always.
+    [[noreturn]] void throwTruncated() const;
+
+    /// Path of the file, for the error messages.
+    std::experimental::filesystem::path _filePath;
+
+    /// Start of the mapping of the file (null if the file is empty).
+    const char* _data{nullptr};
+
+    /// Number of bytes of the file.
+    std::size_t _size{0};
+
+    /// Number of bytes read.
+    std::size_t _offset{0};
+};
+
+template <typename T>
+T BinaryReader::read()
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types.");
+  T value;
+  std::memcpy(&value, readBytes(sizeof(T)), sizeof(T));
+  return value;
+}
+
+template <typename T>
+const T* BinaryReader::readArray(std::size_t count)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types.");
+  static_assert(BinaryWriter::ARRAY_ALIGNMENT % alignof(T) == 0, "Misaligned arrays.");
+  // The mapping starts at a page boundary, so aligning the offset aligns the pointer.
+  align(BinaryWriter::ARRAY_ALIGNMENT);
+  if (count > _size / sizeof(T))
+  {
+    throwTruncated();
+  }
+  return reinterpret_cast<const T*>(readBytes(count * sizeof(T)));
+}
+
+} // namespace fictionalfiesta
+
+#endif
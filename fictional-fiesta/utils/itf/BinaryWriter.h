@@ -0,0 +1,97 @@
+#ifndef INCLUDE_FICTIONAL_FIESTA_UTILS_BINARY_WRITER_H
+#define INCLUDE_FICTIONAL_FIESTA_UTILS_BINARY_WRITER_H
+
+#include <experimental/filesystem>
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace fictionalfiesta
+{
+
+/// @class BinaryWriter
+/// @brief Class that writes a binary file in the native byte order.
+/// @details The arrays are aligned to ARRAY_ALIGNMENT bytes from the start of the file, so a
+///   BinaryReader can use them in place once the file is mapped in memory.
+class BinaryWriter
+{
+  public:
+
+    /// @brief Constructor from the path of the file to be written.
+    /// @param filePath Path of the file. It is overwritten if it exists.
+    /// @throw fictionalfiesta::Exception if the file cannot be opened.
+    explicit BinaryWriter(const std::experimental::filesystem::path& filePath);
+
+    /// @brief Writes a value.
+    /// @tparam T Trivially copyable type of the value.
+    /// @param value Value to be written.
+    template <typename T>
+    void write(const T& value);
+
+    /// @brief Writes a string, preceded by its length.
+    /// @param value String to be written.
+    void writeString(const std::string& value);
+
+    /// @brief Writes an array, aligned to ARRAY_ALIGNMENT bytes. Its size is not written.
+    /// @tparam T Trivially copyable type of the elements.
+    /// @param values Pointer to the first element.
+    /// @param count Number of elements.
+    template <typename T>
+    void writeArray(const T* values, std::size_t count);
+
+    /// @brief Pads the file with zeros up to a multiple of a given alignment.
+    /// @param alignment Alignment in bytes.
+    void align(std::size_t alignment);
+
+    /// @brief Gets the number of bytes written.
+    /// @return Offset of the next byte from the start of the file.
+    std::size_t tell() const noexcept;
+
+    /// @brief Flushes and closes the file.
+    /// @throw fictionalfiesta::Exception if the file could not be written.
+    void close();
+
+    /// Alignment of the arrays, in bytes (a cache line).
+    static constexpr std::size_t ARRAY_ALIGNMENT{64};
+
+  private:
+
+    /// @brief Writes raw bytes.
+    /// @param data Pointer to the first byte.
+    /// @param size Number of bytes.
+    void writeBytes(const void* data, std::size_t size);
+
+    /// Path of the file, for the error messages.
+    std::experimental::filesystem::path _filePath;
+
+    /// Buffer of the stream, larger than the default one.
+    std::vector<char> _buffer;
+
+    /// Stream of the file.
+    std::ofstream _stream;
+
+    /// Number of bytes written.
+    std::size_t _offset{0};
+};
+
+template <typename T>
+void BinaryWriter::write(const T& value)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types.");
+  writeBytes(&value, sizeof(T));
+}
+
+template <typename T>
+void BinaryWriter::writeArray(const T* values, std::size_t count)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types.");
+  align(ARRAY_ALIGNMENT);
+  writeBytes(values, count * sizeof(T));
+}
+
+} // namespace fictionalfiesta
+
+#endif
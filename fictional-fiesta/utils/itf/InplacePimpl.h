@@ -0,0 +1,64 @@
+#ifndef INCLUDE_FICTIONAL_FIESTA_UTILS_INPLACE_PIMPL_H
+#define INCLUDE_FICTIONAL_FIESTA_UTILS_INPLACE_PIMPL_H
+
+#include <cstddef>
+
+namespace fictionalfiesta
+{
+
+/// @class InplacePimpl
+/// @brief Helper class to implement the PIMPL idiom without heap allocations.
+/// @details Like Pimpl, but the implementation instance is stored in a buffer of the class
+///   itself, so it is suitable for small handles that are created and copied often. The size and
+///   alignment of the buffer are checked against the implementation class where it is complete.
+/// @tparam T Implementation class.
+/// @tparam Size Size of the buffer, at least the size of @p T.
+/// @tparam Alignment Alignment of the buffer, at least the alignment of @p T.
+template <typename T, std::size_t Size, std::size_t Alignment>
+class InplacePimpl
+{
+  private:
+
+    /// Buffer where the implementation instance is stored.
+    alignas(Alignment) unsigned char _storage[Size];
+
+  public:
+
+    /// @brief Forward constructor.
+    /// Construct directly the underlaying class from the corresponding arguments.
+    /// @param args Arguments to be forwarded to the underlaying class constructor.
+    template<typename ...Args>
+    explicit InplacePimpl(Args&& ...args);
+
+    /// @brief Copy constructor.
+    InplacePimpl(const InplacePimpl&);
+
+    /// @brief Move constructor.
+    InplacePimpl(InplacePimpl&&) noexcept;
+
+    /// @brief Copy assignment operator.
+    InplacePimpl& operator=(const InplacePimpl&);
+
+    /// @brief Move assignment operator.
+    InplacePimpl& operator=(InplacePimpl&&) noexcept;
+
+    ~InplacePimpl();
+
+    /// @brief Arrow derreference operator.
+    /// @return pointer to the internal member.
+    /// @{
+    T* operator->();
+    const T* operator->() const;
+    /// @}
+
+    /// @brief Star derreference operator.
+    /// @return reference to the internal member.
+    /// @{
+    T& operator*();
+    const T& operator*() const;
+    /// @}
+};
+
+} // namespace fictionalfiesta
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef INCLUDE_FICTIONAL_FIESTA_UTILS_PARALLEL_H
+#define INCLUDE_FICTIONAL_FIESTA_UTILS_PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace fictionalfiesta
+{
+
+/// @class Parallel
+/// @brief Static class that runs independent tasks in several threads.
+/// @details The threads are taken from a pool kept alive between the calls, which grows up to
+///   the largest number of threads requested. A call made from a task run by several threads (a
+///   nested call) runs all its tasks inline in the thread of that task, the calling one
+///   included, so the nested calls do not oversubscribe the machine.
+class Parallel
+{
+  public:
+
+    /// @brief Runs a task for every index in [0, taskCount).
+    /// @details The indices are handed out dynamically to the threads, so the order in which the
+    ///   tasks run is unspecified: the tasks must be independent. If some tasks throw, the
+    ///   remaining ones are not started and one of the exceptions is rethrown once all the
+    ///   threads have finished.
+    /// @param taskCount Number of tasks.
+    /// @param threadCount Maximum number of threads (the calling one included). Zero means one
+    ///   per hardware thread.
+    /// @param task Function called with the index of each task.
+    static void forEach(std::size_t taskCount, unsigned int threadCount,
+        const std::function<void(std::size_t)>& task);
+
+    /// @brief Runs a task for every index in [0, costs.size()) balancing their costs.
+    /// @details Work-stealing scheduler: the tasks are dealt to the threads by descending cost,
+    ///   each one to the least loaded thread, and every thread runs its own tasks from the most
+    ///   expensive one. A thread without tasks left steals the cheapest pending task of another
+    ///   thread, so a few big tasks start first and the small ones fill the gaps. The tasks must
+    ///   be independent, and the exceptions are handled as in the other overload.
+    /// @param costs Estimated cost of each task. Only their relative values matter.
+    /// @param threadCount Maximum number of threads (the calling one included). Zero means one
+    ///   per hardware thread.
+    /// @param task Function called with the index of each task.
+    static void forEach(const std::vector<double>& costs, unsigned int threadCount,
+        const std::function<void(std::size_t)>& task);
+
+    /// @brief Gets the number of threads that would be used for a given thread count.
+    /// @param threadCount Requested number of threads. Zero means one per hardware thread.
+    /// @return Number of threads (at least one).
+    static unsigned int resolveThreadCount(unsigned int threadCount);
+};
+
+} // namespace fictionalfiesta
+
+#endif
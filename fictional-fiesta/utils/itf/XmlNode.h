@@ -1,10 +1,14 @@
 #ifndef INCLUDE_FICTIONAL_FIESTA_UTILS_XML_NODE_H
 #define INCLUDE_FICTIONAL_FIESTA_UTILS_XML_NODE_H
 
-#include "fictional-fiesta/utils/itf/Pimpl.h"
+#include "fictional-fiesta/utils/itf/InplacePimpl.h"
 
-#include <sstream>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace fictionalfiesta
@@ -13,6 +17,10 @@ namespace fictionalfiesta
 class XmlNodeImpl;
 
 /// @brief Class to represent a node in an XML document.
+/// @details It is a small handle to the node, which is owned by its document: it can be copied
+///   cheaply and it does not allocate memory. The nodes created by a XmlStreamWriter are written
+///   as they are filled, so they are write-only and must be filled in document order (see
+///   XmlStreamWriter).
 class XmlNode
 {
   public:
@@ -23,8 +31,19 @@ class XmlNode
     /// @param node Node implementation from which to construct this instance.
     explicit XmlNode(const XmlNodeImpl& node);
 
+    /// @brief Copy constructor.
+    /// @details The copy refers to the same node.
+    XmlNode(const XmlNode&);
+
     /// @brief Move Constructor
-    XmlNode(XmlNode&&);
+    XmlNode(XmlNode&&) noexcept;
+
+    /// @brief Copy assignment operator.
+    /// @details This instance then refers to the same node as @p other.
+    XmlNode& operator=(const XmlNode& other);
+
+    /// @brief Move assignment operator.
+    XmlNode& operator=(XmlNode&&) noexcept;
 
     /// @brief Default destructor.
     ~XmlNode();
@@ -197,29 +216,61 @@ class XmlNode
 
   private:
 
+    /// @brief Dumps a value to a string.
+    /// @details Floating point values are written with the fewest digits that read back to the
+    ///   same value, so a saved state is loaded exactly.
+    /// @param content Value to be dumped.
+    /// @return String with the value.
+    template <typename T>
+    static std::string toString(const T& content);
+
     /// @brief Set the text of the node.
     /// @param text Text to be set in the node.
     void setNodeText(const std::string& text);
 
-    /// Pointer to the node implementation.
-    /// We use PIMPL to avoid exposing the XML dependecies.
-    Pimpl<XmlNodeImpl> _pimpl;
+    /// Size of the implementation: a pugi node, the writer, the depth and the identifier.
+    static constexpr std::size_t IMPL_SIZE{4 * sizeof(std::uint64_t)};
+
+    /// Node implementation, stored in place; hides the pugixml dependency.
+    InplacePimpl<XmlNodeImpl, IMPL_SIZE, alignof(std::uint64_t)> _pimpl;
 };
 
 template <typename T>
 void XmlNode::setText(const T& content)
 {
-  std::stringstream ss;
-  ss << std::boolalpha << content;
-  setNodeText(ss.str());
+  setNodeText(toString(content));
 }
 
 template <typename T>
 void XmlNode::setAttribute(const std::string& name, const T& content)
 {
-  std::stringstream ss;
-  ss << std::boolalpha << content;
-  setAttribute(name, ss.str());
+  setAttribute(name, toString(content));
+}
+
+template <typename T>
+std::string XmlNode::toString(const T& content)
+{
+  if constexpr (std::is_same_v<T, bool>)
+  {
+    return content ? "true" : "false";
+  }
+  else if constexpr (std::is_same_v<T, char> || std::is_same_v<T, signed char> ||
+      std::is_same_v<T, unsigned char>)
+  {
+    // The character types are written as characters, as the streams do, and not as numbers.
+    return std::string(1, static_cast<char>(content));
+  }
+  else if constexpr (std::is_arithmetic_v<T>)
+  {
+    // Without a format, the floating point values are written in their shortest round-trip form.
+    std::array<char, 64> buffer;
+    const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), content);
+    return std::string(buffer.data(), result.ptr);
+  }
+  else
+  {
+    return std::string{content};
+  }
 }
 
 } // namespace fictional-fiesta
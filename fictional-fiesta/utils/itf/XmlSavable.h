@@ -22,11 +22,17 @@ class XmlSavable
     void save(XmlNode node) const;
 
     /// @brief Save the class contents into a file.
+    /// @details The contents are streamed (XmlStreamWriter), so doSave must fill the nodes in
+    ///   document order.
     /// @param filePath Path where the XML will be saved.
+    /// @throw Exception if the file could not be written.
     void save(const std::experimental::filesystem::path& filePath) const;
 
-    /// @brief Save the class contents into a file.
+    /// @brief Save the class contents into a stream.
+    /// @details The contents are streamed (XmlStreamWriter), so doSave must fill the nodes in
+    ///   document order.
     /// @param stream Stream where the XML will be saved.
+    /// @throw Exception if the stream fails.
     void save(std::ostream& stream) const;
 
     /// @brief Save the class contents into a string.
@@ -0,0 +1,314 @@
+#ifndef INCLUDE_FICTIONAL_FIESTA_UTILS_XML_STREAM_READER_H
+#define INCLUDE_FICTIONAL_FIESTA_UTILS_XML_STREAM_READER_H
+
+#include "fictional-fiesta/utils/itf/Exception.h"
+
+#include <experimental/filesystem>
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fictionalfiesta
+{
+
+class XmlNode;
+
+/// @brief Class that reads a XML document element by element while the file is read, instead of
+///   loading the whole document in memory first.
+/// @details The reader is positioned at an element (the current one) right after its start tag,
+///   so its name and attributes are available. The children of an element are read with
+///   nextChildElement, in document order; the ones that are not read are skipped. The text of
+///   an element must be read before its children. Same parse options as XmlDocument: entities
+///   and CDATA sections are decoded, the line ends are normalized, the white spaces in the
+///   attributes are converted to spaces and the texts with only white spaces are ignored.
+class XmlStreamReader
+{
+  public:
+
+    /// @brief Constructor from the path of the XML document.
+    /// @details The reader is positioned at the root element.
+    /// @param filePath Path of the XML document.
+    /// @throw Exception if the file cannot be read or has no root element.
+    explicit XmlStreamReader(const std::experimental::filesystem::path& filePath);
+
+    /// @brief Constructor from a byte range of a XML document with whole elements.
+    /// @details Used to read elements found by another reader (see getElementOffset and
+    ///   skipElement) independently, for example in another thread. The reader is positioned at
+    ///   the first element; the next ones are read with nextElement.
+    /// @param filePath Path of the XML document.
+    /// @param begin Offset of the start tag of the first element.
+    /// @param end Offset just past the end tag of the last element.
+    /// @throw Exception if the file cannot be read or the range has no element.
+    XmlStreamReader(const std::experimental::filesystem::path& filePath, std::uint64_t begin,
+        std::uint64_t end);
+
+    /// @brief Constructor from a stream with the XML document.
+    /// @details The reader is positioned at the root element.
+    /// @param stream Stream with the XML document. It must outlive the reader.
+    /// @throw Exception if the document has no root element.
+    explicit XmlStreamReader(std::istream& stream);
+
+    XmlStreamReader(const XmlStreamReader&) = delete;
+
+    XmlStreamReader& operator=(const XmlStreamReader&) = delete;
+
+    /// @brief Get the path of the XML document.
+    /// @return Path of the document, empty if it is read from a stream.
+    const std::experimental::filesystem::path& getFilePath() const;
+
+    /// @brief Get the offset in the document of the start tag of the current element.
+    /// @return Offset in bytes from the beginning of the document.
+    std::uint64_t getElementOffset() const;
+
+    /// @brief Get the name of the current element.
+    /// @return Name of the current element.
+    const std::string& getName() const;
+
+    /// @brief Get the depth of the current element.
+    /// @note The root element must not be closed yet.
+    /// @return Depth of the current element (zero for the root).
+    std::size_t getDepth() const;
+
+    /// @brief Checks whether the current element has an specific attribute or not.
+    /// @param attributeName Name of the attribute to be checked.
+    /// @return true if the element has an attribute with the passed name, false otherwise.
+    bool hasAttribute(const std::string& attributeName) const;
+
+    /// @brief Get the attribute of the current element with the passed name.
+    /// @param attributeName Name of the attribute to be retrieved.
+    /// @return Value of the attribute.
+    /// @throw Exception if there is no attribute with the given name.
+    std::string getAttribute(const std::string& attributeName) const;
+
+    /// @brief Get the attribute of the current element and parse it into @p T type.
+    /// @tparam T Type into which the attribute needs to be parsed.
+    /// @param attributeName Name of the attribute to be retrieved.
+    /// @return value resulting of the parsing.
+    /// @throw Exception if the attribute is not present.
+    template <typename T>
+    T getAttributeAs(const std::string& attributeName) const;
+
+    /// @brief Get the optional attribute of the current element and parse it into @p T type.
+    /// @tparam T Type into which the attribute needs to be parsed.
+    /// @param attributeName Name of the attribute to be retrieved.
+    /// @param defaultValue Value to be returned when there is no such an attribute.
+    /// @return Attribute value or defaultValue if the attribute is not present.
+    template <typename T>
+    T getOptionalAttributeAs(const std::string& attributeName, const T& defaultValue) const;
+
+    /// @brief Reads up to the next child element of the element at a given depth.
+    /// @details Usually called in a loop, with the depth of the parent element, until it returns
+    ///   @e false. The contents of the previous child that were not read are skipped.
+    /// @param depth Depth of the parent element.
+    /// @return @e true if the reader is positioned at the next child, @e false if the parent
+    ///   element has no more children (its end tag has been read).
+    /// @throw Exception if the document is not well formed.
+    bool nextChildElement(std::size_t depth);
+
+    /// @brief Reads up to the next element at depth zero.
+    /// @details Only useful for byte ranges with several elements. The contents of the previous
+    ///   element that were not read are skipped.
+    /// @return @e true if the reader is positioned at the next element, @e false if there are no
+    ///   more elements.
+    /// @throw Exception if the document is not well formed.
+    bool nextElement();
+
+    /// @brief Skips the current element, up to its end tag.
+    /// @details Much faster than reading it, as only the nesting of its tags is followed: they
+    ///   are not checked, so a malformed element is only detected when it is read.
+    /// @return Offset in the document just past the end tag of the element.
+    /// @throw Exception if the contents of the element have already been read.
+    std::uint64_t skipElement();
+
+    /// @brief Reads the text of the current element, up to its end tag.
+    /// @details The child elements are skipped.
+    /// @return Text of the current element.
+    /// @throw Exception if the element has no text or its children have already been read.
+    std::string getText();
+
+    /// @brief Reads the text of the current element and parse it into @p T type.
+    /// @tparam T Type into which the text needs to be parsed.
+    /// @return value resulting of the parsing.
+    /// @throw Exception if the element has no text or its children have already been read.
+    template <typename T>
+    T getTextAs();
+
+    /// @brief Reads the current element, up to its end tag, into a node of a document.
+    /// @details Useful to load the small elements through their XmlNode constructors.
+    /// @param node Node where the attributes, the text and the children are appended.
+    /// @throw Exception if the children of the element have already been read.
+    void readInto(XmlNode node);
+
+    /// @brief Gets a value read from a mandatory child element.
+    /// @tparam T Type of the value.
+    /// @param value Value read, empty if the child element was not found.
+    /// @param elementName Name of the parent element.
+    /// @param childName Name of the child element.
+    /// @return The value read.
+    /// @throw Exception if the child element was not found.
+    template <typename T>
+    static T getMandatory(std::optional<T>&& value, const std::string& elementName,
+        const std::string& childName);
+
+    /// @brief Checks that a mandatory child element was found.
+    /// @param isFound Whether the child element was found.
+    /// @param elementName Name of the parent element.
+    /// @param childName Name of the child element.
+    /// @throw Exception if the child element was not found.
+    static void checkMandatory(bool isFound, const std::string& elementName,
+        const std::string& childName);
+
+  private:
+
+    /// @brief Kind of the items read from the document.
+    enum class Token
+    {
+      StartTag,
+      EndTag,
+      Text,
+      End
+    };
+
+    /// @brief Reads up to the start tag of the root element.
+    /// @throw Exception if the document has no root element.
+    void readRootElement();
+
+    /// @brief Reads the next start tag, end tag or text of the document.
+    /// @details The comments, processing instructions and declarations are skipped. A start tag
+    ///   sets the current element; a text is left in _text.
+    /// @param isTextNeeded Whether the texts are needed. If not, they are skipped undecoded.
+    /// @return Kind of item read.
+    Token readToken(bool isTextNeeded = true);
+
+    /// @brief Reads a start tag, after its '<'.
+    void readStartTag();
+
+    /// @brief Reads an end tag, after its "</".
+    void readEndTag();
+
+    /// @brief Skips a tag, after its '<', without checking it.
+    /// @return @e true if it is a self-closing tag.
+    bool skipTag();
+
+    /// @brief Skips a comment or a declaration, after its "<!".
+    void skipDeclaration();
+
+    /// @brief Reads the character data up to the next '<' into _text.
+    void readCharacterData();
+
+    /// @brief Skips the character data up to the next '<'.
+    void skipCharacterData();
+
+    /// @brief Reads a name of element or attribute.
+    /// @param name String where the name read is set.
+    void readName(std::string& name);
+
+    /// @brief Reads an attribute value, with its quotes.
+    /// @return Attribute value, with the entities decoded and the white spaces converted.
+    std::string readAttributeValue();
+
+    /// @brief Reads an entity reference, after its '&', and appends its value.
+    /// @param output String where the value is appended.
+    /// @param terminator Character that ends the enclosing content, e.g. the attribute quote.
+    /// @throw Exception if it is a character reference without digits, with other characters
+    ///   after its digits or with a code point that is not an XML character.
+    void readEntity(std::string& output, char terminator);
+
+    /// @brief Skips the characters up to a given terminator, included.
+    /// @param terminator Terminator to be found.
+    /// @param output String where the skipped characters are appended, if not null.
+    void skipPast(const std::string& terminator, std::string* output = nullptr);
+
+    /// @brief Skips the white spaces.
+    void skipWhiteSpaces();
+
+    /// @brief Reads the next character.
+    /// @return Character read.
+    /// @throw Exception if the document ends.
+    char get();
+
+    /// @brief Gets the next character without reading it.
+    /// @return Next character, or the end of file.
+    int peek();
+
+    /// @brief Gets the offset in the document of the next character.
+    /// @return Offset in bytes from the beginning of the document.
+    std::uint64_t getOffset() const;
+
+    /// @brief Fills the buffer with the next block of the stream.
+    /// @return @e true if there is something left to read.
+    bool fill();
+
+    /// @brief Throws an exception about the document being malformed.
+    /// @param message Description of the problem.
+    [[noreturn]] void throwMalformed(const std::string& message) const;
+
+    /// Path of the document, empty if it is read from a stream.
+    std::experimental::filesystem::path _filePath;
+
+    /// File stream, if the document is read from a file.
+    std::ifstream _file;
+
+    /// Stream of the document.
+    std::istream& _stream;
+
+    /// Block of the stream being read.
+    std::vector<char> _buffer;
+
+    /// Position of the next character in _buffer.
+    std::size_t _position{0};
+
+    /// Number of characters in _buffer.
+    std::size_t _size{0};
+
+    /// Offset in the document of the beginning of _buffer.
+    std::uint64_t _bufferOffset{0};
+
+    /// Number of characters of the stream left to be read into _buffer.
+    std::uint64_t _remaining{std::numeric_limits<std::uint64_t>::max()};
+
+    /// Offset in the document of the start tag of the current element.
+    std::uint64_t _elementOffset{0};
+
+    /// Names of the open elements, from the root, in its first _openCount positions.
+    std::vector<std::string> _openElements;
+
+    /// Number of open elements.
+    std::size_t _openCount{0};
+
+    /// Whether the current element was self-closing, so its end tag is pending.
+    bool _isEndPending{false};
+
+    /// Whether the contents of the current element have started to be read.
+    bool _hasReadContents{false};
+
+    /// Attributes of the current element, in order.
+    std::vector<std::pair<std::string, std::string>> _attributes;
+
+    /// Name of the current element.
+    std::string _name;
+
+    /// Last text read.
+    std::string _text;
+
+    /// Name of the last end tag read.
+    std::string _endTagName;
+};
+
+template <typename T>
+T XmlStreamReader::getMandatory(std::optional<T>&& value, const std::string& elementName,
+    const std::string& childName)
+{
+  checkMandatory(value.has_value(), elementName, childName);
+  return std::move(*value);
+}
+
+} // namespace fictionalfiesta
+
+#endif
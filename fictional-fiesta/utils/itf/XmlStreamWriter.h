@@ -0,0 +1,54 @@
+#ifndef INCLUDE_FICTIONAL_FIESTA_UTILS_XML_STREAM_WRITER_H
+#define INCLUDE_FICTIONAL_FIESTA_UTILS_XML_STREAM_WRITER_H
+
+#include "fictional-fiesta/utils/itf/Pimpl.h"
+
+#include <ostream>
+#include <string>
+
+namespace fictionalfiesta
+{
+
+class XmlNode;
+class XmlStreamWriterImpl;
+
+/// @brief Class that writes a XML document to a stream while its nodes are created, instead of
+///   building the whole document in memory first.
+/// @details The output is the same as the one of XmlDocument::save (pretty printed). The nodes
+///   are written in document order, so they must be filled in that order: the attributes of a
+///   node before its text or its children, and a node is finished as soon as a node that is not
+///   its descendant is appended. Writing in a finished node throws. The nodes are write-only:
+///   they have no attributes nor children to read.
+class XmlStreamWriter
+{
+  public:
+
+    /// @brief Constructor from the stream where the document is written.
+    /// @details The XML declaration is written right away.
+    /// @param stream Stream where the document is written. It must outlive the writer.
+    explicit XmlStreamWriter(std::ostream& stream);
+
+    /// @brief Default destructor.
+    /// @details It does not finish the document: call finish.
+    ~XmlStreamWriter();
+
+    /// @brief Appends the root node of the document.
+    /// @param name Name of the root node.
+    /// @return Root node, to be filled.
+    /// @throw Exception if the document already has a root node.
+    XmlNode appendRootNode(const std::string& name);
+
+    /// @brief Closes the nodes that are still open and flushes the document to the stream.
+    /// @throw Exception if the stream fails.
+    void finish();
+
+  private:
+
+    /// Pointer to the writer implementation.
+    /// We use PIMPL, as XmlNode does, so the nodes can refer to it.
+    Pimpl<XmlStreamWriterImpl> _pimpl;
+};
+
+} // namespace fictionalfiesta
+
+#endif
@@ -0,0 +1,105 @@
+/// @file BinaryReader.cpp Implementation of the BinaryReader class.
+
+#include "fictional-fiesta/utils/itf/BinaryReader.h"
+
+#include "fictional-fiesta/utils/itf/Exception.h"
+
+#include <cstdint>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fictionalfiesta
+{
+
+BinaryReader::BinaryReader(const std::experimental::filesystem::path& filePath):
+  _filePath(filePath)
+{
+  const auto descriptor = ::open(filePath.c_str(), O_RDONLY);
+  if (descriptor < 0)
+  {
+    throw Exception("Error opening the file '" + filePath.string() + "' for reading.");
+  }
+
+  struct stat status;
+  if (::fstat(descriptor, &status) != 0)
+  {
+    ::close(descriptor);
+    throw Exception("Error reading the size of the file '" + filePath.string() + "'.");
+  }
+  _size = static_cast<std::size_t>(status.st_size);
+
+  // A file cannot be mapped with a size of zero.
+  if (_size != 0)
+  {
+    auto* const data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (data == MAP_FAILED)
+    {
+      ::close(descriptor);
+      throw Exception("Error mapping the file '" + filePath.string() + "' in memory.");
+    }
+    _data = static_cast<const char*>(data);
+  }
+
+  // The mapping stays valid after closing the descriptor.
+  ::close(descriptor);
+}
+
+BinaryReader::~BinaryReader()
+{
+  if (_data)
+  {
+    ::munmap(const_cast<char*>(_data), _size);
+  }
+}
+
+std::string BinaryReader::readString()
+{
+  const auto length = read<std::uint64_t>();
+  if (length > _size)
+  {
+    throwTruncated();
+  }
+  const auto* const characters = readBytes(static_cast<std::size_t>(length));
+  return std::string(characters, static_cast<std::size_t>(length));
+}
+
+void BinaryReader::align(std::size_t alignment)
+{
+  const auto remainder = _offset % alignment;
+  if (remainder != 0)
+  {
+    readBytes(alignment - remainder);
+  }
+}
+
+std::size_t BinaryReader::tell() const noexcept
+{
+  return _offset;
+}
+
+std::size_t BinaryReader::size() const noexcept
+{
+  return _size;
+}
+
+const char* BinaryReader::readBytes(std::size_t size)
+{
+  if (size > _size - _offset)
+  {
+    throwTruncated();
+  }
+  const auto* const bytes = _data + _offset;
+  _offset += size;
+  return bytes;
+}
+
+void BinaryReader::throwTruncated() const
+{
+  throw Exception("Unexpected end of the file '" + _filePath.string() + "' at byte " +
+      std::to_string(_offset) + ".");
+}
+
+} // namespace fictionalfiesta
@@ -0,0 +1,69 @@
+/// @file BinaryWriter.cpp Implementation of the BinaryWriter class.
+
+#include "fictional-fiesta/utils/itf/BinaryWriter.h"
+
+#include "fictional-fiesta/utils/itf/Exception.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace fictionalfiesta
+{
+
+namespace
+{
+
+constexpr std::size_t BUFFER_SIZE{1 << 20};
+
+} // anonymous namespace
+
+BinaryWriter::BinaryWriter(const std::experimental::filesystem::path& filePath):
+  _filePath(filePath),
+  _buffer(BUFFER_SIZE)
+{
+  // The buffer must be set before opening the file.
+  _stream.rdbuf()->pubsetbuf(_buffer.data(), _buffer.size());
+  _stream.open(filePath, std::ios::binary | std::ios::trunc);
+  if (!_stream)
+  {
+    throw Exception("Error opening the file '" + filePath.string() + "' for writing.");
+  }
+}
+
+void BinaryWriter::writeString(const std::string& value)
+{
+  write(static_cast<std::uint64_t>(value.size()));
+  writeBytes(value.data(), value.size());
+}
+
+void BinaryWriter::align(std::size_t alignment)
+{
+  static constexpr char zeros[ARRAY_ALIGNMENT]{};
+  while (_offset % alignment != 0)
+  {
+    const auto padding = std::min(alignment - _offset % alignment, sizeof(zeros));
+    writeBytes(zeros, padding);
+  }
+}
+
+std::size_t BinaryWriter::tell() const noexcept
+{
+  return _offset;
+}
+
+void BinaryWriter::close()
+{
+  _stream.close();
+  if (!_stream)
+  {
+    throw Exception("Error writing the file '" + _filePath.string() + "'.");
+  }
+}
+
+void BinaryWriter::writeBytes(const void* data, std::size_t size)
+{
+  _stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+  _offset += size;
+}
+
+} // namespace fictionalfiesta
@@ -0,0 +1,80 @@
+#ifndef INCLUDE_FICTIONAL_FIESTA_UTILS_INPLACE_PIMPL_IMPL_H
+#define INCLUDE_FICTIONAL_FIESTA_UTILS_INPLACE_PIMPL_IMPL_H
+
+#include <new>
+#include <utility>
+
+namespace fictionalfiesta
+{
+
+template <typename T, std::size_t Size, std::size_t Alignment>
+template <typename ...Args>
+InplacePimpl<T, Size, Alignment>::InplacePimpl(Args&& ...args)
+{
+  static_assert(sizeof(T) <= Size, "The buffer of InplacePimpl is too small.");
+  static_assert(Alignment % alignof(T) == 0, "The buffer of InplacePimpl is misaligned.");
+
+  new (_storage) T{std::forward<Args>(args)...};
+}
+
+template <typename T, std::size_t Size, std::size_t Alignment>
+InplacePimpl<T, Size, Alignment>::InplacePimpl(const InplacePimpl& other)
+{
+  new (_storage) T{*other};
+}
+
+template <typename T, std::size_t Size, std::size_t Alignment>
+InplacePimpl<T, Size, Alignment>::InplacePimpl(InplacePimpl&& other) noexcept
+{
+  new (_storage) T{std::move(*other)};
+}
+
+template <typename T, std::size_t Size, std::size_t Alignment>
+InplacePimpl<T, Size, Alignment>& InplacePimpl<T, Size, Alignment>::operator=(
+    const InplacePimpl& other)
+{
+  **this = *other;
+  return *this;
+}
+
+template <typename T, std::size_t Size, std::size_t Alignment>
+InplacePimpl<T, Size, Alignment>& InplacePimpl<T, Size, Alignment>::operator=(
+    InplacePimpl&& other) noexcept
+{
+  **this = std::move(*other);
+  return *this;
+}
+
+template <typename T, std::size_t Size, std::size_t Alignment>
+InplacePimpl<T, Size, Alignment>::~InplacePimpl()
+{
+  (**this).~T();
+}
+
+template <typename T, std::size_t Size, std::size_t Alignment>
+T* InplacePimpl<T, Size, Alignment>::operator->()
+{
+  return std::launder(reinterpret_cast<T*>(_storage));
+}
+
+template <typename T, std::size_t Size, std::size_t Alignment>
+const T* InplacePimpl<T, Size, Alignment>::operator->() const
+{
+  return std::launder(reinterpret_cast<const T*>(_storage));
+}
+
+template <typename T, std::size_t Size, std::size_t Alignment>
+T& InplacePimpl<T, Size, Alignment>::operator*()
+{
+  return *operator->();
+}
+
+template <typename T, std::size_t Size, std::size_t Alignment>
+const T& InplacePimpl<T, Size, Alignment>::operator*() const
+{
+  return *operator->();
+}
+
+} // namespace fictionalfiesta
+
+#endif
@@ -0,0 +1,401 @@
+/// @file Parallel.cpp Implementation of the Parallel class.
+
+#include "fictional-fiesta/utils/itf/Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace fictionalfiesta
+{
+
+namespace
+{
+
+/// @brief Queue of task indices of a thread, from which the other threads can steal.
+/// @details The owner takes the tasks from the front and the thieves from the back. As the tasks
+///   are dealt by descending cost, the thieves take the cheapest ones.
+class TaskQueue
+{
+  public:
+
+    /// @brief Adds a task at the back of the queue.
+    /// @param index Index of the task.
+    void push(std::size_t index);
+
+    /// @brief Takes the task at the front of the queue.
+    /// @param index Index of the task taken, if any.
+    /// @return @e true if a task was taken and @e false if the queue is empty.
+    bool popFront(std::size_t& index);
+
+    /// @brief Takes the task at the back of the queue.
+    /// @param index Index of the task taken, if any.
+    /// @return @e true if a task was taken and @e false if the queue is empty.
+    bool popBack(std::size_t& index);
+
+  private:
+
+    /// Mutex that guards the tasks.
+    std::mutex _mutex;
+
+    /// Indices of the pending tasks.
+    std::deque<std::size_t> _tasks;
+};
+
+/// @brief Threads kept between the calls to Parallel::forEach, which hand jobs to them.
+/// @details A job is run by the calling thread and by the workers that claim it, each one with
+///   its own thread index. The workers busy with other jobs might not claim it, in which case
+///   the threads that did run all its tasks. The pool grows up to the largest number of workers
+///   requested, and its threads are joined at exit.
+class ThreadPool
+{
+  public:
+
+    /// @brief Job run by several threads.
+    struct Job
+    {
+      /// Function run by every thread, called with the context and the index of the thread.
+      void (*run)(const void* context, std::size_t thread);
+
+      /// Context of the function.
+      const void* context;
+
+      /// Number of threads that can run the job, the calling one included.
+      std::size_t threadCount;
+
+      /// Index of the next thread that claims the job.
+      std::size_t nextThread{1};
+
+      /// Number of workers running the job.
+      std::size_t runningCount{0};
+    };
+
+    /// @brief Gets the pool of the process, creating it on the first call.
+    /// @return Thread pool.
+    static ThreadPool& getInstance();
+
+    /// @brief Checks whether the calling thread is running a job, as a worker of the pool or as
+    ///   the thread that submitted it.
+    /// @return @e true if it is running a job and @e false otherwise.
+    static bool isRunningJob();
+
+    /// @brief Destructor. Stops and joins the workers.
+    ~ThreadPool();
+
+    /// @brief Runs a job in the calling thread, as thread 0, and in the workers that claim it.
+    /// @details Once the calling thread finishes, the job cannot be claimed anymore, so the
+    ///   function run must only return in it when there are no tasks left for any thread.
+    ///   Returns when all the workers that claimed the job have finished too.
+    /// @param job Job to be run. It must not throw.
+    void run(Job& job);
+
+  private:
+
+    /// @brief Runs the jobs claimed by a worker until the pool is stopped.
+    void work();
+
+    /// Mutex that guards the jobs and the workers.
+    std::mutex _mutex;
+
+    /// Signaled when a job is added or the pool is stopped.
+    std::condition_variable _jobAdded;
+
+    /// Signaled when a worker finishes its part of a job.
+    std::condition_variable _jobFinished;
+
+    /// Jobs with threads not claimed yet, in submission order.
+    std::vector<Job*> _jobs;
+
+    /// Worker threads.
+    std::vector<std::thread> _workers;
+
+    /// Whether the workers must stop.
+    bool _isStopping{false};
+};
+
+/// Whether the current thread is running a job: always in the workers of the pool, and while
+/// running its share of a job in the calling threads.
+thread_local bool is_running_job{false};
+
+/// @brief Gets the number of threads used to run some tasks.
+/// @param threadCount Requested number of threads. Zero means one per hardware thread.
+/// @param taskCount Number of tasks.
+/// @return Number of threads: one in a thread already running a job, and otherwise the requested
+///   one, limited to the number of tasks.
+std::size_t get_thread_count(unsigned int threadCount, std::size_t taskCount);
+
+template <typename NextTask>
+void run_tasks(std::size_t threadCount, NextTask nextTask,
+    const std::function<void(std::size_t)>& task);
+
+} // anonymous namespace
+
+void Parallel::forEach(std::size_t taskCount, unsigned int threadCount,
+    const std::function<void(std::size_t)>& task)
+{
+  const auto thread_count = get_thread_count(threadCount, taskCount);
+
+  std::atomic<std::size_t> next_index{0};
+  run_tasks(thread_count, [&next_index, taskCount](std::size_t, std::size_t& index)
+  {
+    index = next_index++;
+    return index < taskCount;
+  }, task);
+}
+
+void Parallel::forEach(const std::vector<double>& costs, unsigned int threadCount,
+    const std::function<void(std::size_t)>& task)
+{
+  const auto task_count = costs.size();
+  const auto thread_count = get_thread_count(threadCount, task_count);
+
+  // Most expensive first, the ties keep the index order.
+  std::vector<std::size_t> order(task_count);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&costs](std::size_t lhs, std::size_t rhs)
+  {
+    return costs[lhs] > costs[rhs];
+  });
+
+  // Deal every task to the least loaded thread, so the initial split is already balanced.
+  std::vector<TaskQueue> queues(std::max<std::size_t>(thread_count, 1));
+  std::vector<double> loads(queues.size(), 0.0);
+  for (const auto index : order)
+  {
+    const auto thread = static_cast<std::size_t>(
+        std::min_element(loads.begin(), loads.end()) - loads.begin());
+    queues[thread].push(index);
+    loads[thread] += std::max(costs[index], 0.0);
+  }
+
+  run_tasks(thread_count, [&queues](std::size_t thread, std::size_t& index)
+  {
+    if (queues[thread].popFront(index))
+    {
+      return true;
+    }
+
+    // No tasks are added once started, so if every queue is empty there is nothing left.
+    for (std::size_t offset = 1; offset < queues.size(); ++offset)
+    {
+      if (queues[(thread + offset) % queues.size()].popBack(index))
+      {
+        return true;
+      }
+    }
+    return false;
+  }, task);
+}
+
+unsigned int Parallel::resolveThreadCount(unsigned int threadCount)
+{
+  if (threadCount > 0)
+  {
+    return threadCount;
+  }
+
+  // hardware_concurrency might return zero if it is not computable.
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+namespace
+{
+
+void TaskQueue::push(std::size_t index)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  _tasks.push_back(index);
+}
+
+bool TaskQueue::popFront(std::size_t& index)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_tasks.empty())
+  {
+    return false;
+  }
+
+  index = _tasks.front();
+  _tasks.pop_front();
+  return true;
+}
+
+bool TaskQueue::popBack(std::size_t& index)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_tasks.empty())
+  {
+    return false;
+  }
+
+  index = _tasks.back();
+  _tasks.pop_back();
+  return true;
+}
+
+ThreadPool& ThreadPool::getInstance()
+{
+  static ThreadPool pool;
+  return pool;
+}
+
+bool ThreadPool::isRunningJob()
+{
+  return is_running_job;
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _isStopping = true;
+  }
+  _jobAdded.notify_all();
+
+  for (auto& worker : _workers)
+  {
+    worker.join();
+  }
+}
+
+void ThreadPool::run(Job& job)
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    while (_workers.size() + 1 < job.threadCount)
+    {
+      _workers.emplace_back(&ThreadPool::work, this);
+    }
+    _jobs.push_back(&job);
+  }
+  for (std::size_t thread = 1; thread < job.threadCount; ++thread)
+  {
+    _jobAdded.notify_one();
+  }
+
+  is_running_job = true;
+  job.run(job.context, 0);
+  is_running_job = false;
+
+  // The threads not claimed yet would find no tasks left, so they are not waited for.
+  std::unique_lock<std::mutex> lock(_mutex);
+  const auto position = std::find(_jobs.begin(), _jobs.end(), &job);
+  if (position != _jobs.end())
+  {
+    _jobs.erase(position);
+  }
+  _jobFinished.wait(lock, [&job]() { return job.runningCount == 0; });
+}
+
+void ThreadPool::work()
+{
+  is_running_job = true;
+
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true)
+  {
+    _jobAdded.wait(lock, [this]() { return _isStopping || !_jobs.empty(); });
+    if (_isStopping)
+    {
+      return;
+    }
+
+    auto& job = *_jobs.front();
+    const auto thread = job.nextThread++;
+    if (job.nextThread == job.threadCount)
+    {
+      _jobs.erase(_jobs.begin());
+    }
+    ++job.runningCount;
+
+    lock.unlock();
+    job.run(job.context, thread);
+    lock.lock();
+
+    if (--job.runningCount == 0)
+    {
+      _jobFinished.notify_all();
+    }
+  }
+}
+
+std::size_t get_thread_count(unsigned int threadCount, std::size_t taskCount)
+{
+  // The nested calls run inline, so they do not multiply the number of running threads.
+  if (ThreadPool::isRunningJob())
+  {
+    return 1;
+  }
+
+  return std::min<std::size_t>(Parallel::resolveThreadCount(threadCount), taskCount);
+}
+
+/// @brief Runs the tasks in a given number of threads, the calling one included.
+/// @details The threads other than the calling one are taken from the ThreadPool.
+/// @param threadCount Number of threads.
+/// @param nextTask Function that gets the index of the next task for a thread. It is called
+///   with the index of the thread and the index of the task to be set, and returns @e false
+///   once there are no tasks left for the thread. Thread 0 must only run out of tasks when
+///   all the threads have.
+/// @param task Function called with the index of each task.
+template <typename NextTask>
+void run_tasks(std::size_t threadCount, NextTask nextTask,
+    const std::function<void(std::size_t)>& task)
+{
+  if (threadCount <= 1)
+  {
+    std::size_t index = 0;
+    while (nextTask(0, index))
+    {
+      task(index);
+    }
+    return;
+  }
+
+  std::atomic<bool> failed{false};
+  std::exception_ptr exception;
+  std::mutex exception_mutex;
+
+  const auto run_thread = [&](std::size_t thread)
+  {
+    std::size_t index = 0;
+    while (!failed && nextTask(thread, index))
+    {
+      try
+      {
+        task(index);
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(exception_mutex);
+        if (!exception)
+        {
+          exception = std::current_exception();
+        }
+        failed = true;
+      }
+    }
+  };
+
+  // Passed as a plain function and context, so submitting the job does not allocate.
+  ThreadPool::Job job{[](const void* context, std::size_t thread)
+  {
+    (*static_cast<decltype(&run_thread)>(context))(thread);
+  }, &run_thread, threadCount};
+  ThreadPool::getInstance().run(job);
+
+  if (exception)
+  {
+    std::rethrow_exception(exception);
+  }
+}
+
+} // anonymous namespace
+
+} // namespace fictionalfiesta
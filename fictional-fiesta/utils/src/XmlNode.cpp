@@ -4,8 +4,10 @@
 
 #include "fictional-fiesta/utils/itf/Exception.h"
 
-#include "fictional-fiesta/utils/src/PimplImpl.h"
+#include "fictional-fiesta/utils/src/InplacePimplImpl.h"
 #include "fictional-fiesta/utils/src/XmlNodeImpl.h"
+#include "fictional-fiesta/utils/src/XmlStreamWriterImpl.h"
+#include "fictional-fiesta/utils/src/XmlValueParser.h"
 
 namespace fictionalfiesta
 {
@@ -15,23 +17,23 @@ namespace
 
 pugi::xml_text get_mandatory_text(const pugi::xml_node& node);
 
-template <typename T>
-T text_to(const pugi::xml_text& text);
-
 pugi::xml_attribute get_mandatory_attribute(const pugi::xml_node& node,
     const std::string& name);
 
-template <typename T>
-T attribute_to(const pugi::xml_attribute& attribute);
-
 } // anonymous namespace
 
 XmlNode::XmlNode(const XmlNodeImpl& node):
-  _pimpl(node._node)
+  _pimpl(node)
 {
 }
 
-XmlNode::XmlNode(XmlNode&&) = default;
+XmlNode::XmlNode(const XmlNode&) = default;
+
+XmlNode::XmlNode(XmlNode&&) noexcept = default;
+
+XmlNode& XmlNode::operator=(const XmlNode&) = default;
+
+XmlNode& XmlNode::operator=(XmlNode&&) noexcept = default;
 
 XmlNode::~XmlNode() = default;
 
@@ -71,7 +73,7 @@ template unsigned long long XmlNode::getAttributeAs(const std::string& name) con
 template <typename T>
 T XmlNode::getAttributeAs(const std::string& name) const
 {
-  return attribute_to<T>(get_mandatory_attribute(_pimpl->_node, name));
+  return XmlValueParser::parse<T>(get_mandatory_attribute(_pimpl->_node, name).value());
 }
 
 std::string XmlNode::getOptionalAttribute(const std::string& name,
@@ -110,7 +112,7 @@ T XmlNode::getOptionalAttributeAs(const std::string& name, const T& defaultValue
     return defaultValue;
   }
 
-  return attribute_to<T>(attribute);
+  return XmlValueParser::parse<T>(attribute.value());
 }
 
 bool XmlNode::hasChildNode() const
@@ -225,7 +227,7 @@ template unsigned long long XmlNode::getTextAs() const;
 template <typename T>
 T XmlNode::getTextAs() const
 {
-  return text_to<T>(get_mandatory_text(_pimpl->_node));
+  return XmlValueParser::parse<T>(get_mandatory_text(_pimpl->_node).get());
 }
 
 template int XmlNode::getChildNodeTextAs() const;
@@ -261,7 +263,7 @@ T XmlNode::getOptionalTextAs(const T& defaultValue) const
     return defaultValue;
   }
 
-  return text_to<T>(text);
+  return XmlValueParser::parse<T>(text.get());
 }
 
 /// @cond
@@ -336,6 +338,12 @@ T XmlNode::getOptionalChildNodeTextAs(const std::string& name, const T& defaultV
 
 void XmlNode::setAttribute(const std::string& name, const std::string& value)
 {
+  if (_pimpl->_writer)
+  {
+    _pimpl->_writer->setAttribute(*_pimpl, name, value);
+    return;
+  }
+
   auto attribute = _pimpl->_node.attribute(name.c_str());
   if (!attribute)
   {
@@ -346,6 +354,11 @@ void XmlNode::setAttribute(const std::string& name, const std::string& value)
 
 XmlNode XmlNode::appendChildNode(const std::string& name)
 {
+  if (_pimpl->_writer)
+  {
+    return XmlNode(_pimpl->_writer->appendChildNode(*_pimpl, name));
+  }
+
   auto child = _pimpl->_node.append_child();
   child.set_name(name.c_str());
   return XmlNode(child);
@@ -353,6 +366,12 @@ XmlNode XmlNode::appendChildNode(const std::string& name)
 
 void XmlNode::setNodeText(const std::string& text)
 {
+  if (_pimpl->_writer)
+  {
+    _pimpl->_writer->setText(*_pimpl, text);
+    return;
+  }
+
   auto child = _pimpl->_node.first_child();
 
   if (child)
@@ -379,49 +398,6 @@ pugi::xml_text get_mandatory_text(const pugi::xml_node& node)
   return text;
 }
 
-// @todo Substitute all these method template specializations with std::from_chars when available.
-template <>
-int text_to(const pugi::xml_text& text)
-{
-  return text.as_int();
-}
-
-template <>
-unsigned int text_to(const pugi::xml_text& text)
-{
-  return text.as_uint();
-}
-
-template <>
-double text_to(const pugi::xml_text& text)
-{
-  return text.as_double();
-}
-
-template <>
-float text_to(const pugi::xml_text& text)
-{
-  return text.as_float();
-}
-
-template <>
-bool text_to(const pugi::xml_text& text)
-{
-  return text.as_bool();
-}
-
-template <>
-long long text_to(const pugi::xml_text& text)
-{
-  return text.as_llong();
-}
-
-template <>
-unsigned long long text_to(const pugi::xml_text& text)
-{
-  return text.as_ullong();
-}
-
 pugi::xml_attribute get_mandatory_attribute(const pugi::xml_node& node, const std::string& name)
 {
   const auto& attribute = node.attribute(name.c_str());
@@ -434,49 +410,6 @@ pugi::xml_attribute get_mandatory_attribute(const pugi::xml_node& node, const st
   return attribute;
 }
 
-// @todo Substitute all these method template specializations with std::from_chars when available.
-template <>
-int attribute_to(const pugi::xml_attribute& text)
-{
-  return text.as_int();
-}
-
-template <>
-unsigned int attribute_to(const pugi::xml_attribute& text)
-{
-  return text.as_uint();
-}
-
-template <>
-double attribute_to(const pugi::xml_attribute& text)
-{
-  return text.as_double();
-}
-
-template <>
-float attribute_to(const pugi::xml_attribute& text)
-{
-  return text.as_float();
-}
-
-template <>
-bool attribute_to(const pugi::xml_attribute& text)
-{
-  return text.as_bool();
-}
-
-template <>
-long long attribute_to(const pugi::xml_attribute& text)
-{
-  return text.as_llong();
-}
-
-template <>
-unsigned long long attribute_to(const pugi::xml_attribute& text)
-{
-  return text.as_ullong();
-}
-
 } // anonymous namespace.
 
 } // namespace fictionalfiesta
@@ -10,4 +10,11 @@ XmlNodeImpl::XmlNodeImpl(const pugi::xml_node& node) :
 {
 }
 
+XmlNodeImpl::XmlNodeImpl(XmlStreamWriterImpl& writer, std::size_t depth, std::uint64_t id) :
+  _writer(&writer),
+  _depth(depth),
+  _id(id)
+{
+}
+
 } // namespace fictionalfiesta
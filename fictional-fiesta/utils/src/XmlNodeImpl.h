@@ -5,10 +5,16 @@
 
 #include <pugixml.hpp>
 
+#include <cstddef>
+#include <cstdint>
+
 namespace fictionalfiesta
 {
 
+class XmlStreamWriterImpl;
+
 /// @brief Implementation of the XmlNode class.
+/// @details A node is either in a pugi document or written by a XmlStreamWriter.
 class XmlNodeImpl
 {
   public:
@@ -16,8 +22,23 @@ class XmlNodeImpl
     /// @param node pugi xml_node
     XmlNodeImpl(const pugi::xml_node& node);
 
-    /// Internal XML document from pugi.
+    /// @brief Constructor of a node written by a XmlStreamWriter.
+    /// @param writer Writer of the node.
+    /// @param depth Depth of the node in the document (zero for the root).
+    /// @param id Identifier of the node in the document.
+    XmlNodeImpl(XmlStreamWriterImpl& writer, std::size_t depth, std::uint64_t id);
+
+    /// Internal XML document from pugi. Empty for the nodes written by a XmlStreamWriter.
     pugi::xml_node _node;
+
+    /// Writer of the node, or null if the node is in a pugi document.
+    XmlStreamWriterImpl* _writer{nullptr};
+
+    /// Depth of the node in the document written by _writer.
+    std::size_t _depth{0};
+
+    /// Identifier of the node in the document written by _writer.
+    std::uint64_t _id{0};
 };
 
 }
@@ -1,9 +1,14 @@
 /// @file XmlSavable.cpp Implementation of the XmlSavable interface.
 
-#include "fictional-fiesta/utils/itf/XmlDocument.h"
-#include "fictional-fiesta/utils/itf/XmlNode.h"
 #include "fictional-fiesta/utils/itf/XmlSavable.h"
 
+#include "fictional-fiesta/utils/itf/Exception.h"
+#include "fictional-fiesta/utils/itf/XmlNode.h"
+#include "fictional-fiesta/utils/itf/XmlStreamWriter.h"
+
+#include <fstream>
+#include <sstream>
+
 namespace fictionalfiesta
 {
 
@@ -14,18 +19,22 @@ void XmlSavable::save(XmlNode node) const
 
 void XmlSavable::save(const std::experimental::filesystem::path& filePath) const
 {
-  auto result_document = XmlDocument{};
-  auto node = result_document.appendRootNode(getDefaultXmlName());
-  doSave(node);
-  result_document.save(filePath);
+  std::ofstream stream(filePath, std::ios::binary | std::ios::trunc);
+  if (!stream)
+  {
+    throw Exception("Error saving XML to '" + filePath.string() + "'.");
+  }
+
+  save(stream);
 }
 
 void XmlSavable::save(std::ostream& stream) const
 {
-  auto result_document = XmlDocument{};
-  auto node = result_document.appendRootNode(getDefaultXmlName());
+  // Streamed, so the document is never held in memory.
+  XmlStreamWriter writer{stream};
+  auto node = writer.appendRootNode(getDefaultXmlName());
   doSave(node);
-  result_document.save(stream);
+  writer.finish();
 }
 
 std::string XmlSavable::saveXmlToString() const
@@ -0,0 +1,873 @@
+/// @file XmlStreamReader.cpp Implementation of the XmlStreamReader class.
+
+#include "fictional-fiesta/utils/itf/XmlStreamReader.h"
+
+#include "fictional-fiesta/utils/itf/XmlNode.h"
+
+#include "fictional-fiesta/utils/src/XmlValueParser.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+
+namespace fictionalfiesta
+{
+
+namespace
+{
+
+/// Size of the blocks read from the stream.
+constexpr std::size_t BUFFER_SIZE{1 << 20};
+
+bool is_white_space(int character);
+
+bool is_white_space(const std::string& text);
+
+bool is_name_character(char character);
+
+bool is_xml_character(std::uint32_t codePoint);
+
+void append_utf8(std::uint32_t codePoint, std::string& output);
+
+} // anonymous namespace
+
+XmlStreamReader::XmlStreamReader(const std::experimental::filesystem::path& filePath):
+  _filePath(filePath),
+  _file(filePath, std::ios::binary),
+  _stream(_file),
+  _buffer(BUFFER_SIZE)
+{
+  if (!_file)
+  {
+    throw Exception("Error loading XML file '" + filePath.string() + "': cannot be opened.");
+  }
+
+  readRootElement();
+}
+
+XmlStreamReader::XmlStreamReader(const std::experimental::filesystem::path& filePath,
+    std::uint64_t begin, std::uint64_t end):
+  _filePath(filePath),
+  _file(filePath, std::ios::binary),
+  _stream(_file),
+  _buffer(static_cast<std::size_t>(std::min<std::uint64_t>(BUFFER_SIZE, end - begin))),
+  _bufferOffset(begin),
+  _remaining(end - begin)
+{
+  if (!_file || !_file.seekg(static_cast<std::streamoff>(begin)))
+  {
+    throw Exception("Error loading XML file '" + filePath.string() + "': cannot be opened.");
+  }
+
+  readRootElement();
+}
+
+XmlStreamReader::XmlStreamReader(std::istream& stream):
+  _stream(stream),
+  _buffer(BUFFER_SIZE)
+{
+  readRootElement();
+}
+
+const std::experimental::filesystem::path& XmlStreamReader::getFilePath() const
+{
+  return _filePath;
+}
+
+std::uint64_t XmlStreamReader::getElementOffset() const
+{
+  return _elementOffset;
+}
+
+const std::string& XmlStreamReader::getName() const
+{
+  return _name;
+}
+
+std::size_t XmlStreamReader::getDepth() const
+{
+  if (_openCount == 0)
+  {
+    throw Exception("The root node '" + _name + "' is already closed.");
+  }
+
+  // Self-closing elements stay open until their end is read.
+  return _openCount - 1;
+}
+
+bool XmlStreamReader::hasAttribute(const std::string& attributeName) const
+{
+  return std::any_of(_attributes.begin(), _attributes.end(),
+      [&attributeName](const auto& attribute) { return attribute.first == attributeName; });
+}
+
+std::string XmlStreamReader::getAttribute(const std::string& attributeName) const
+{
+  for (const auto& attribute : _attributes)
+  {
+    if (attribute.first == attributeName)
+    {
+      return attribute.second;
+    }
+  }
+
+  throw Exception("The current node '" + _name + "' has no '" + attributeName + "' attribute.");
+}
+
+/// @cond
+// Same types as the ones of XmlNode.
+template int XmlStreamReader::getAttributeAs(const std::string& name) const;
+template unsigned int XmlStreamReader::getAttributeAs(const std::string& name) const;
+template double XmlStreamReader::getAttributeAs(const std::string& name) const;
+template float XmlStreamReader::getAttributeAs(const std::string& name) const;
+template bool XmlStreamReader::getAttributeAs(const std::string& name) const;
+template long long XmlStreamReader::getAttributeAs(const std::string& name) const;
+template unsigned long long XmlStreamReader::getAttributeAs(const std::string& name) const;
+/// @endcond
+
+template <typename T>
+T XmlStreamReader::getAttributeAs(const std::string& attributeName) const
+{
+  return XmlValueParser::parse<T>(getAttribute(attributeName));
+}
+
+/// @cond
+template int XmlStreamReader::getOptionalAttributeAs(const std::string& name,
+    const int& defaultValue) const;
+template unsigned int XmlStreamReader::getOptionalAttributeAs(const std::string& name,
+    const unsigned int& defaultValue) const;
+template double XmlStreamReader::getOptionalAttributeAs(const std::string& name,
+    const double& defaultValue) const;
+template float XmlStreamReader::getOptionalAttributeAs(const std::string& name,
+    const float& defaultValue) const;
+template bool XmlStreamReader::getOptionalAttributeAs(const std::string& name,
+    const bool& defaultValue) const;
+template long long XmlStreamReader::getOptionalAttributeAs(const std::string& name,
+    const long long& defaultValue) const;
+template unsigned long long XmlStreamReader::getOptionalAttributeAs(const std::string& name,
+    const unsigned long long& defaultValue) const;
+/// @endcond
+
+template <typename T>
+T XmlStreamReader::getOptionalAttributeAs(const std::string& attributeName,
+    const T& defaultValue) const
+{
+  if (!hasAttribute(attributeName))
+  {
+    return defaultValue;
+  }
+
+  return XmlValueParser::parse<T>(getAttribute(attributeName));
+}
+
+void XmlStreamReader::checkMandatory(bool isFound, const std::string& elementName,
+    const std::string& childName)
+{
+  if (!isFound)
+  {
+    throw Exception("The current node '" + elementName + "' has no children with the name '" +
+        childName + "'.");
+  }
+}
+
+bool XmlStreamReader::nextChildElement(std::size_t depth)
+{
+  // The parent element has already been closed.
+  if (_openCount <= depth)
+  {
+    return false;
+  }
+
+  while (true)
+  {
+    // Only the tags are needed to find the child.
+    const auto token = readToken(false);
+    if (token == Token::StartTag && _openCount == depth + 2)
+    {
+      return true;
+    }
+    if (token == Token::EndTag && _openCount == depth)
+    {
+      return false;
+    }
+  }
+}
+
+bool XmlStreamReader::nextElement()
+{
+  while (true)
+  {
+    const auto token = readToken(false);
+    if (token == Token::StartTag && _openCount == 1)
+    {
+      return true;
+    }
+    if (token == Token::End)
+    {
+      return false;
+    }
+  }
+}
+
+std::uint64_t XmlStreamReader::skipElement()
+{
+  if (_hasReadContents)
+  {
+    throw Exception("The node '" + _name + "' must be skipped before reading its children.");
+  }
+
+  if (_isEndPending)
+  {
+    readToken();
+    return getOffset();
+  }
+
+  // Only the depth is tracked, as the tags are not checked when the element is skipped.
+  std::size_t depth = 1;
+  while (depth > 0)
+  {
+    skipCharacterData();
+    if (get() != '<')
+    {
+      throwMalformed("Unexpected end of the document, the node '" + _name + "' is not closed.");
+    }
+
+    switch (peek())
+    {
+      case '/':
+        skipTag();
+        --depth;
+        break;
+      case '?':
+        skipPast("?>");
+        break;
+      case '!':
+        get();
+        if (peek() == '[')
+        {
+          skipPast("]]>");
+        }
+        else
+        {
+          skipDeclaration();
+        }
+        break;
+      default:
+        if (!skipTag())
+        {
+          ++depth;
+        }
+    }
+  }
+
+  --_openCount;
+  return getOffset();
+}
+
+std::string XmlStreamReader::getText()
+{
+  if (_hasReadContents)
+  {
+    throw Exception("The text of the node '" + _name + "' must be read before its children.");
+  }
+
+  const auto name = _name;
+  const auto open_count = _openCount;
+  std::optional<std::string> text;
+  while (true)
+  {
+    const auto token = readToken();
+    if (token == Token::Text && _openCount == open_count && !text)
+    {
+      text = _text;
+    }
+    if (token == Token::EndTag && _openCount == open_count - 1)
+    {
+      break;
+    }
+  }
+
+  if (!text)
+  {
+    throw Exception("The current node '" + name + "' has no text content.");
+  }
+
+  return *text;
+}
+
+/// @cond
+template int XmlStreamReader::getTextAs();
+template unsigned int XmlStreamReader::getTextAs();
+template double XmlStreamReader::getTextAs();
+template float XmlStreamReader::getTextAs();
+template bool XmlStreamReader::getTextAs();
+template long long XmlStreamReader::getTextAs();
+template unsigned long long XmlStreamReader::getTextAs();
+/// @endcond
+
+template <typename T>
+T XmlStreamReader::getTextAs()
+{
+  return XmlValueParser::parse<T>(getText());
+}
+
+void XmlStreamReader::readInto(XmlNode node)
+{
+  if (_hasReadContents)
+  {
+    throw Exception("The node '" + _name + "' must be read before its children.");
+  }
+
+  for (const auto& attribute : _attributes)
+  {
+    node.setAttribute(attribute.first, attribute.second);
+  }
+
+  // Nodes being filled, and whether they already have contents (only the first text is kept).
+  std::vector<XmlNode> nodes;
+  std::vector<bool> have_contents{false};
+  nodes.push_back(std::move(node));
+
+  const auto open_count = _openCount;
+  while (_openCount >= open_count)
+  {
+    switch (readToken())
+    {
+      case Token::StartTag:
+      {
+        auto child = nodes.back().appendChildNode(_name);
+        for (const auto& attribute : _attributes)
+        {
+          child.setAttribute(attribute.first, attribute.second);
+        }
+        have_contents.back() = true;
+        nodes.push_back(std::move(child));
+        have_contents.push_back(false);
+        break;
+      }
+      case Token::Text:
+        if (!have_contents.back())
+        {
+          nodes.back().setText(_text);
+          have_contents.back() = true;
+        }
+        break;
+      case Token::EndTag:
+        nodes.pop_back();
+        have_contents.pop_back();
+        break;
+      case Token::End:
+        break;
+    }
+  }
+}
+
+void XmlStreamReader::readRootElement()
+{
+  while (true)
+  {
+    const auto token = readToken();
+    if (token == Token::StartTag)
+    {
+      return;
+    }
+    if (token == Token::End)
+    {
+      throwMalformed("No root element.");
+    }
+  }
+}
+
+XmlStreamReader::Token XmlStreamReader::readToken(bool isTextNeeded)
+{
+  _hasReadContents = true;
+
+  if (_isEndPending)
+  {
+    _isEndPending = false;
+    --_openCount;
+    return Token::EndTag;
+  }
+
+  while (true)
+  {
+    const auto next = peek();
+    if (next == std::char_traits<char>::eof())
+    {
+      if (_openCount != 0)
+      {
+        throwMalformed("Unexpected end of the document, the node '" +
+            _openElements[_openCount - 1] + "' is not closed.");
+      }
+      return Token::End;
+    }
+
+    if (next != '<')
+    {
+      if (!isTextNeeded)
+      {
+        skipCharacterData();
+        continue;
+      }
+
+      readCharacterData();
+      // As XmlDocument, the texts with only white spaces are dropped.
+      if (_openCount == 0 || is_white_space(_text))
+      {
+        continue;
+      }
+      return Token::Text;
+    }
+
+    const auto tag_offset = getOffset();
+    get();
+    switch (peek())
+    {
+      case '/':
+        get();
+        readEndTag();
+        return Token::EndTag;
+      case '?':
+        skipPast("?>");
+        break;
+      case '!':
+        get();
+        if (peek() == '[')
+        {
+          skipPast("CDATA[");
+          _text.clear();
+          skipPast("]]>", &_text);
+          if (_openCount != 0)
+          {
+            return Token::Text;
+          }
+        }
+        else
+        {
+          skipDeclaration();
+        }
+        break;
+      default:
+        _elementOffset = tag_offset;
+        readStartTag();
+        return Token::StartTag;
+    }
+  }
+}
+
+void XmlStreamReader::readStartTag()
+{
+  readName(_name);
+  _attributes.clear();
+  while (true)
+  {
+    skipWhiteSpaces();
+    const auto next = peek();
+    if (next == '>')
+    {
+      get();
+      break;
+    }
+    if (next == '/')
+    {
+      get();
+      if (get() != '>')
+      {
+        throwMalformed("Bad start tag of the node '" + _name + "'.");
+      }
+      _isEndPending = true;
+      break;
+    }
+
+    std::string attribute_name;
+    readName(attribute_name);
+    skipWhiteSpaces();
+    if (get() != '=')
+    {
+      throwMalformed("Bad attribute '" + attribute_name + "' of the node '" + _name + "'.");
+    }
+    skipWhiteSpaces();
+    _attributes.emplace_back(std::move(attribute_name), readAttributeValue());
+  }
+
+  // The strings of the closed elements are reused, to save allocations.
+  if (_openCount == _openElements.size())
+  {
+    _openElements.emplace_back();
+  }
+  _openElements[_openCount++].assign(_name);
+  _hasReadContents = false;
+}
+
+void XmlStreamReader::readEndTag()
+{
+  readName(_endTagName);
+  skipWhiteSpaces();
+  if (get() != '>' || _openCount == 0 || _openElements[_openCount - 1] != _endTagName)
+  {
+    throwMalformed("Unexpected end tag of the node '" + _endTagName + "'.");
+  }
+  --_openCount;
+}
+
+bool XmlStreamReader::skipTag()
+{
+  // Most tags have no attributes, and they are found in the buffer at once.
+  if (_position < _size)
+  {
+    const auto begin = _buffer.data() + _position;
+    const auto remaining = _size - _position;
+    const auto end = static_cast<const char*>(std::memchr(begin, '>', remaining));
+    if (end && end != begin && !std::memchr(begin, '"', static_cast<std::size_t>(end - begin)) &&
+        !std::memchr(begin, '\'', static_cast<std::size_t>(end - begin)))
+    {
+      _position += static_cast<std::size_t>(end - begin) + 1;
+      return *(end - 1) == '/';
+    }
+  }
+
+  char previous = '\0';
+  for (auto character = get(); character != '>'; character = get())
+  {
+    if (character == '"' || character == '\'')
+    {
+      // The attribute values may have any character but the quote.
+      while (get() != character)
+      {
+      }
+    }
+    previous = character;
+  }
+
+  return previous == '/';
+}
+
+void XmlStreamReader::skipDeclaration()
+{
+  if (peek() == '-')
+  {
+    skipPast("--");
+    skipPast("-->");
+    return;
+  }
+
+  // Declarations (DOCTYPE), with the brackets of an internal subset.
+  int bracket_depth = 0;
+  for (char character = get(); character != '>' || bracket_depth > 0; character = get())
+  {
+    bracket_depth += (character == '[') - (character == ']');
+  }
+}
+
+void XmlStreamReader::readCharacterData()
+{
+  _text.clear();
+  for (auto next = peek(); next != std::char_traits<char>::eof() && next != '<'; next = peek())
+  {
+    const auto character = get();
+    if (character == '&')
+    {
+      readEntity(_text, '<');
+    }
+    else if (character == '\r')
+    {
+      // The line ends are normalized to '\n'.
+      if (peek() != '\n')
+      {
+        _text += '\n';
+      }
+    }
+    else
+    {
+      _text += character;
+    }
+  }
+}
+
+void XmlStreamReader::skipCharacterData()
+{
+  while (peek() != std::char_traits<char>::eof())
+  {
+    const auto begin = _buffer.data() + _position;
+    const auto tag = static_cast<const char*>(std::memchr(begin, '<', _size - _position));
+    if (tag)
+    {
+      _position += static_cast<std::size_t>(tag - begin);
+      return;
+    }
+    _position = _size;
+  }
+}
+
+void XmlStreamReader::readName(std::string& name)
+{
+  // The name is appended by blocks of the buffer, as it is read for every tag.
+  name.clear();
+  while (_position < _size || fill())
+  {
+    const auto begin = _position;
+    while (_position < _size && is_name_character(_buffer[_position]))
+    {
+      ++_position;
+    }
+    name.append(_buffer.data() + begin, _position - begin);
+
+    if (_position < _size)
+    {
+      break;
+    }
+  }
+
+  if (name.empty())
+  {
+    throwMalformed("Expected a name.");
+  }
+}
+
+std::string XmlStreamReader::readAttributeValue()
+{
+  const auto quote = get();
+  if (quote != '"' && quote != '\'')
+  {
+    throwMalformed("Expected a quoted attribute value.");
+  }
+
+  std::string value;
+  for (auto character = get(); character != quote; character = get())
+  {
+    if (character == '&')
+    {
+      readEntity(value, quote);
+    }
+    else if (is_white_space(character))
+    {
+      // A line end is a single space.
+      if (character == '\r' && peek() == '\n')
+      {
+        get();
+      }
+      value += ' ';
+    }
+    else
+    {
+      value += character;
+    }
+  }
+  return value;
+}
+
+void XmlStreamReader::readEntity(std::string& output, char terminator)
+{
+  // The longest named entity is 'quot' and the longest character reference '#x10FFFF', without
+  // counting its leading zeros, as any number of them is allowed.
+  constexpr std::size_t MAX_NAME_SIZE{4};
+  constexpr std::size_t MAX_REFERENCE_SIZE{8};
+  std::string entity;
+  std::size_t leading_zeros{0};
+  for (auto next = peek(); next != ';' && next != '&' && next != '<' && next != terminator &&
+      next != std::char_traits<char>::eof(); next = peek())
+  {
+    const auto is_reference = !entity.empty() && entity[0] == '#';
+    const auto size = entity.size() - leading_zeros;
+    if (size >= (is_reference ? MAX_REFERENCE_SIZE : MAX_NAME_SIZE))
+    {
+      break;
+    }
+
+    const std::size_t prefix_size = (entity.size() > 1 && entity[1] == 'x') ? 2 : 1;
+    if (is_reference && next == '0' && size == prefix_size)
+    {
+      ++leading_zeros;
+    }
+    entity += get();
+  }
+
+  if (peek() != ';')
+  {
+    // Not an entity, so it is left as is.
+    output += '&';
+    output += entity;
+    return;
+  }
+  get();
+
+  if (entity == "lt")
+  {
+    output += '<';
+  }
+  else if (entity == "gt")
+  {
+    output += '>';
+  }
+  else if (entity == "amp")
+  {
+    output += '&';
+  }
+  else if (entity == "quot")
+  {
+    output += '"';
+  }
+  else if (entity == "apos")
+  {
+    output += '\'';
+  }
+  else if (!entity.empty() && entity[0] == '#')
+  {
+    const auto is_hexadecimal = entity.size() > 1 && entity[1] == 'x';
+    const auto digits = std::string_view{entity}.substr(is_hexadecimal ? 2 : 1);
+    std::uint32_t code_point{0};
+    const auto end = digits.data() + digits.size();
+    const auto result = std::from_chars(digits.data(), end, code_point, is_hexadecimal ? 16 : 10);
+    if (result.ec != std::errc{} || result.ptr != end || !is_xml_character(code_point))
+    {
+      throwMalformed("Invalid character reference '&" + entity + ";'.");
+    }
+    append_utf8(code_point, output);
+  }
+  else
+  {
+    output += '&';
+    output += entity;
+    output += ';';
+  }
+}
+
+void XmlStreamReader::skipPast(const std::string& terminator, std::string* output)
+{
+  // Without output, only the last characters are kept, to find the terminator.
+  std::string window;
+  auto& skipped = output ? *output : window;
+  const auto start = skipped.size();
+  while (skipped.size() - start < terminator.size() ||
+      skipped.compare(skipped.size() - terminator.size(), terminator.size(), terminator) != 0)
+  {
+    auto character = get();
+    // The line ends are normalized in the CDATA sections too.
+    if (character == '\r')
+    {
+      if (peek() == '\n')
+      {
+        continue;
+      }
+      character = '\n';
+    }
+
+    if (!output && window.size() == terminator.size())
+    {
+      window.erase(0, 1);
+    }
+    skipped += character;
+  }
+
+  skipped.resize(skipped.size() - terminator.size());
+}
+
+void XmlStreamReader::skipWhiteSpaces()
+{
+  while (is_white_space(peek()))
+  {
+    get();
+  }
+}
+
+char XmlStreamReader::get()
+{
+  if (_position == _size && !fill())
+  {
+    throwMalformed("Unexpected end of the document.");
+  }
+
+  return _buffer[_position++];
+}
+
+int XmlStreamReader::peek()
+{
+  if (_position == _size && !fill())
+  {
+    return std::char_traits<char>::eof();
+  }
+
+  return static_cast<unsigned char>(_buffer[_position]);
+}
+
+std::uint64_t XmlStreamReader::getOffset() const
+{
+  return _bufferOffset + _position;
+}
+
+bool XmlStreamReader::fill()
+{
+  _bufferOffset += _size;
+  const auto block_size = std::min<std::uint64_t>(_buffer.size(), _remaining);
+  _stream.read(_buffer.data(), static_cast<std::streamsize>(block_size));
+  _size = static_cast<std::size_t>(_stream.gcount());
+  _remaining -= _size;
+  _position = 0;
+  return _size != 0;
+}
+
+void XmlStreamReader::throwMalformed(const std::string& message) const
+{
+  throw Exception("Error loading XML: " + message);
+}
+
+namespace
+{
+
+bool is_white_space(int character)
+{
+  return character == ' ' || character == '\t' || character == '\n' || character == '\r';
+}
+
+bool is_white_space(const std::string& text)
+{
+  return std::all_of(text.begin(), text.end(),
+      [](char character) { return is_white_space(character); });
+}
+
+bool is_name_character(char character)
+{
+  return !is_white_space(character) && character != '/' && character != '>' &&
+      character != '=' && character != '<';
+}
+
+// The Char production of the XML specification.
+bool is_xml_character(std::uint32_t codePoint)
+{
+  return codePoint == 0x9 || codePoint == 0xA || codePoint == 0xD ||
+      (codePoint >= 0x20 && codePoint <= 0xD7FF) || (codePoint >= 0xE000 && codePoint <= 0xFFFD) ||
+      (codePoint >= 0x10000 && codePoint <= 0x10FFFF);
+}
+
+void append_utf8(std::uint32_t codePoint, std::string& output)
+{
+  if (codePoint < 0x80)
+  {
+    output += static_cast<char>(codePoint);
+  }
+  else if (codePoint < 0x800)
+  {
+    output += static_cast<char>(0xC0 | (codePoint >> 6));
+    output += static_cast<char>(0x80 | (codePoint & 0x3F));
+  }
+  else if (codePoint < 0x10000)
+  {
+    output += static_cast<char>(0xE0 | (codePoint >> 12));
+    output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+    output += static_cast<char>(0x80 | (codePoint & 0x3F));
+  }
+  else
+  {
+    output += static_cast<char>(0xF0 | (codePoint >> 18));
+    output += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+    output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+    output += static_cast<char>(0x80 | (codePoint & 0x3F));
+  }
+}
+
+} // anonymous namespace
+
+} // namespace fictionalfiesta
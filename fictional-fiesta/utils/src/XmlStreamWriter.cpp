@@ -0,0 +1,244 @@
+/// @file XmlStreamWriter.cpp Implementation of the XmlStreamWriter class.
+
+#include "fictional-fiesta/utils/itf/XmlStreamWriter.h"
+
+#include "fictional-fiesta/utils/itf/Exception.h"
+#include "fictional-fiesta/utils/itf/XmlNode.h"
+
+#include "fictional-fiesta/utils/src/PimplImpl.h"
+#include "fictional-fiesta/utils/src/XmlNodeImpl.h"
+#include "fictional-fiesta/utils/src/XmlStreamWriterImpl.h"
+
+#include <algorithm>
+
+namespace fictionalfiesta
+{
+
+namespace
+{
+
+// Same format as XmlDocument::save.
+constexpr char DECLARATION[]{"<?xml version=\"1.0\"?>\n"};
+constexpr char INDENT_STRING[]{"  "};
+
+/// The buffer is flushed to the stream once it reaches this size.
+constexpr std::size_t BUFFER_SIZE{1 << 20};
+
+} // anonymous namespace
+
+XmlStreamWriter::XmlStreamWriter(std::ostream& stream):
+  _pimpl(stream)
+{
+}
+
+XmlStreamWriter::~XmlStreamWriter() = default;
+
+XmlNode XmlStreamWriter::appendRootNode(const std::string& name)
+{
+  return XmlNode{_pimpl->appendRootNode(name)};
+}
+
+void XmlStreamWriter::finish()
+{
+  _pimpl->finish();
+}
+
+XmlStreamWriterImpl::XmlStreamWriterImpl(std::ostream& stream):
+  _stream(stream)
+{
+  _buffer.reserve(BUFFER_SIZE + BUFFER_SIZE / 8);
+  _buffer += DECLARATION;
+}
+
+XmlNodeImpl XmlStreamWriterImpl::appendRootNode(const std::string& name)
+{
+  if (_lastId != 0)
+  {
+    throw Exception("The document already has a root node.");
+  }
+
+  return openNode(name);
+}
+
+XmlNodeImpl XmlStreamWriterImpl::appendChildNode(const XmlNodeImpl& parent,
+    const std::string& name)
+{
+  auto& parent_node = getOpenNode(parent);
+  if (parent_node.hasText)
+  {
+    throw Exception("The node '" + parent_node.name + "' has text, so it cannot have children.");
+  }
+
+  closeNodesDeeperThan(parent._depth);
+  if (parent_node.isStartTagOpen)
+  {
+    _buffer += ">\n";
+    parent_node.isStartTagOpen = false;
+  }
+
+  return openNode(name);
+}
+
+void XmlStreamWriterImpl::setAttribute(const XmlNodeImpl& node, const std::string& name,
+    const std::string& value)
+{
+  auto& open_node = getOpenNode(node);
+  if (!open_node.isStartTagOpen || node._depth + 1 != _openNodes.size())
+  {
+    throw Exception("The attributes of the node '" + open_node.name + "' must be set before "
+        "its text and its children.");
+  }
+
+  auto& names = open_node.attributeNames;
+  if (std::find(names.begin(), names.end(), name) != names.end())
+  {
+    throw Exception("The attribute '" + name + "' of the node '" + open_node.name +
+        "' is already set.");
+  }
+  names.push_back(name);
+
+  _buffer += ' ';
+  _buffer += name;
+  _buffer += "=\"";
+  writeEscaped(value, true);
+  _buffer += '"';
+}
+
+void XmlStreamWriterImpl::setText(const XmlNodeImpl& node, const std::string& text)
+{
+  auto& open_node = getOpenNode(node);
+  if (!open_node.isStartTagOpen || node._depth + 1 != _openNodes.size())
+  {
+    throw Exception("The text of the node '" + open_node.name + "' must be set once, and not "
+        "after its children.");
+  }
+
+  _buffer += '>';
+  writeEscaped(text, false);
+  open_node.isStartTagOpen = false;
+  open_node.hasText = true;
+  flushIfFull();
+}
+
+void XmlStreamWriterImpl::finish()
+{
+  while (!_openNodes.empty())
+  {
+    closeNode();
+  }
+
+  _stream.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+  _buffer.clear();
+  _stream.flush();
+  if (!_stream)
+  {
+    throw Exception("Error writing the XML document.");
+  }
+}
+
+XmlStreamWriterImpl::OpenNode& XmlStreamWriterImpl::getOpenNode(const XmlNodeImpl& node)
+{
+  if (node._depth >= _openNodes.size() || _openNodes[node._depth].id != node._id)
+  {
+    throw Exception("The node has already been written, it cannot be modified.");
+  }
+
+  return _openNodes[node._depth];
+}
+
+XmlNodeImpl XmlStreamWriterImpl::openNode(const std::string& name)
+{
+  const auto depth = _openNodes.size();
+  writeIndent(depth);
+  _buffer += '<';
+  _buffer += name;
+
+  _openNodes.push_back(OpenNode{name, ++_lastId, {}, true, false});
+  return XmlNodeImpl{*this, depth, _lastId};
+}
+
+void XmlStreamWriterImpl::closeNodesDeeperThan(std::size_t depth)
+{
+  while (_openNodes.size() > depth + 1)
+  {
+    closeNode();
+  }
+}
+
+void XmlStreamWriterImpl::closeNode()
+{
+  const auto& node = _openNodes.back();
+  if (node.isStartTagOpen)
+  {
+    _buffer += " />\n";
+  }
+  else
+  {
+    if (!node.hasText)
+    {
+      writeIndent(_openNodes.size() - 1);
+    }
+    _buffer += "</";
+    _buffer += node.name;
+    _buffer += ">\n";
+  }
+  _openNodes.pop_back();
+  flushIfFull();
+}
+
+void XmlStreamWriterImpl::writeEscaped(const std::string& text, bool isAttribute)
+{
+  // Same escapes as pugixml: the control characters are written as numeric references, except
+  // the white spaces in texts.
+  for (const char character : text)
+  {
+    switch (character)
+    {
+      case '&':
+        _buffer += "&amp;";
+        break;
+      case '<':
+        _buffer += "&lt;";
+        break;
+      case '>':
+        _buffer += "&gt;";
+        break;
+      case '"':
+        _buffer += isAttribute ? "&quot;" : "\"";
+        break;
+      default:
+        const auto code = static_cast<unsigned char>(character);
+        if (code < 32 && (isAttribute || (character != '\t' && character != '\n' &&
+            character != '\r')))
+        {
+          _buffer += "&#";
+          _buffer += static_cast<char>('0' + code / 10);
+          _buffer += static_cast<char>('0' + code % 10);
+          _buffer += ';';
+        }
+        else
+        {
+          _buffer += character;
+        }
+    }
+  }
+}
+
+void XmlStreamWriterImpl::writeIndent(std::size_t depth)
+{
+  for (std::size_t level = 0; level < depth; ++level)
+  {
+    _buffer += INDENT_STRING;
+  }
+}
+
+void XmlStreamWriterImpl::flushIfFull()
+{
+  if (_buffer.size() >= BUFFER_SIZE)
+  {
+    _stream.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+    _buffer.clear();
+  }
+}
+
+} // namespace fictionalfiesta
@@ -0,0 +1,120 @@
+#ifndef INCLUDE_FICTIONAL_FIESTA_UTILS_XML_STREAM_WRITER_IMPL_H
+#define INCLUDE_FICTIONAL_FIESTA_UTILS_XML_STREAM_WRITER_IMPL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace fictionalfiesta
+{
+
+class XmlNodeImpl;
+
+/// @brief Implementation of the XmlStreamWriter class.
+/// @details The open nodes (the last one appended and its ancestors) are kept in a stack. The
+///   nodes given to XmlNode refer to their depth in it and to an identifier, so the handles of
+///   finished nodes are detected. The output is gathered in a buffer that is flushed to the
+///   stream in large blocks.
+class XmlStreamWriterImpl
+{
+  public:
+
+    /// @brief Constructor from the stream where the document is written.
+    /// @param stream Stream where the document is written.
+    explicit XmlStreamWriterImpl(std::ostream& stream);
+
+    /// @copydoc XmlStreamWriter::appendRootNode
+    XmlNodeImpl appendRootNode(const std::string& name);
+
+    /// @brief Appends a child node.
+    /// @param parent Node where the child is appended.
+    /// @param name Name of the child node.
+    /// @return Child node.
+    /// @throw Exception if @p parent is finished or has text.
+    XmlNodeImpl appendChildNode(const XmlNodeImpl& parent, const std::string& name);
+
+    /// @brief Sets an attribute of a node.
+    /// @param node Node whose attribute is set.
+    /// @param name Name of the attribute.
+    /// @param value Value of the attribute.
+    /// @throw Exception if the node already has text, children or the attribute.
+    void setAttribute(const XmlNodeImpl& node, const std::string& name, const std::string& value);
+
+    /// @brief Sets the text of a node.
+    /// @param node Node whose text is set.
+    /// @param text Text of the node.
+    /// @throw Exception if the node already has text or children.
+    void setText(const XmlNodeImpl& node, const std::string& text);
+
+    /// @copydoc XmlStreamWriter::finish
+    void finish();
+
+  private:
+
+    /// @brief Node whose end tag has not been written yet.
+    struct OpenNode
+    {
+      /// Name of the node.
+      std::string name;
+
+      /// Identifier of the node, unique in the document.
+      std::uint64_t id;
+
+      /// Names of the attributes written.
+      std::vector<std::string> attributeNames;
+
+      /// Whether the start tag is still open, i.e. attributes can be written.
+      bool isStartTagOpen;
+
+      /// Whether the node has text.
+      bool hasText;
+    };
+
+    /// @brief Gets the open node referred by a node handle.
+    /// @param node Node handle.
+    /// @return Open node.
+    /// @throw Exception if the node is finished.
+    OpenNode& getOpenNode(const XmlNodeImpl& node);
+
+    /// @brief Writes the start tag of a node.
+    /// @param name Name of the node.
+    /// @return Handle of the node.
+    XmlNodeImpl openNode(const std::string& name);
+
+    /// @brief Writes the end tags of the open nodes deeper than a given depth.
+    /// @param depth Depth of the last node that stays open.
+    void closeNodesDeeperThan(std::size_t depth);
+
+    /// @brief Writes the end tag of the deepest open node.
+    void closeNode();
+
+    /// @brief Writes a text, escaping the XML special characters.
+    /// @param text Text to be written.
+    /// @param isAttribute Whether the text is an attribute value (quotes are escaped too).
+    void writeEscaped(const std::string& text, bool isAttribute);
+
+    /// @brief Writes the indentation of a given depth.
+    /// @param depth Depth of the node.
+    void writeIndent(std::size_t depth);
+
+    /// @brief Writes the buffer to the stream if it is full.
+    void flushIfFull();
+
+    /// Stream where the document is written.
+    std::ostream& _stream;
+
+    /// Output not written to the stream yet.
+    std::string _buffer;
+
+    /// Open nodes, from the root to the deepest one.
+    std::vector<OpenNode> _openNodes;
+
+    /// Identifier of the last node appended.
+    std::uint64_t _lastId{0};
+};
+
+} // namespace fictionalfiesta
+
+#endif
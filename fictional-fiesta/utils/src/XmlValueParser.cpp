@@ -0,0 +1,146 @@
+/// @file XmlValueParser.cpp Implementation of the XmlValueParser class.
+
+#include "fictional-fiesta/utils/src/XmlValueParser.h"
+
+#include "fictional-fiesta/utils/itf/Exception.h"
+
+#include <charconv>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+namespace fictionalfiesta
+{
+
+namespace
+{
+
+constexpr char WHITE_SPACES[]{" \t\n\r"};
+
+template <typename T>
+T parse_integer(std::string_view text);
+
+template <typename T>
+T parse_floating_point(std::string_view text);
+
+[[noreturn]] void throw_invalid(std::string_view text, std::errc error);
+
+} // anonymous namespace
+
+/// @cond
+// Somehow, Doxygen has a problem with these explicit instantiations.
+template int XmlValueParser::parse(std::string_view text);
+template unsigned int XmlValueParser::parse(std::string_view text);
+template double XmlValueParser::parse(std::string_view text);
+template float XmlValueParser::parse(std::string_view text);
+template bool XmlValueParser::parse(std::string_view text);
+template long long XmlValueParser::parse(std::string_view text);
+template unsigned long long XmlValueParser::parse(std::string_view text);
+/// @endcond
+
+template <typename T>
+T XmlValueParser::parse(std::string_view text)
+{
+  const auto begin = text.find_first_not_of(WHITE_SPACES);
+  if (begin == std::string_view::npos)
+  {
+    if constexpr (std::is_same_v<T, bool>)
+    {
+      return false;
+    }
+    throw_invalid(text, std::errc::invalid_argument);
+  }
+  auto value_text = text.substr(begin, text.find_last_not_of(WHITE_SPACES) + 1 - begin);
+
+  if constexpr (std::is_same_v<T, bool>)
+  {
+    const auto first = value_text.front();
+    return first == '1' || first == 't' || first == 'T' || first == 'y' || first == 'Y';
+  }
+  else
+  {
+    // std::from_chars does not take the plus sign.
+    if (value_text.size() > 1 && value_text.front() == '+' && value_text[1] != '-')
+    {
+      value_text.remove_prefix(1);
+    }
+
+    if constexpr (std::is_floating_point_v<T>)
+    {
+      return parse_floating_point<T>(value_text);
+    }
+    else
+    {
+      return parse_integer<T>(value_text);
+    }
+  }
+}
+
+namespace
+{
+
+// The magnitude is parsed apart from the sign, since std::from_chars does not take the "0x".
+template <typename T>
+T parse_integer(std::string_view text)
+{
+  const bool is_negative = text.front() == '-';
+  auto digits = text.substr(is_negative ? 1 : 0);
+  int base = 10;
+  if (digits.size() > 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X'))
+  {
+    digits.remove_prefix(2);
+    base = 16;
+  }
+
+  unsigned long long magnitude{0};
+  const auto end = digits.data() + digits.size();
+  const auto result = std::from_chars(digits.data(), end, magnitude, base);
+  if (result.ec != std::errc{} || result.ptr != end)
+  {
+    throw_invalid(text, result.ec == std::errc{} ? std::errc::invalid_argument : result.ec);
+  }
+
+  // The magnitude of the minimum is one more than the maximum.
+  const auto limit = static_cast<unsigned long long>(std::numeric_limits<T>::max()) +
+      ((is_negative && std::is_signed_v<T>) ? 1 : 0);
+  if (magnitude > limit || (is_negative && !std::is_signed_v<T> && magnitude != 0))
+  {
+    throw_invalid(text, std::errc::result_out_of_range);
+  }
+
+  if constexpr (std::is_signed_v<T>)
+  {
+    // Negated in the unsigned type, so the minimum does not overflow.
+    return is_negative ? static_cast<T>(0ull - magnitude) : static_cast<T>(magnitude);
+  }
+  else
+  {
+    return static_cast<T>(magnitude);
+  }
+}
+
+template <typename T>
+T parse_floating_point(std::string_view text)
+{
+  T value{0};
+  const auto end = text.data() + text.size();
+  const auto result = std::from_chars(text.data(), end, value);
+  if (result.ec != std::errc{} || result.ptr != end)
+  {
+    throw_invalid(text, result.ec == std::errc{} ? std::errc::invalid_argument : result.ec);
+  }
+
+  return value;
+}
+
+void throw_invalid(std::string_view text, std::errc error)
+{
+  const std::string reason = (error == std::errc::result_out_of_range) ?
+      "is out of range" : "is not a number";
+  throw Exception("The value '" + std::string{text} + "' " + reason + ".");
+}
+
+} // anonymous namespace
+
+} // namespace fictionalfiesta
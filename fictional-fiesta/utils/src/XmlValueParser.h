@@ -0,0 +1,30 @@
+#ifndef INCLUDE_FICTIONAL_FIESTA_UTILS_XML_VALUE_PARSER_H
+#define INCLUDE_FICTIONAL_FIESTA_UTILS_XML_VALUE_PARSER_H
+
+#include <string_view>
+
+namespace fictionalfiesta
+{
+
+/// @class XmlValueParser
+/// @brief Static class that parses the texts and attribute values of the XML documents.
+/// @details Shared by XmlNode and XmlStreamReader, so a document reads the same whichever way it
+///   is loaded. The numbers are parsed with std::from_chars: the leading and trailing white
+///   spaces and a leading '+' are allowed, and the integers may also be hexadecimal (0x). The
+///   booleans follow the pugixml rule: true if they start with '1', 't', 'T', 'y' or 'Y'.
+class XmlValueParser
+{
+  public:
+
+    /// @brief Parses a value into @p T type.
+    /// @tparam T Type into which the value needs to be parsed: bool or an arithmetic type.
+    /// @param text Text of the value.
+    /// @return value resulting of the parsing.
+    /// @throw Exception if the text is not a number, or it is out of the range of @p T.
+    template <typename T>
+    static T parse(std::string_view text);
+};
+
+} // namespace fictionalfiesta
+
+#endif
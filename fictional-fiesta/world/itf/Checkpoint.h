@@ -0,0 +1,103 @@
+#ifndef INCLUDE_FICTIONAL_FIESTA_WORLD_CHECKPOINT_H
+#define INCLUDE_FICTIONAL_FIESTA_WORLD_CHECKPOINT_H
+
+#include "fictional-fiesta/utils/itf/XmlSavable.h"
+
+#include "fictional-fiesta/world/itf/FSM.h"
+#include "fictional-fiesta/world/itf/World.h"
+
+#include <experimental/filesystem>
+#include <string>
+
+namespace fictionalfiesta
+{
+
+class XmlNode;
+class XmlStreamReader;
+
+/// @brief Class that holds the whole state of a simulation run: the world, the random number
+///   generator that drives its cycles and the number of cycles already run.
+/// @details The settings of the world that change the results (resource split mode and
+///   sharding) are saved too and restored when loading, while the thread counts are not, since
+///   the results do not depend on them. A run resumed from a saved checkpoint continues
+///   bit-identically to an uninterrupted one, as long as the build uses the same random number
+///   engine (FSM::RNG_ENGINE_NAME).
+class Checkpoint : public XmlSavable
+{
+  public:
+
+    /// @brief Constructor from members.
+    /// @param world World whose cycles are run.
+    /// @param rng Random number generator used to run the cycles.
+    /// @param cycleCount Number of cycles already run.
+    Checkpoint(World&& world, const FSM::Rng& rng, unsigned long long cycleCount = 0);
+
+    /// @brief Constructor from a path to a XML document.
+    /// @details The document is streamed, so it is never loaded whole in memory.
+    /// @param xmlPath Path to the checkpoint XML document.
+    /// @param threadCount Number of threads used to parse the locations of the world. Zero means
+    ///   one per hardware thread.
+    /// @throw fictionalfiesta::Exception if it was saved with another random number engine or
+    ///   with an unknown resource split mode.
+    explicit Checkpoint(const std::experimental::filesystem::path& xmlPath,
+        unsigned int threadCount = 1);
+
+    /// @brief Constructor from a XmlNode.
+    /// @param node XML node from where to load the class contents.
+    /// @param threadCount Number of threads used to build the locations of the world. Zero means
+    ///   one per hardware thread.
+    /// @throw fictionalfiesta::Exception if it was saved with another random number engine or
+    ///   with an unknown resource split mode.
+    explicit Checkpoint(const XmlNode& node, unsigned int threadCount = 1);
+
+    /// @brief Constructor from a XML stream.
+    /// @param reader Reader positioned at the checkpoint element, read up to its end.
+    /// @param threadCount Number of threads used to parse the locations of the world. Zero means
+    ///   one per hardware thread.
+    /// @throw fictionalfiesta::Exception if it was saved with another random number engine or
+    ///   with an unknown resource split mode.
+    explicit Checkpoint(XmlStreamReader& reader, unsigned int threadCount = 1);
+
+    /// @brief Runs a cycle of the world and counts it.
+    void cycle();
+
+    /// @brief Gets the world.
+    /// @return Reference to the world, e.g. to change its settings.
+    World& getWorld();
+
+    /// @brief Gets the world.
+    /// @return Constant reference to the world.
+    const World& getWorld() const;
+
+    /// @brief Gets the random number generator used to run the cycles.
+    /// @return Constant reference to the random number generator.
+    const FSM::Rng& getRng() const;
+
+    /// @brief Gets the number of cycles already run.
+    /// @return Number of cycles.
+    unsigned long long getCycleCount() const;
+
+    /// Name of the main XML node for this class.
+    static constexpr char XML_MAIN_NODE_NAME[]{"Checkpoint"};
+
+  private:
+
+    /// @copydoc XmlSavable::doSave
+    void doSave(XmlNode& node) const override;
+
+    /// @copydoc XmlSavable::getDefaultXmlName
+    virtual std::string getDefaultXmlName() const override;
+
+    /// World whose cycles are run.
+    World _world;
+
+    /// Random number generator used to run the cycles.
+    FSM::Rng _rng;
+
+    /// Number of cycles already run.
+    unsigned long long _cycleCount;
+};
+
+} // namespace fictionalfiesta
+
+#endif
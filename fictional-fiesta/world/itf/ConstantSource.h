@@ -8,6 +8,8 @@
 namespace fictionalfiesta
 {
 
+class BinaryReader;
+class BinaryWriter;
 class XmlNode;
 
 /// @brief Class that represents a constant source whose resource units are always
@@ -36,6 +38,14 @@ class ConstantSource : public Source
     /// @param node XmlNode from where to read the contents of the instance.
     explicit ConstantSource(const XmlNode& node);
 
+    /// @brief Constructor from a BinaryReader, after the type of the source.
+    /// @param reader Reader of a snapshot positioned at the contents written by
+    ///   Source::save(BinaryWriter&) after the type.
+    explicit ConstantSource(BinaryReader& reader);
+
+    /// @copydoc Source::getType
+    std::string getType() const override;
+
     /// @copydoc Source::regenerate
     void regenerate() override;
 
@@ -53,6 +63,8 @@ class ConstantSource : public Source
     ConstantSource(const XmlNode& node, unsigned int fixedUnitCount);
     void doSave(XmlNode& node) const override;
 
+    void doSave(BinaryWriter& writer) const override;
+
     ConstantSource* doClone() const override;
 
     /// Nuber of units at the begining of each cycle.
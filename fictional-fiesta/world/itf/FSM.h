@@ -1,7 +1,14 @@
 #ifndef INCLUDE_FICTIONAL_FIESTA_WORLD_FSM_H
 #define INCLUDE_FICTIONAL_FIESTA_WORLD_FSM_H
 
+#include "fictional-fiesta/world/itf/RngEngines.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
 #include <random>
+#include <string>
 
 namespace fictionalfiesta
 {
@@ -13,9 +20,218 @@ class FSM
 {
   public:
 
+#if defined(FICTIONAL_FIESTA_RNG_XOSHIRO256PP)
+    /// Abstraction for the random number generator type.
+    using Rng = Xoshiro256PlusPlus;
+
+    /// Name of the random number generator type, as in the CMake option.
+    static constexpr char RNG_ENGINE_NAME[]{"xoshiro256pp"};
+#elif defined(FICTIONAL_FIESTA_RNG_PCG64)
     /// Abstraction for the random number generator type.
+    using Rng = Pcg64;
+
+    /// Name of the random number generator type, as in the CMake option.
+    static constexpr char RNG_ENGINE_NAME[]{"pcg64"};
+#else
+    /// Abstraction for the random number generator type. The engine can be changed with the
+    /// FICTIONAL_FIESTA_RNG_ENGINE CMake option.
     using Rng = std::mt19937;
 
+    /// Name of the random number generator type, as in the CMake option.
+    static constexpr char RNG_ENGINE_NAME[]{"mt19937"};
+#endif
+
+    /// @brief Counter-based random number generator (Philox4x32-10).
+    /// @details Every output block is a keyed bijection of a counter, so the generator has no
+    ///   state other than the counter and it can be split in independent streams for free: a
+    ///   stream is identified by a seed (the key of the bijection) and a key tuple, e.g.
+    ///   (cycle, location, individual, purpose), which is hashed into the upper half of the
+    ///   counter. A stream yields the same values no matter when, where or in which order it
+    ///   is used, so any phase can be parallelized or reordered without changing the results.
+    ///   It models UniformRandomBitGenerator, so it works with the standard distributions.
+    class CounterRng
+    {
+      public:
+
+        /// Type of the generated values.
+        using result_type = std::uint32_t;
+
+        /// Type of the counter of the bijection.
+        using Counter = std::array<std::uint32_t, 4>;
+
+        /// Type of the key of the bijection.
+        using Key = std::array<std::uint32_t, 2>;
+
+        /// @brief Constructor from the seed and the key tuple of the stream.
+        /// @param seed Seed shared by all the streams.
+        /// @param streamKey Key tuple identifying the stream. The order of the values matters.
+        CounterRng(std::uint64_t seed, std::initializer_list<std::uint64_t> streamKey) noexcept;
+
+        /// @brief Generates the next value of the stream.
+        /// @return Uniformly distributed value in [min(), max()].
+        result_type operator()() noexcept;
+
+        /// @brief Skips values of the stream, in constant time.
+        /// @param count Number of values to be skipped.
+        void discard(unsigned long long count) noexcept;
+
+        /// @brief Minimum value generated.
+        /// @return Minimum value.
+        static constexpr result_type min() noexcept { return 0; }
+
+        /// @brief Maximum value generated.
+        /// @return Maximum value.
+        static constexpr result_type max() noexcept { return UINT32_MAX; }
+
+        /// @brief Applies the Philox4x32-10 bijection.
+        /// @param counter Counter to be encrypted.
+        /// @param key Key of the bijection.
+        /// @return Block of four random values.
+        static Counter encrypt(Counter counter, Key key) noexcept;
+
+      private:
+
+        /// Values in a block.
+        static constexpr unsigned int BLOCK_SIZE{4};
+
+        /// @brief Sets the counter to a given block and generates it.
+        /// @param block Index of the block in the stream.
+        void generateBlock(std::uint64_t block) noexcept;
+
+        /// Key of the bijection (the seed).
+        Key _key;
+
+        /// Index of the current block in the stream (lower half of the counter).
+        std::uint64_t _block = 0;
+
+        /// Hash of the key tuple (upper half of the counter).
+        std::uint64_t _stream;
+
+        /// Values of the current block.
+        Counter _values{};
+
+        /// Position of the next value in the current block. BLOCK_SIZE if it is not generated.
+        unsigned int _position = BLOCK_SIZE;
+    };
+
+    /// @brief First values of a batch of consecutive counter-based streams, generated together.
+    /// @details Lane @e l holds the first VALUE_COUNT values of the stream
+    ///   createStream(seed, {firstStream + l}), so a phase can draw the first decisions of SIZE
+    ///   individuals at once and fall back to the stream itself (skipping the values already
+    ///   used) for any further draw. The loops over the lanes are branch free, so the compiler
+    ///   can vectorize them.
+    ///   The Bernoulli variates compare the raw values with an integer threshold instead of
+    ///   building a distribution and a floating point variate per draw.
+    class StreamBatch
+    {
+      public:
+
+        /// Number of streams in a batch.
+        static constexpr std::size_t SIZE{16};
+
+        /// Number of values generated for each stream: the first Philox block.
+        static constexpr unsigned int VALUE_COUNT{4};
+
+        /// Type of a value for each stream of the batch.
+        using Values = std::array<std::uint32_t, SIZE>;
+
+        /// Type of a Bernoulli threshold for each stream of the batch.
+        using Thresholds = std::array<std::uint64_t, SIZE>;
+
+        /// Type of a Bernoulli outcome for each stream of the batch.
+        using Outcomes = std::array<bool, SIZE>;
+
+        /// @brief Constructor. Generates the first values of the streams of a batch.
+        /// @param seed Seed shared by all the streams.
+        /// @param firstStream Key of the stream of the first lane.
+        StreamBatch(std::uint64_t seed, std::uint64_t firstStream) noexcept;
+
+        /// @brief Gets a value of every stream.
+        /// @param position Position of the value in the streams (less than VALUE_COUNT).
+        /// @return Value at the given position of the stream of every lane.
+        const Values& getValues(unsigned int position) const noexcept;
+
+        /// @brief Draws a Bernoulli variate for every stream.
+        /// @param position Position of the value used in the streams (less than VALUE_COUNT).
+        /// @param thresholds Threshold of every lane (see bernoulliThreshold).
+        /// @param outcomes Outcome of every lane (@e true with the probability of its threshold).
+        void bernoulli(unsigned int position, const Thresholds& thresholds,
+            Outcomes& outcomes) const noexcept;
+
+        /// @brief Draws a uniform variate in [0, 1) for every stream.
+        /// @param position Position of the value used in the streams (less than VALUE_COUNT).
+        /// @param uniforms Uniform variate of every lane, with a resolution of 2^-32.
+        void uniforms(unsigned int position, std::array<double, SIZE>& uniforms) const noexcept;
+
+        /// @brief Computes the integer threshold of a Bernoulli variate.
+        /// @param probability Probability of success. It is clamped to [0, 1].
+        /// @return Threshold such that a raw 32-bit value below it is a success.
+        static std::uint64_t bernoulliThreshold(double probability) noexcept;
+
+      private:
+
+        /// Values of every stream, by position.
+        std::array<Values, VALUE_COUNT> _values;
+    };
+
+    /// @brief Generator of standard normal variates with the Box-Muller transform.
+    /// @details Every transform turns two uniform variates into two independent normal
+    ///   variates, and the second one is cached for the next call, so nothing is thrown away as
+    ///   long as the same instance is kept (unlike a short-lived std::normal_distribution).
+    ///   Every pair consumes exactly two values of the engine, so the number of values used
+    ///   from a counter-based stream is known in advance. The draws are defined in the header
+    ///   so they work with any engine and can be inlined in the phase loops.
+    ///   The cache only pays off while the draws share an engine. In the reproduction phase
+    ///   every parent draws from its own stream, so the cache is intentionally per offspring
+    ///   there: the fourth variate of each parent is dropped, since carrying it over would tie
+    ///   the mutations of a parent to the stream of the previous one.
+    class NormalGenerator
+    {
+      public:
+
+        /// @brief Draws a standard normal variate.
+        /// @tparam Generator Random number generator type (FSM::Rng or FSM::CounterRng).
+        /// @param rng Random number generator. Only used when there is no cached variate.
+        /// @return Normal variate with mean 0 and standard deviation 1.
+        template <typename Generator>
+        double operator()(Generator& rng);
+
+        /// @brief Draws a uniform variate in (0, 1), as used by the transform.
+        /// @tparam Generator Random number generator type (FSM::Rng or FSM::CounterRng).
+        /// @param rng Random number generator. A single value is used.
+        /// @return Uniform variate, never 0 or 1.
+        template <typename Generator>
+        static double openUniform(Generator& rng);
+
+        /// @brief Applies the Box-Muller transform to arrays of uniform variates.
+        /// @details Batched version of the draws, with no dependency between the elements so the
+        ///   loop can be vectorized.
+        /// @param radii First uniform variate of every pair, in (0, 1).
+        /// @param angles Second uniform variate of every pair, in (0, 1).
+        /// @param count Number of pairs.
+        /// @param first First normal variate of every pair.
+        /// @param second Second normal variate of every pair.
+        static void transform(const double* radii, const double* angles, std::size_t count,
+            double* first, double* second) noexcept;
+
+        /// @brief Drops the cached variate, if any.
+        void reset() noexcept;
+
+      private:
+
+        /// Factor that maps a raw 32-bit value to [0, 1).
+        static constexpr double SCALE_32{1.0 / (std::uint64_t{1} << 32)};
+
+        /// Factor that maps the 53 upper bits of a raw 64-bit value to [0, 1).
+        static constexpr double SCALE_53{1.0 / (std::uint64_t{1} << 53)};
+
+        /// Second variate of the last pair, not returned yet.
+        double _cached = 0;
+
+        /// Whether there is a cached variate.
+        bool _hasCached = false;
+    };
+
     /// @brief Creates a random number generator (rng) with a (pseudo) random seed.
     /// @return Random number generator with a random seed.
     static Rng createRng();
@@ -25,8 +241,70 @@ class FSM
     /// @return Random number generator with a given seed.
     static Rng createRng(unsigned int seed);
 
+    /// @brief Creates a random number generator (rng) for one of the streams of a given seed.
+    /// @details Generators of different streams are seeded independently, so they can be used
+    ///   at the same time (e.g. from different threads) and their results do not depend on the
+    ///   order in which they are used.
+    /// @param seed Seed shared by all the streams. All its 64 bits are used, so it can be taken
+    ///   from a 64-bit engine without truncating it.
+    /// @param stream Index of the stream.
+    /// @return Random number generator of the given stream.
+    static Rng createRng(std::uint64_t seed, unsigned long long stream);
+
+    /// @brief Writes the state of a random number generator as text.
+    /// @param rng Random number generator.
+    /// @return State of the generator, which can be restored with rngFromString.
+    static std::string rngToString(const Rng& rng);
+
+    /// @brief Restores a random number generator from its state as text.
+    /// @param state State written by rngToString with the same engine (see RNG_ENGINE_NAME).
+    /// @return Random number generator that continues exactly where the saved one was.
+    /// @throw fictionalfiesta::Exception if the state is not valid for the engine.
+    static Rng rngFromString(const std::string& state);
+
+    /// @brief Creates a counter-based generator for the stream of a given key tuple.
+    /// @param seed Seed shared by all the streams.
+    /// @param streamKey Key tuple identifying the stream, e.g. (cycle, location, individual,
+    ///   purpose). The order of the values matters.
+    /// @return Counter-based random number generator of the given stream.
+    static CounterRng createStream(std::uint64_t seed,
+        std::initializer_list<std::uint64_t> streamKey) noexcept;
+
 };
 
+template <typename Generator>
+double FSM::NormalGenerator::operator()(Generator& rng)
+{
+  if (_hasCached)
+  {
+    _hasCached = false;
+    return _cached;
+  }
+
+  const auto radius = openUniform(rng);
+  const auto angle = openUniform(rng);
+  double result;
+  transform(&radius, &angle, 1, &result, &_cached);
+  _hasCached = true;
+  return result;
+}
+
+template <typename Generator>
+double FSM::NormalGenerator::openUniform(Generator& rng)
+{
+  static_assert(Generator::min() == 0, "The engine must generate values from 0.");
+
+  // Centered in the intervals of the raw values, so 0 (the log of the radius) is never hit.
+  if constexpr (Generator::max() > 0xffffffffULL)
+  {
+    return (static_cast<double>(static_cast<std::uint64_t>(rng()) >> 11) + 0.5) * SCALE_53;
+  }
+  else
+  {
+    return (static_cast<double>(rng()) + 0.5) * SCALE_32;
+  }
+}
+
 } // namespace fictionalfiesta
 
 #endif
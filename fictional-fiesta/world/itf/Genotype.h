@@ -11,6 +11,7 @@ namespace fictionalfiesta
 
 class Phenotype;
 class XmlNode;
+class XmlStreamReader;
 
 /// @brief Class that represents the set of features that are inherited by individuals.
 class Genotype : public Descriptable, public XmlSavable
@@ -31,6 +32,10 @@ class Genotype : public Descriptable, public XmlSavable
     /// @param node XML node from which the genotype will be loaded.
     Genotype(const XmlNode& node);
 
+    /// @brief Constructor from a XML stream.
+    /// @param reader Reader positioned at the genotype element, read up to its end.
+    explicit Genotype(XmlStreamReader& reader);
+
     /// @brief Get the reproduction energy threshold.
     /// @return Reproduction energy threshold.
     double getReproductionEnergyThreshold() const;
@@ -47,24 +52,53 @@ class Genotype : public Descriptable, public XmlSavable
     ///     genotype will reproduce or not.
     /// @note This is a probabilistic method that depends, among others, on the reproduction
     ///     probability.
+    /// @tparam Generator Random number generator type (FSM::Rng or FSM::CounterRng).
     /// @param phenotype Phenotype of the individual.
     /// @param rng Random number generator.
     /// @return @c true if the individual is going to reproduce and @c false if not.
-    bool willReproduce(const Phenotype& phenotype, FSM::Rng &rng) const;
+    template <typename Generator>
+    bool willReproduce(const Phenotype& phenotype, Generator& rng) const;
 
     /// @brief Obtains a new (mutated) genotype from the current one.
+    /// @details A new FSM::NormalGenerator is used, so the variate left over is dropped. That is
+    ///     what the reproduction phase needs, as every parent draws from its own stream.
+    /// @tparam Generator Random number generator type (FSM::Rng or FSM::CounterRng).
     /// @param rng Random number generator.
     /// @return New mutated genotype.
-    Genotype reproduce(FSM::Rng& rng) const;
+    template <typename Generator>
+    Genotype reproduce(Generator& rng) const;
+
+    /// @brief Obtains a new (mutated) genotype from the current one, keeping the normal
+    ///     variates left over by a generator for the next offspring.
+    /// @details Only useful when several offspring are drawn from the same engine.
+    /// @tparam Generator Random number generator type (FSM::Rng or FSM::CounterRng).
+    /// @param rng Random number generator.
+    /// @param normal Generator of the normal variates, reused between offspring.
+    /// @return New mutated genotype.
+    template <typename Generator>
+    Genotype reproduce(Generator& rng, FSM::NormalGenerator& normal) const;
+
+    /// @brief Obtains the genotype mutated by given standard normal variates.
+    /// @details Every feature changes accordingly to a normal distribution with the original
+    ///     value as mean and the mutability ratio times the value as standard deviation.
+    /// @param reproductionEnergyThresholdVariate Normal variate of the reproduction energy
+    ///     threshold.
+    /// @param reproductionProbabilityVariate Normal variate of the reproduction probability.
+    /// @param mutabilityRatioVariate Normal variate of the mutability ratio.
+    /// @return New mutated genotype.
+    Genotype mutate(double reproductionEnergyThresholdVariate,
+        double reproductionProbabilityVariate, double mutabilityRatioVariate) const;
 
     /// @brief Determines whether the current genotype produced a deadly mutation upon
     ///     reproduction or not.
     /// @details The probability of deadly mutations depends on several factors, like for
     ///     example, the mutability ratio or the complexity of the genotype.
+    /// @tparam Generator Random number generator type (FSM::Rng or FSM::CounterRng).
     /// @param rng Random number generator.
     /// @return @c true if there was a deadly mutation upon reproduction and @c false
     ///     otherwise.
-    bool producedDeadlyMutation(FSM::Rng& rng) const;
+    template <typename Generator>
+    bool producedDeadlyMutation(Generator& rng) const;
 
     /// @brief Determines the distance between the current Genotype and another one.
     /// @details The distance between two genotypes @e A and @e B is defined by
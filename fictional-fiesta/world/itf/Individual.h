@@ -8,10 +8,13 @@
 #include "fictional-fiesta/world/itf/Genotype.h"
 #include "fictional-fiesta/world/itf/Phenotype.h"
 
+#include <optional>
+
 namespace fictionalfiesta
 {
 
 class XmlNode;
+class XmlStreamReader;
 
 /// @brief Class that represents an individual.
 class Individual : public Descriptable, public XmlSavable
@@ -27,6 +30,10 @@ class Individual : public Descriptable, public XmlSavable
     /// @param node from which to build the class.
     explicit Individual(const XmlNode& node);
 
+    /// @brief Constructor from a XML stream.
+    /// @param reader Reader positioned at the individual element, read up to its end.
+    explicit Individual(XmlStreamReader& reader);
+
     /// @brief Gets the current individual's genotype.
     /// @return Genotype of this individual.
     const Genotype& getGenotype() const;
@@ -52,6 +59,10 @@ class Individual : public Descriptable, public XmlSavable
     /// @return @e true if the current individual is hungy and @e false otherwise.
     bool isHungry() const;
 
+    /// @brief Gets the number of resource units the individual has to eat to stop being hungry.
+    /// @return Number of units until the individual is satiated (0 if it is not hungry).
+    unsigned int getUnitsToSatiety() const;
+
     /// @brief The individual consumes @p units of resource.
     /// @param units Number of resource units of resource consumed.
     /// @return Current Individual.
@@ -76,6 +87,43 @@ class Individual : public Descriptable, public XmlSavable
     /// @copydoc Descriptable::str
     virtual std::string str(unsigned int indentLevel) const override;
 
+    /// @brief Computes the resource units needed to stop being hungry from the raw state of an
+    ///   individual.
+    /// @param energy Energy of the individual.
+    /// @param resourceCount Resource units accumulated by the individual.
+    /// @return Number of units until the individual is satiated (0 if it is not hungry).
+    static unsigned int unitsToSatiety(double energy, unsigned int resourceCount);
+
+    /// @brief Computes the probability of starving in the maintenance phase from the raw state
+    ///   of an individual.
+    /// @details An individual uses at least half its energy in resources just to survive. If
+    ///   there are not enough resources it might die out of starvation.
+    /// @param energy Energy of the individual.
+    /// @param resourceCount Resource units accumulated by the individual.
+    /// @return Probability of starving to death (zero if the maintenance cost is covered).
+    static double starvationProbability(double energy, unsigned int resourceCount);
+
+    /// @brief Computes the energy gained in the maintenance phase by an individual that does not
+    ///   starve, from its raw state.
+    /// @param energy Energy of the individual.
+    /// @param resourceCount Resource units accumulated by the individual.
+    /// @return Surplus energy the individual can use to grow (zero if the resources did not
+    ///   cover the maintenance cost).
+    static double survivalSurplus(double energy, unsigned int resourceCount);
+
+    /// @brief Draws the outcome of the maintenance phase from the raw state of an individual.
+    /// @details An individual uses at least half its energy in resources just to survive. If
+    ///   there are not enough resources it might die out of starvation.
+    /// @tparam Generator Random number generator type (FSM::Rng or FSM::CounterRng).
+    /// @param energy Energy of the individual.
+    /// @param resourceCount Resource units accumulated by the individual.
+    /// @param rng Random number generator.
+    /// @return Surplus energy the individual can use to grow (zero if the resources did not
+    ///   cover the maintenance cost) or an empty value if the individual starved to death.
+    template <typename Generator>
+    static std::optional<double> maintenanceSurplus(double energy, unsigned int resourceCount,
+        Generator& rng);
+
     /// @brief Name of the main XML node for this class.
     static constexpr char XML_MAIN_NODE_NAME[]{"Individual"};
 
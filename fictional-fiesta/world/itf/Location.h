@@ -6,6 +6,8 @@
 
 #include "fictional-fiesta/world/itf/FSM.h"
 #include "fictional-fiesta/world/itf/Individual.h"
+#include "fictional-fiesta/world/itf/PopulationStore.h"
+#include "fictional-fiesta/world/itf/ResourceSplitter.h"
 
 #include <memory>
 #include <vector>
@@ -13,9 +15,12 @@
 namespace fictionalfiesta
 {
 
+class BinaryReader;
+class BinaryWriter;
 class Individual;
 class Source;
 class XmlNode;
+class XmlStreamReader;
 
 /// @brief Class that represents a location in the world.
 /// @details A location has a set of Sources.
@@ -31,6 +36,20 @@ class Location : public XmlSavable, public Descriptable
     /// @param node XmlNode with the class contents.
     Location(const XmlNode& node);
 
+    /// @brief Constructor from a binary snapshot.
+    /// @param reader Reader of a snapshot positioned at a location written by
+    ///   save(BinaryWriter&).
+    explicit Location(BinaryReader& reader);
+
+    /// @brief Constructor from a XML stream.
+    /// @details The individuals are added to the population while they are read. With several
+    ///   threads and a reader of a file, they are only skipped by the reader instead, and parsed
+    ///   in parallel from the byte ranges of their chunks of CHUNK_SIZE individuals.
+    /// @param reader Reader positioned at the location element, read up to its end.
+    /// @param threadCount Number of threads used to parse the individuals. Zero means one per
+    ///   hardware thread.
+    explicit Location(XmlStreamReader& reader, unsigned int threadCount = 1);
+
     /// @brief Move constructor.
     /// @param other Instance to be moved.
     Location(Location&& other);
@@ -51,6 +70,32 @@ class Location : public XmlSavable, public Descriptable
     /// @param rng Random number generator.
     void splitResources(FSM::Rng& rng);
 
+    /// @brief Sets the strategy used to split the resources between individuals.
+    /// @param mode Resource split mode.
+    void setResourceSplitMode(ResourceSplitter::Mode mode);
+
+    /// @brief Gets the strategy used to split the resources between individuals.
+    /// @return Resource split mode.
+    ResourceSplitter::Mode getResourceSplitMode() const;
+
+    /// @brief Sets whether the resources are split in parallel shards of the population.
+    /// @details The shards use the resource split mode and the thread count of the location.
+    /// @param sharded @e true to use ResourceSplitter::splitSharded and @e false to use
+    ///   ResourceSplitter::split.
+    void setShardedResourceSplit(bool sharded);
+
+    /// @brief Checks whether the resources are split in parallel shards of the population.
+    /// @return @e true if ResourceSplitter::splitSharded is used and @e false otherwise.
+    bool isShardedResourceSplit() const;
+
+    /// @brief Sets the number of threads used in the maintenance and reproduction phases.
+    /// @param threadCount Number of threads. Zero means one per hardware thread.
+    void setThreadCount(unsigned int threadCount);
+
+    /// @brief Gets the number of threads used in the maintenance and reproduction phases.
+    /// @return Number of threads. Zero means one per hardware thread.
+    unsigned int getThreadCount() const;
+
     /// @brief Add a new source to the location.
     /// @details It transfers the ownership of the source to the location.
     /// @param source Source to be added to the location.
@@ -61,8 +106,16 @@ class Location : public XmlSavable, public Descriptable
     void addIndividual(const Individual& individual);
 
     /// @brief Gets the individuals currently in the Location.
+    /// @details The individuals are built from the population store, so prefer getPopulation
+    ///   in performance sensitive code. The individuals killed in the phases are not included.
     /// @return Individuals that are currently in this Location.
-    const std::vector<Individual>& getIndividuals() const;
+    std::vector<Individual> getIndividuals() const;
+
+    /// @brief Gets the population currently in the Location.
+    /// @details The population might contain the tombstones of the individuals killed in the
+    ///   phases until the next call to cleanDeadIndividuals.
+    /// @return Population of this Location, stored as a structure of arrays.
+    const PopulationStore& getPopulation() const;
 
     /// @brief Performs the actions of the resource phase.
     /// @details The resource phase includes spliting resources between individuals and
@@ -72,27 +125,57 @@ class Location : public XmlSavable, public Descriptable
 
     /// @brief Performs the actions of the individual's maintenance phase.
     /// @details The maintenance phase includes the use of energy by the individuals in maintenance
-    ///    and growth.
+    ///    and growth. The population is processed in chunks of CHUNK_SIZE individuals, in
+    ///    parallel, and every individual draws from its own FSM::CounterRng stream, seeded by a
+    ///    single draw of @p rng and keyed by its index, so the results do not depend on the
+    ///    number of threads.
     /// @param rng Random number generator.
     void maintenancePhase(FSM::Rng& rng);
 
     /// @brief Performs the actions of the individual's reproduction phase.
+    /// @details The chunks of parents reproduce in parallel, with per-individual streams as in
+    ///   maintenancePhase, in two passes. The first one decides which individuals reproduce and
+    ///   counts the births of every chunk; then the population is grown once, and the second
+    ///   pass writes the offspring of every chunk in place, after the ones of the previous
+    ///   chunks. So the result does not depend on the number of threads either. The plans of the
+    ///   chunks are kept between calls, so in steady state the phase does not allocate memory.
     /// @param rng Random number generator.
     void reproductionPhase(FSM::Rng& rng);
 
     /// @brief Removes the dead individuals from the individuals list.
+    /// @details The phases do not remove the individuals they kill: they are kept as tombstones
+    ///   (dead individuals that are skipped by the following phases and hidden from
+    ///   getIndividuals) until this method compacts the population.
     void cleanDeadIndividuals();
 
+    /// @brief Estimates the relative cost of the next cycle.
+    /// @details Product of the number of individuals and the resource units available, i.e. the
+    ///   state left by the previous cycle. Sources with infinite units count as one unit, since
+    ///   they are split in closed form.
+    /// @return Cost hint of the next cycle (only meaningful compared with other locations).
+    double getCostHint() const;
+
     /// @brief Performs a full cycle.
+    /// @details The population is compacted once, at the end of the cycle.
     /// @param rng Random number generator.
     void cycle(FSM::Rng& rng);
 
     /// @copydoc Descriptable::str
     std::string str(unsigned int indentLevel) const override;
 
+    using XmlSavable::save;
+
+    /// @brief Saves the location in a binary snapshot: its sources and its population.
+    /// @details As in XML, the tombstones are not saved and neither are the settings.
+    /// @param writer Writer of the snapshot.
+    void save(BinaryWriter& writer) const;
+
     /// @brief Name of the main XML node for this class.
     static constexpr char XML_MAIN_NODE_NAME[]{"Location"};
 
+    /// Number of individuals processed as a single task in the parallel phases.
+    static constexpr std::size_t CHUNK_SIZE{4096};
+
   private:
 
     /// @brief Swaps the contents of this instance with the one passed per parameter.
@@ -105,8 +188,33 @@ class Location : public XmlSavable, public Descriptable
     /// @copydoc XmlSavable::getDefaultXmlName
     virtual std::string getDefaultXmlName() const override;
 
+    /// @brief Checks whether the individual at a given index is a tombstone.
+    /// @param index Index of the individual in the population.
+    /// @return @e true if the individual died in a phase and has not been removed yet.
+    bool isTombstone(std::size_t index) const;
+
     std::vector<std::unique_ptr<Source>> _sources;
-    std::vector<Individual> _individuals;
+    PopulationStore _population;
+
+    /// Strategy used to split the resources between individuals.
+    ResourceSplitter::Mode _resourceSplitMode = ResourceSplitter::Mode::Unit;
+
+    /// Whether the resources are split in parallel shards of the population.
+    bool _shardedResourceSplit = false;
+
+    /// Number of threads used in the maintenance and reproduction phases.
+    unsigned int _threadCount = 1;
+
+    /// Reproduction plans of each chunk in the last reproduction phase. Only kept to reuse the
+    /// memory.
+    std::vector<PopulationStore::ReproductionPlan> _reproductionPlans;
+
+    /// Index of the first offspring of each chunk in the last reproduction phase.
+    std::vector<std::size_t> _birthOffsets;
+
+    /// Whether a phase has run since the last compaction, so the dead individuals in the
+    /// population are tombstones.
+    bool _hasTombstones = false;
 };
 
 } // namespace fictionalfiesta
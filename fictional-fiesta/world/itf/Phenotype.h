@@ -12,6 +12,7 @@ namespace fictionalfiesta
 
 class Genotype;
 class XmlNode;
+class XmlStreamReader;
 
 /// @brief Class that represents the set of features that are the expression of the genotype
 ///     in an individual.
@@ -27,6 +28,10 @@ class Phenotype : public Descriptable, public XmlSavable
     /// @param node XML node from which to construct the Phenotype.
     explicit Phenotype(const XmlNode& node);
 
+    /// @brief Constructor from a XML stream.
+    /// @param reader Reader positioned at the phenotype element, read up to its end.
+    explicit Phenotype(XmlStreamReader& reader);
+
     /// @brief Gets the current energy level.
     /// @return Current energy level.
     double getEnergy() const;
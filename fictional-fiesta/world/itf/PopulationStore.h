@@ -0,0 +1,345 @@
+#ifndef INCLUDE_FICTIONAL_FIESTA_WORLD_POPULATION_STORE_H
+#define INCLUDE_FICTIONAL_FIESTA_WORLD_POPULATION_STORE_H
+
+#include "fictional-fiesta/world/itf/FSM.h"
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fictionalfiesta
+{
+
+class BinaryReader;
+class BinaryWriter;
+class Genotype;
+class Individual;
+
+/// @brief Class that stores a population of individuals as a structure of arrays.
+/// @details Each field of the individuals is kept in its own contiguous column, so the loops
+///   of the cycle phases only touch the memory of the fields they use (and the compiler can
+///   vectorize them). Individual instances can still be added and retrieved, but they are
+///   built on demand.
+///   If FICTIONAL_FIESTA_COMPACT_POPULATION is defined (CMake option of the same name), the
+///   genotype traits are stored in single precision and the dead flags are packed in bits.
+///   The per-index methods (feed, die, performMaintenance, reproduce...) only touch the given
+///   index, so they can be called concurrently on disjoint ranges of indices as long as the
+///   ranges start at multiples of DEAD_FLAG_ALIGNMENT (the packed flags share words).
+class PopulationStore
+{
+  public:
+
+#ifdef FICTIONAL_FIESTA_COMPACT_POPULATION
+    /// Type used to store the genotype traits.
+    using Trait = float;
+
+    /// Type of the dead flag column.
+    using DeadFlags = std::vector<bool>;
+
+    /// Bytes used to store a dead flag.
+    static constexpr double DEAD_FLAG_BYTES{1.0 / CHAR_BIT};
+#else
+    /// Type used to store the genotype traits.
+    using Trait = double;
+
+    /// Type of the dead flag column. Not a std::vector<bool> so the loops over it can be
+    /// vectorized.
+    using DeadFlags = std::vector<unsigned char>;
+
+    /// Bytes used to store a dead flag.
+    static constexpr double DEAD_FLAG_BYTES{1.0};
+#endif
+
+    /// Number of indices whose dead flags can share memory. Ranges of indices processed
+    /// concurrently must start at multiples of it.
+    static constexpr std::size_t DEAD_FLAG_ALIGNMENT{64};
+
+    /// Bytes used to store an individual: three traits, the energy, the resource count and the
+    /// dead flag.
+    static constexpr double BYTES_PER_INDIVIDUAL{3 * sizeof(Trait) + sizeof(double) +
+        sizeof(unsigned int) + DEAD_FLAG_BYTES};
+
+    /// @brief Default constructor. Creates an empty population.
+    PopulationStore() = default;
+
+    /// @brief Constructor from a binary snapshot.
+    /// @details Each column is copied at once from the mapping of the file (and converted in the
+    ///   compact build); nothing is parsed per individual.
+    /// @param reader Reader of a snapshot positioned at a population written by
+    ///   save(BinaryWriter&).
+    explicit PopulationStore(BinaryReader& reader);
+
+    /// @brief Gets the number of individuals (dead or alive) in the population.
+    /// @return Number of individuals.
+    std::size_t size() const noexcept;
+
+    /// @brief Gets the number of dead individuals in the population.
+    /// @details The dead flags are counted on every call.
+    /// @return Number of dead individuals.
+    std::size_t getDeadCount() const noexcept;
+
+    /// @brief Checks whether the population has no individuals.
+    /// @return @e true if there are no individuals and @e false otherwise.
+    bool empty() const noexcept;
+
+    /// @brief Reserves memory for a given number of individuals.
+    /// @param capacity Number of individuals to reserve memory for.
+    void reserve(std::size_t capacity);
+
+    /// @brief Gets the number of individuals that fit in the reserved memory.
+    /// @return Capacity of the columns.
+    std::size_t capacity() const noexcept;
+
+    /// @brief Removes all the individuals, keeping the reserved memory.
+    void clear() noexcept;
+
+    /// @brief Changes the number of individuals.
+    /// @details The individuals added are alive, with no resources and with zero traits and
+    ///   energy: they are meant to be overwritten, e.g. by reproduce(const ReproductionPlan&,
+    ///   std::uint64_t, PopulationStore&, std::size_t).
+    /// @param size New number of individuals.
+    void resize(std::size_t size);
+
+    /// @brief Gets the memory reserved by the columns.
+    /// @return Number of bytes reserved for the individuals.
+    std::size_t getMemoryUsage() const noexcept;
+
+    /// @brief Adds an individual at the end of the population.
+    /// @param individual Individual to be added.
+    void addIndividual(const Individual& individual);
+
+    /// @brief Adds all the individuals of another population at the end of this one.
+    /// @param other Population whose individuals are added, in order.
+    void append(const PopulationStore& other);
+
+    /// @brief Builds the individual at a given index.
+    /// @param index Index of the individual.
+    /// @return Individual at the given index.
+    Individual getIndividual(std::size_t index) const;
+
+    /// @brief Overwrites the individual at a given index.
+    /// @param index Index of the individual.
+    /// @param individual Individual to be written.
+    void setIndividual(std::size_t index, const Individual& individual);
+
+    /// @brief Builds all the individuals of the population.
+    /// @return Individuals in the population, in order.
+    std::vector<Individual> getIndividuals() const;
+
+    /// @brief Builds the genotype of the individual at a given index.
+    /// @param index Index of the individual.
+    /// @return Genotype of the individual.
+    Genotype getGenotype(std::size_t index) const;
+
+    /// @brief Gets the energy of the individual at a given index.
+    /// @param index Index of the individual.
+    /// @return Energy of the individual.
+    double getEnergy(std::size_t index) const;
+
+    /// @brief Gets the resource units accumulated by the individual at a given index.
+    /// @param index Index of the individual.
+    /// @return Resource units of the individual.
+    unsigned int getResourceCount(std::size_t index) const;
+
+    /// @brief Checks whether the individual at a given index is dead.
+    /// @param index Index of the individual.
+    /// @return @e true if the individual is dead and @e false if not.
+    bool isDead(std::size_t index) const;
+
+    /// @brief Checks whether the individual at a given index is hungry.
+    /// @param index Index of the individual.
+    /// @return @e true if the individual is hungry and @e false if not.
+    bool isHungry(std::size_t index) const;
+
+    /// @copydoc Individual::getUnitsToSatiety
+    /// @param index Index of the individual.
+    unsigned int getUnitsToSatiety(std::size_t index) const;
+
+    /// @brief The individual at a given index consumes @p units of resource.
+    /// @param index Index of the individual.
+    /// @param units Number of resource units consumed.
+    void feed(std::size_t index, unsigned int units);
+
+    /// @brief Kills the individual at a given index.
+    /// @param index Index of the individual.
+    void die(std::size_t index);
+
+    /// @copydoc Individual::performMaintenance
+    /// @tparam Generator Random number generator type (FSM::Rng or FSM::CounterRng).
+    /// @param index Index of the individual.
+    template <typename Generator>
+    void performMaintenance(std::size_t index, Generator& rng);
+
+    /// @brief The living individuals in a range of indices perform their maintenance.
+    /// @details Batched version of performMaintenance(std::size_t, Generator&): the individual
+    ///   at @e index draws from the stream FSM::createStream(seed, {index}), but the starvation
+    ///   variates of FSM::StreamBatch::SIZE individuals are drawn at once with integer
+    ///   thresholds. The dead individuals are skipped.
+    /// @param begin First index of the range.
+    /// @param end Index past the last one of the range.
+    /// @param seed Seed of the streams of the individuals.
+    void performMaintenance(std::size_t begin, std::size_t end, std::uint64_t seed);
+
+    /// @copydoc Individual::willReproduce
+    /// @tparam Generator Random number generator type (FSM::Rng or FSM::CounterRng).
+    /// @param index Index of the individual.
+    template <typename Generator>
+    bool willReproduce(std::size_t index, Generator& rng) const;
+
+    /// @brief The individual at a given index reproduces, appending its offspring at the end of
+    ///   the population.
+    /// @details Same draws as Individual::reproduce, but the offspring is written directly into
+    ///   the columns, and only if it is not stillborn. Indices are stable, although references
+    ///   to the columns might be invalidated unless enough capacity was reserved.
+    /// @tparam Generator Random number generator type (FSM::Rng or FSM::CounterRng).
+    /// @param index Index of the parent.
+    /// @param rng Random number generator.
+    /// @return @e true if a living offspring was appended and @e false if it was stillborn.
+    template <typename Generator>
+    bool reproduce(std::size_t index, Generator& rng);
+
+    /// @brief The individual at a given index reproduces, appending its offspring to another
+    ///   population.
+    /// @details Same as reproduce(std::size_t, Generator&), but only the energy of the parent is
+    ///   written in this population, so several parents can reproduce concurrently into
+    ///   different offspring populations.
+    /// @tparam Generator Random number generator type (FSM::Rng or FSM::CounterRng).
+    /// @param index Index of the parent.
+    /// @param rng Random number generator.
+    /// @param offspring Population where the offspring is appended.
+    /// @return @e true if a living offspring was appended and @e false if it was stillborn.
+    template <typename Generator>
+    bool reproduce(std::size_t index, Generator& rng, PopulationStore& offspring);
+
+    /// @brief Decisions of the batched reproduction of a range of individuals.
+    /// @details Filled by planReproduction and carried out by reproduce(const ReproductionPlan&,
+    ///   std::uint64_t, PopulationStore&, std::size_t). Its memory is kept between uses.
+    struct ReproductionPlan
+    {
+      /// Indices of the individuals that reproduce, in order.
+      std::vector<std::size_t> parents;
+
+      /// Whether the offspring of every parent is stillborn (deadly mutation).
+      std::vector<unsigned char> stillborn;
+
+      /// Number of living offspring.
+      std::size_t birthCount{0};
+    };
+
+    /// @brief The living individuals in a range of indices that pass their reproduction draw
+    ///   reproduce, appending their offspring to another population.
+    /// @details Batched version of willReproduce and reproduce(std::size_t, Generator&,
+    ///   PopulationStore&): the individual at @e index draws from the stream
+    ///   FSM::createStream(seed, {index}). The reproduction variates of FSM::StreamBatch::SIZE
+    ///   individuals are drawn at once with integer thresholds, and only the parents continue
+    ///   their own stream for the mutations. The normal variates of all the parents of a batch
+    ///   are transformed at once (FSM::NormalGenerator::transform). As in Genotype::reproduce,
+    ///   the fourth normal variate of every parent is dropped, since it comes from the stream of
+    ///   that parent. Same as planReproduction followed by reproduce(const ReproductionPlan&,
+    ///   std::uint64_t, PopulationStore&, std::size_t).
+    /// @param begin First index of the range.
+    /// @param end Index past the last one of the range.
+    /// @param seed Seed of the streams of the individuals.
+    /// @param offspring Population where the offspring are appended, in order of their parents.
+    void reproduce(std::size_t begin, std::size_t end, std::uint64_t seed,
+        PopulationStore& offspring);
+
+    /// @brief Draws which living individuals in a range reproduce, and which of their offspring
+    ///   are stillborn.
+    /// @details First step of reproduce(std::size_t, std::size_t, std::uint64_t,
+    ///   PopulationStore&). Nothing is written, so the births of several ranges can be counted
+    ///   before any offspring is written.
+    /// @param begin First index of the range.
+    /// @param end Index past the last one of the range.
+    /// @param seed Seed of the streams of the individuals.
+    /// @param plan Plan where the decisions are written.
+    /// @return Number of living offspring.
+    std::size_t planReproduction(std::size_t begin, std::size_t end, std::uint64_t seed,
+        ReproductionPlan& plan) const;
+
+    /// @brief The parents of a plan reproduce, writing their living offspring at consecutive
+    ///   indices of a population.
+    /// @details Second step of reproduce(std::size_t, std::size_t, std::uint64_t,
+    ///   PopulationStore&): the mutation variates are drawn again from the streams of the
+    ///   parents. Only the energies of the parents and the traits and energies of the offspring
+    ///   are written, so the plans of disjoint ranges can be carried out concurrently, even into
+    ///   this same population.
+    /// @param plan Plan filled by planReproduction with the same seed.
+    /// @param seed Seed of the streams of the individuals.
+    /// @param offspring Population where the offspring are written. Its individuals from
+    ///   @p offset on must be alive and without resources, as left by resize.
+    /// @param offset Index of the first offspring.
+    void reproduce(const ReproductionPlan& plan, std::uint64_t seed, PopulationStore& offspring,
+        std::size_t offset);
+
+    /// @brief Saves the population in a binary snapshot.
+    /// @details The size is followed by the columns, in the order of the members, as aligned
+    ///   arrays: the traits and the energies as doubles, the resource counts as 32-bit
+    ///   unsigned integers and the dead flags as bytes. The format is the same whether the
+    ///   build is compact or not.
+    /// @param writer Writer of the snapshot.
+    void save(BinaryWriter& writer) const;
+
+    /// @brief Saves the living individuals of the population in a binary snapshot.
+    /// @details Same output as save after removeDead, but the columns are filtered while they
+    ///   are written, so the population is neither modified nor copied.
+    /// @param writer Writer of the snapshot.
+    void saveLiving(BinaryWriter& writer) const;
+
+    /// @brief Removes the dead individuals keeping the order of the living ones.
+    /// @details Every column is compacted in a single pass. Nothing else is done if there are no
+    ///   dead individuals.
+    void removeDead();
+
+    /// @brief Gets the energy column.
+    /// @return Energies of all the individuals, in order.
+    const std::vector<double>& getEnergies() const noexcept;
+
+    /// @brief Gets the resource count column.
+    /// @return Resource units of all the individuals, in order.
+    const std::vector<unsigned int>& getResourceCounts() const noexcept;
+
+    /// @brief Gets the dead flag column.
+    /// @return Dead flags (true if dead) of all the individuals, in order.
+    const DeadFlags& getDeadFlags() const noexcept;
+
+  private:
+
+    /// @brief Appends an individual at the end of every column.
+    /// @param genotype Genotype of the individual.
+    /// @param energy Energy of the individual.
+    /// @param resourceCount Resource units accumulated by the individual.
+    /// @param isDead Whether the individual is dead.
+    void append(const Genotype& genotype, double energy, unsigned int resourceCount,
+        bool isDead);
+
+    /// @brief Writes the genotype and the energy of a newborn individual.
+    /// @details The dead flag is not written, so newborns can be written concurrently.
+    /// @param index Index of the individual.
+    /// @param genotype Genotype of the individual.
+    /// @param energy Energy of the individual.
+    void setNewborn(std::size_t index, const Genotype& genotype, double energy);
+
+    /// Reproduction energy thresholds of the genotypes.
+    std::vector<Trait> _reproductionEnergyThresholds;
+
+    /// Reproduction probabilities of the genotypes.
+    std::vector<Trait> _reproductionProbabilities;
+
+    /// Mutability ratios of the genotypes.
+    std::vector<Trait> _mutabilityRatios;
+
+    /// Energies of the phenotypes.
+    std::vector<double> _energies;
+
+    /// Resource units accumulated.
+    std::vector<unsigned int> _resourceCounts;
+
+    /// Dead flags.
+    DeadFlags _deadFlags;
+};
+
+} // namespace fictionalfiesta
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef INCLUDE_FICTIONAL_FIESTA_WORLD_RESOURCE_SPLITTER_H
+#define INCLUDE_FICTIONAL_FIESTA_WORLD_RESOURCE_SPLITTER_H
+
+#include "fictional-fiesta/world/itf/FSM.h"
+
+#include <cstddef>
+#include <string>
+
+namespace fictionalfiesta
+{
+
+class PopulationStore;
+class Source;
+
+/// @brief Static class that splits the units of a source between the individuals competing
+///   for them.
+/// @details Every unit goes to a living hungry individual with a probability proportional to
+///   its energy and the individual can die while feeding. The different modes trade exactness
+///   for speed.
+///   Sources with infinite units are always split in closed form, since there is no competition
+///   for them.
+///   Any split can also be sharded (see splitSharded) to use several threads in a single
+///   population.
+class ResourceSplitter
+{
+  public:
+
+    /// @brief Available allocation strategies.
+    enum class Mode
+    {
+      /// Exact reference strategy: the units are handed out one at a time.
+      Unit,
+      /// All the units are handed out with one multinomial draw per round. Excess units from
+      /// satiated or dead individuals are redistributed in the following rounds.
+      Bulk,
+      /// Like Bulk, but the units of a round are assigned by sweeping a batch of sorted
+      /// uniforms over the cumulative weights of the individuals in a single linear pass.
+      Sweep
+    };
+
+    /// @brief Splits the units of a source between the individuals.
+    /// @param mode Allocation strategy.
+    /// @param source Source whose units will be consumed.
+    /// @param population Individuals competing for the units.
+    /// @param rng Random number generator.
+    static void split(Mode mode, Source& source, PopulationStore& population,
+        FSM::Rng& rng);
+
+    /// @brief Splits the units of a source between the individuals, sharding the population.
+    /// @details The population is divided in shards of SHARD_SIZE individuals. The units are
+    ///   dealt to the shards with a multinomial draw weighted by the energy of their hungry
+    ///   individuals, and then every shard hands out its units with @p mode in parallel, each one
+    ///   with its own random stream. The units that went to individuals that were already
+    ///   satiated or dead are not redistributed within the shard but dealt again between all
+    ///   the shards in the next round, as Bulk does with the individuals, so the split is
+    ///   statistically equivalent to the serial one. The shards do not depend on
+    ///   @p threadCount, so neither do the results.
+    /// @param mode Allocation strategy inside each shard.
+    /// @param source Source whose units will be consumed.
+    /// @param population Individuals competing for the units.
+    /// @param rng Random number generator.
+    /// @param threadCount Maximum number of threads. Zero means one per hardware thread.
+    static void splitSharded(Mode mode, Source& source, PopulationStore& population,
+        FSM::Rng& rng, unsigned int threadCount);
+
+    /// @brief Gets the mode corresponding to a name.
+    /// @param name Name of the mode ("unit", "bulk" or "sweep").
+    /// @return Mode with the given name.
+    /// @throw Exception if there is no mode with the given name.
+    static Mode modeFromString(const std::string& name);
+
+    /// @brief Gets the name of a mode, as read by modeFromString.
+    /// @param mode Mode.
+    /// @return Name of the mode ("unit", "bulk" or "sweep").
+    static std::string modeToString(Mode mode);
+
+    /// Probability that an individual dies while consuming a unit of resource.
+    static constexpr double FEEDING_DEATH_PROBABILITY{0.04};
+
+    /// Number of individuals in each shard of splitSharded.
+    static constexpr std::size_t SHARD_SIZE{4096};
+
+  private:
+
+    /// @brief Splits some units between the individuals in a range of the population.
+    /// @param mode Allocation strategy.
+    /// @param units Units to be split. They cannot be infinite.
+    /// @param population Individuals competing for the units.
+    /// @param begin Index of the first individual of the range.
+    /// @param end Index past the last individual of the range.
+    /// @param redistribute Whether the units that cannot be eaten (because the individual they
+    ///   went to is satiated or dead) are handed out again within the range. If not, they are
+    ///   left for the caller.
+    /// @param rng Random number generator.
+    /// @return Units consumed. If @p redistribute is set, the rest are left only if nobody in
+    ///   the range can eat them.
+    static unsigned int splitRange(Mode mode, unsigned int units, PopulationStore& population,
+        std::size_t begin, std::size_t end, bool redistribute, FSM::Rng& rng);
+
+    /// @brief Hands out the units one at a time.
+    /// @param units Units to be split.
+    /// @param population Individuals competing for the units.
+    /// @param begin Index of the first individual of the range.
+    /// @param end Index past the last individual of the range.
+    /// @param redistribute Whether the units that cannot be eaten (because the individual they
+    ///   went to is satiated or dead) are handed out again within the range. If not, they are
+    ///   left for the caller.
+    /// @param rng Random number generator.
+    /// @return Units consumed.
+    static unsigned int splitUnits(unsigned int units, PopulationStore& population,
+        std::size_t begin, std::size_t end, bool redistribute, FSM::Rng& rng);
+
+    /// @brief Hands out the units in rounds of multinomial draws.
+    /// @param units Units to be split.
+    /// @param population Individuals competing for the units.
+    /// @param begin Index of the first individual of the range.
+    /// @param end Index past the last individual of the range.
+    /// @param redistribute Whether the units that cannot be eaten (because the individual they
+    ///   went to is satiated or dead) are handed out again within the range. If not, they are
+    ///   left for the caller.
+    /// @param rng Random number generator.
+    /// @return Units consumed.
+    static unsigned int splitBulk(unsigned int units, PopulationStore& population,
+        std::size_t begin, std::size_t end, bool redistribute, FSM::Rng& rng);
+
+    /// @brief Hands out the units in rounds of sorted uniform batches.
+    /// @details The sorted uniforms are generated one at a time from the top down, so each
+    ///   round costs O(N + U) in a single backwards pass and needs no extra memory.
+    /// @param units Units to be split.
+    /// @param population Individuals competing for the units.
+    /// @param begin Index of the first individual of the range.
+    /// @param end Index past the last individual of the range.
+    /// @param redistribute Whether the units that cannot be eaten (because the individual they
+    ///   went to is satiated or dead) are handed out again within the range. If not, they are
+    ///   left for the caller.
+    /// @param rng Random number generator.
+    /// @return Units consumed.
+    static unsigned int splitSweep(unsigned int units, PopulationStore& population,
+        std::size_t begin, std::size_t end, bool redistribute, FSM::Rng& rng);
+
+    /// @brief Feeds every hungry individual until it is satiated or dies.
+    /// @details Used for sources with infinite units. The number of units eaten before a feeding
+    ///   death is drawn from its geometric distribution, so the cost is O(N) no matter how
+    ///   hungry the individuals are.
+    /// @param population Individuals competing for the units.
+    /// @param begin Index of the first individual of the range.
+    /// @param end Index past the last individual of the range.
+    /// @param rng Random number generator.
+    static void splitInfinite(PopulationStore& population, std::size_t begin, std::size_t end,
+        FSM::Rng& rng);
+};
+
+} // namespace fictionalfiesta
+
+#endif
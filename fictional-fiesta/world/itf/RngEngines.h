@@ -0,0 +1,234 @@
+#ifndef INCLUDE_FICTIONAL_FIESTA_WORLD_RNG_ENGINES_H
+#define INCLUDE_FICTIONAL_FIESTA_WORLD_RNG_ENGINES_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+
+namespace fictionalfiesta
+{
+
+/// @brief xoshiro256++ random number engine (Blackman and Vigna).
+/// @details 64-bit outputs from 32 bytes of state, with a few additions, shifts and rotations
+///   per value. It models UniformRandomBitGenerator and can be seeded like the standard engines.
+class Xoshiro256PlusPlus
+{
+  public:
+
+    /// Type of the generated values.
+    using result_type = std::uint64_t;
+
+    /// Seed used by the default constructor.
+    static constexpr result_type DEFAULT_SEED{5489u};
+
+    /// @brief Constructor from a seed.
+    /// @details The state is filled with SplitMix64 outputs of the seed, as recommended by the
+    ///   authors, so similar seeds give unrelated states.
+    /// @param seed Seed of the engine.
+    explicit Xoshiro256PlusPlus(result_type seed = DEFAULT_SEED) noexcept;
+
+    /// @brief Constructor from a seed sequence.
+    /// @tparam SeedSeq Type of the seed sequence (e.g. std::seed_seq).
+    /// @param sequence Seed sequence that fills the state.
+    template <typename SeedSeq, typename = std::enable_if_t<!std::is_arithmetic_v<SeedSeq>>>
+    explicit Xoshiro256PlusPlus(SeedSeq& sequence);
+
+    /// @brief Generates the next value.
+    /// @return Uniformly distributed value in [min(), max()].
+    result_type operator()() noexcept;
+
+    /// @brief Skips values.
+    /// @param count Number of values to be skipped.
+    void discard(unsigned long long count) noexcept;
+
+    /// @brief Minimum value generated.
+    /// @return Minimum value.
+    static constexpr result_type min() noexcept { return 0; }
+
+    /// @brief Maximum value generated.
+    /// @return Maximum value.
+    static constexpr result_type max() noexcept { return UINT64_MAX; }
+
+    /// @brief Checks whether two engines have the same state.
+    /// @param other Engine to compare with.
+    /// @return @e true if both engines will generate the same values and @e false otherwise.
+    bool operator==(const Xoshiro256PlusPlus& other) const noexcept;
+
+    /// @brief Checks whether two engines have different states.
+    /// @param other Engine to compare with.
+    /// @return @e true if the engines will generate different values and @e false otherwise.
+    bool operator!=(const Xoshiro256PlusPlus& other) const noexcept;
+
+    /// @brief Writes the state of an engine as text, like the standard engines.
+    /// @param stream Stream where the state is written.
+    /// @param engine Engine whose state is written.
+    /// @return The stream.
+    friend std::ostream& operator<<(std::ostream& stream, const Xoshiro256PlusPlus& engine);
+
+    /// @brief Reads the state of an engine written by operator<<.
+    /// @details The engine is left unchanged and the failbit is set if the state is not valid.
+    /// @param stream Stream where the state is read from.
+    /// @param engine Engine whose state is read.
+    /// @return The stream.
+    friend std::istream& operator>>(std::istream& stream, Xoshiro256PlusPlus& engine);
+
+  private:
+
+    /// @brief Makes sure that the state is valid (not all zeros).
+    void fixState() noexcept;
+
+    /// Engine state.
+    std::array<std::uint64_t, 4> _state;
+};
+
+/// @brief PCG64 random number engine (O'Neill's pcg64: XSL RR output of a 128-bit LCG).
+/// @details 64-bit outputs from a 128-bit linear congruential state with a selectable stream.
+///   It models UniformRandomBitGenerator and can be seeded like the standard engines.
+class Pcg64
+{
+  public:
+
+    /// Type of the generated values.
+    using result_type = std::uint64_t;
+
+    /// Seed used by the default constructor.
+    static constexpr result_type DEFAULT_SEED{5489u};
+
+    /// @brief Constructor from a seed, in the default stream.
+    /// @param seed Seed of the engine.
+    explicit Pcg64(result_type seed = DEFAULT_SEED) noexcept;
+
+    /// @brief Constructor from a seed and a stream, as the reference pcg64(seed, stream).
+    /// @param seed Seed of the engine.
+    /// @param stream Index of the stream (sequence) of the engine.
+    Pcg64(result_type seed, result_type stream) noexcept;
+
+    /// @brief Constructor from a seed sequence.
+    /// @details The sequence sets both the seed and the stream.
+    /// @tparam SeedSeq Type of the seed sequence (e.g. std::seed_seq).
+    /// @param sequence Seed sequence that fills the state.
+    template <typename SeedSeq, typename = std::enable_if_t<!std::is_arithmetic_v<SeedSeq>>>
+    explicit Pcg64(SeedSeq& sequence);
+
+    /// @brief Generates the next value.
+    /// @return Uniformly distributed value in [min(), max()].
+    result_type operator()() noexcept;
+
+    /// @brief Skips values.
+    /// @param count Number of values to be skipped.
+    void discard(unsigned long long count) noexcept;
+
+    /// @brief Minimum value generated.
+    /// @return Minimum value.
+    static constexpr result_type min() noexcept { return 0; }
+
+    /// @brief Maximum value generated.
+    /// @return Maximum value.
+    static constexpr result_type max() noexcept { return UINT64_MAX; }
+
+    /// @brief Checks whether two engines have the same state.
+    /// @param other Engine to compare with.
+    /// @return @e true if both engines will generate the same values and @e false otherwise.
+    bool operator==(const Pcg64& other) const noexcept;
+
+    /// @brief Checks whether two engines have different states.
+    /// @param other Engine to compare with.
+    /// @return @e true if the engines will generate different values and @e false otherwise.
+    bool operator!=(const Pcg64& other) const noexcept;
+
+    /// @brief Writes the state of an engine as text, like the standard engines.
+    /// @details The 128-bit state and increment are written as pairs of 64-bit halves.
+    /// @param stream Stream where the state is written.
+    /// @param engine Engine whose state is written.
+    /// @return The stream.
+    friend std::ostream& operator<<(std::ostream& stream, const Pcg64& engine);
+
+    /// @brief Reads the state of an engine written by operator<<.
+    /// @details The engine is left unchanged and the failbit is set if the state is not valid.
+    /// @param stream Stream where the state is read from.
+    /// @param engine Engine whose state is read.
+    /// @return The stream.
+    friend std::istream& operator>>(std::istream& stream, Pcg64& engine);
+
+  private:
+
+    /// 128-bit unsigned integer (GCC and Clang extension).
+    __extension__ typedef unsigned __int128 State;
+
+    /// @brief Seeds the engine as the reference implementation does.
+    /// @param seed 128-bit seed.
+    /// @param stream 128-bit stream index.
+    void seed(State seed, State stream) noexcept;
+
+    /// LCG state.
+    State _state;
+
+    /// LCG increment (odd), which selects the stream.
+    State _increment;
+};
+
+// The engines are called once per variate, so their generation step is inlined.
+
+template <typename SeedSeq, typename>
+Xoshiro256PlusPlus::Xoshiro256PlusPlus(SeedSeq& sequence)
+{
+  std::array<std::uint32_t, 8> words;
+  sequence.generate(words.begin(), words.end());
+  for (std::size_t index = 0; index < _state.size(); ++index)
+  {
+    _state[index] = (static_cast<std::uint64_t>(words[2 * index + 1]) << 32) | words[2 * index];
+  }
+  fixState();
+}
+
+inline Xoshiro256PlusPlus::result_type Xoshiro256PlusPlus::operator()() noexcept
+{
+  const auto rotate = [](std::uint64_t value, int bits)
+  {
+    return (value << bits) | (value >> (64 - bits));
+  };
+
+  const auto result = rotate(_state[0] + _state[3], 23) + _state[0];
+  const auto shifted = _state[1] << 17;
+  _state[2] ^= _state[0];
+  _state[3] ^= _state[1];
+  _state[1] ^= _state[2];
+  _state[0] ^= _state[3];
+  _state[2] ^= shifted;
+  _state[3] = rotate(_state[3], 45);
+  return result;
+}
+
+template <typename SeedSeq, typename>
+Pcg64::Pcg64(SeedSeq& sequence)
+{
+  std::array<std::uint32_t, 8> words;
+  sequence.generate(words.begin(), words.end());
+  State seed_value = 0;
+  State stream = 0;
+  for (std::size_t index = 0; index < 4; ++index)
+  {
+    seed_value = (seed_value << 32) | words[index];
+    stream = (stream << 32) | words[index + 4];
+  }
+  seed(seed_value, stream);
+}
+
+inline Pcg64::result_type Pcg64::operator()() noexcept
+{
+  constexpr auto multiplier =
+      (static_cast<State>(2549297995355413924ULL) << 64) | 4865540595714422341ULL;
+  _state = _state * multiplier + _increment;
+
+  // XSL RR output: xor of both halves, rotated by the top six bits.
+  const auto value = static_cast<std::uint64_t>(_state >> 64) ^ static_cast<std::uint64_t>(_state);
+  const auto bits = static_cast<unsigned int>(_state >> 122);
+  return (value >> bits) | (value << ((64 - bits) & 63));
+}
+
+} // namespace fictionalfiesta
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef INCLUDE_FICTIONAL_FIESTA_WORLD_SNAPSHOT_H
+#define INCLUDE_FICTIONAL_FIESTA_WORLD_SNAPSHOT_H
+
+#include <experimental/filesystem>
+
+#include <cstdint>
+
+namespace fictionalfiesta
+{
+
+class Checkpoint;
+class World;
+
+/// @brief Class that saves and loads worlds and checkpoints in the binary snapshot format.
+/// @details A snapshot starts with a header: the magic bytes MAGIC, a byte order mark, the
+///   format VERSION and the content (world or checkpoint). A checkpoint then has its cycle
+///   count, the name and the state of its random number engine and the resource split settings
+///   of its world (mode name and sharding flag). The world follows: its locations, each one
+///   with its sources and its population (see PopulationStore::save). The population columns
+///   are raw arrays aligned in the file, so they are not parsed when loading: the file is
+///   mapped in memory (BinaryReader) and each column is copied at once. Snapshots are written
+///   in the native byte order and are meant for checkpointing on the same kind of machine; XML
+///   stays the interchange format.
+class Snapshot
+{
+  public:
+
+    /// @brief Saves a world in a snapshot.
+    /// @param world World to be saved.
+    /// @param filePath Path of the snapshot file.
+    /// @throw fictionalfiesta::Exception if the file cannot be written.
+    static void save(const World& world, const std::experimental::filesystem::path& filePath);
+
+    /// @brief Saves a checkpoint in a snapshot.
+    /// @param checkpoint Checkpoint to be saved.
+    /// @param filePath Path of the snapshot file.
+    /// @throw fictionalfiesta::Exception if the file cannot be written.
+    static void save(const Checkpoint& checkpoint,
+        const std::experimental::filesystem::path& filePath);
+
+    /// @brief Checks whether a file is a snapshot (starts with MAGIC) or not (e.g. XML).
+    /// @param filePath Path of the file.
+    /// @return @e true if the file is a snapshot and @e false otherwise.
+    static bool isSnapshot(const std::experimental::filesystem::path& filePath);
+
+    /// @brief Checks whether a snapshot holds a checkpoint or only a world.
+    /// @param filePath Path of the snapshot.
+    /// @return @e true if the snapshot holds a checkpoint and @e false if it holds a world.
+    /// @throw fictionalfiesta::Exception if the file is not a valid snapshot, or was written
+    ///   with another version or byte order.
+    static bool isCheckpoint(const std::experimental::filesystem::path& filePath);
+
+    /// @brief Loads a world from a snapshot.
+    /// @param filePath Path of a world or a checkpoint snapshot (its world is loaded).
+    /// @return World loaded.
+    /// @throw fictionalfiesta::Exception if the file is not a valid snapshot, or was written
+    ///   with another version or byte order.
+    static World loadWorld(const std::experimental::filesystem::path& filePath);
+
+    /// @brief Loads a checkpoint from a snapshot.
+    /// @param filePath Path of a checkpoint snapshot.
+    /// @return Checkpoint loaded.
+    /// @throw fictionalfiesta::Exception if the file is not a valid checkpoint snapshot, or was
+    ///   written with another version, byte order or random number engine.
+    static Checkpoint loadCheckpoint(const std::experimental::filesystem::path& filePath);
+
+    /// Bytes that start every snapshot.
+    static constexpr char MAGIC[]{"FFSNAPSH"};
+
+    /// Version of the format. Increased on every incompatible change.
+    static constexpr std::uint32_t VERSION{1};
+};
+
+} // namespace fictionalfiesta
+
+#endif
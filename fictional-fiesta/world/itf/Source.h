@@ -10,6 +10,8 @@
 namespace fictionalfiesta
 {
 
+class BinaryReader;
+class BinaryWriter;
 class XmlNode;
 
 /// @brief Class that represents a source that generates a given resource.
@@ -27,6 +29,11 @@ class Source : public Descriptable
     /// @param initialUnitCount Inital number of units of the resource available.
     Source(const XmlNode& node, unsigned int initialUnitCount);
 
+    /// @brief Constructor from a BinaryReader, after the type of the source.
+    /// @param reader Reader of a snapshot positioned at the contents written by
+    ///   save(BinaryWriter&) after the type.
+    explicit Source(BinaryReader& reader);
+
     /// @brief Default destructor.
     virtual ~Source() = default;
 
@@ -34,6 +41,10 @@ class Source : public Descriptable
     /// @return Owning pointer to the cloned Source.
     std::unique_ptr<Source> clone() const;
 
+    /// @brief Get the type of the source.
+    /// @return Type of the source, as in its XML type attribute.
+    virtual std::string getType() const = 0;
+
     /// @brief Get the resource identifier.
     /// @return Resource identifier.
     const std::string& getResourceId() const;
@@ -60,6 +71,12 @@ class Source : public Descriptable
     /// @param node node where the Source instance will be saved.
     void save(XmlNode node) const;
 
+    /// @brief Save this Source instance in a binary snapshot.
+    /// @details The type goes first, so SourceFactory can create the right derived class.
+    /// @note This class uses NVI-idiom to call the specific saves of the derived classes.
+    /// @param writer Writer of the snapshot.
+    void save(BinaryWriter& writer) const;
+
     /// Representation of an infinity number of units.
     static constexpr unsigned int INFINITY_UNITS{std::numeric_limits<unsigned int>::max()};
 
@@ -80,12 +97,23 @@ class Source : public Descriptable
     /// @return string representing the units.
     static std::string unitsToString(unsigned int units);
 
+    /// @brief Reads the units from the text of a node.
+    /// @details Both "infinite" (as written by unitsToString) and "infinity" are read as
+    ///   INFINITY_UNITS. Any other text is parsed as the other numbers of the document, so
+    ///   the surrounding white spaces are allowed.
+    /// @param node Node whose text represents the units.
+    /// @return Number of units.
+    /// @throw Exception if the node has no text or it is not a number of units.
+    static unsigned int unitsFromNode(const XmlNode& node);
+
   private:
 
     virtual Source* doClone() const = 0;
 
     virtual void doSave(XmlNode& node) const = 0;
 
+    virtual void doSave(BinaryWriter& writer) const = 0;
+
     std::string _resourceId;
 
     unsigned int _currentUnitCount;
@@ -6,8 +6,10 @@
 namespace fictionalfiesta
 {
 
+class BinaryReader;
 class Source;
 class XmlNode;
+class XmlStreamReader;
 
 /// @brief Factory class to create sources.
 class SourceFactory
@@ -18,6 +20,19 @@ class SourceFactory
     /// @param node XML node with the source contents.
     /// @return owner pointer to the created source.
     static std::unique_ptr<Source> createSource(const XmlNode& node);
+
+    /// @brief Creates a source from a binary snapshot.
+    /// @param reader Reader of a snapshot positioned at a source written by
+    ///   Source::save(BinaryWriter&).
+    /// @return owner pointer to the created source.
+    static std::unique_ptr<Source> createSource(BinaryReader& reader);
+
+    /// @brief Creates a source from a XML stream.
+    /// @details The source element is small, so it is read into a XmlDocument and created from
+    ///   its node.
+    /// @param reader Reader positioned at the source element, read up to its end.
+    /// @return owner pointer to the created source.
+    static std::unique_ptr<Source> createSource(XmlStreamReader& reader);
 };
 
 }
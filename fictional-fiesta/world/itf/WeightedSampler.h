@@ -0,0 +1,72 @@
+#ifndef INCLUDE_FICTIONAL_FIESTA_WORLD_WEIGHTED_SAMPLER_H
+#define INCLUDE_FICTIONAL_FIESTA_WORLD_WEIGHTED_SAMPLER_H
+
+#include "fictional-fiesta/world/itf/FSM.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace fictionalfiesta
+{
+
+/// @brief Class that draws indices with a probability proportional to a set of weights that
+///   can change between draws.
+/// @details Internally it keeps a Fenwick (binary indexed) tree over the weights, so both
+///   drawing an index and updating a weight cost O(log N) instead of the O(N) needed to
+///   rebuild a @c std::discrete_distribution.
+class WeightedSampler
+{
+  public:
+
+    /// @brief Constructor from the initial weights.
+    /// @param weights Initial (non-negative) weights of each index.
+    explicit WeightedSampler(const std::vector<double>& weights);
+
+    /// @brief Gets the number of indices of the sampler.
+    /// @return Number of indices (including the ones with zero weight).
+    std::size_t size() const noexcept;
+
+    /// @brief Checks whether there is any index that can be drawn.
+    /// @return @e true if all the weights are zero and @e false otherwise.
+    bool empty() const noexcept;
+
+    /// @brief Gets the weight of a given index.
+    /// @param index Index whose weight is retrieved.
+    /// @return Weight of the index.
+    double getWeight(std::size_t index) const;
+
+    /// @brief Gets the sum of all the weights.
+    /// @return Total weight.
+    double getTotalWeight() const;
+
+    /// @brief Changes the weight of a given index.
+    /// @param index Index whose weight is changed.
+    /// @param weight New (non-negative) weight of the index.
+    void setWeight(std::size_t index, double weight);
+
+    /// @brief Draws an index with a probability proportional to its weight.
+    /// @note The sampler must not be empty.
+    /// @param rng Random number generator.
+    /// @return Index drawn.
+    std::size_t draw(FSM::Rng& rng) const;
+
+    /// @brief Finds the first index whose cumulative weight is greater than @p target.
+    /// @param target Value in the range [0, total weight).
+    /// @return Index found. Indices with zero weight are never returned.
+    std::size_t find(double target) const;
+
+  private:
+
+    /// Weights of each index.
+    std::vector<double> _weights;
+
+    /// Fenwick tree with the partial sums of the weights (1-based).
+    std::vector<double> _tree;
+
+    /// Number of indices with a positive weight.
+    std::size_t _positiveCount;
+};
+
+} // namespace fictionalfiesta
+
+#endif
@@ -14,6 +14,10 @@
 namespace fictionalfiesta
 {
 
+class BinaryReader;
+class BinaryWriter;
+class XmlStreamReader;
+
 /// @brief Class that represents the world.
 class World : public XmlSavable, public Descriptable
 {
@@ -23,29 +27,101 @@ class World : public XmlSavable, public Descriptable
     World() = default;
 
     /// @brief Constructor from a path to a XML document.
+    /// @details The document is streamed, so it is never loaded whole in memory, and the
+    ///   locations can be parsed in parallel.
     /// @param xmlPath Path to the world XML document.
-    explicit World(const std::experimental::filesystem::path& xmlPath);
+    /// @param threadCount Number of threads used to parse the locations. Zero means one per
+    ///   hardware thread.
+    explicit World(const std::experimental::filesystem::path& xmlPath,
+        unsigned int threadCount = 1);
+
+    /// @brief Constructor from a XmlNode.
+    /// @details The locations can be built in parallel.
+    /// @param node XML node from where to load the class contents.
+    /// @param threadCount Number of threads used to build the locations. Zero means one per
+    ///   hardware thread.
+    explicit World(const XmlNode& node, unsigned int threadCount = 1);
+
+    /// @brief Constructor from a binary snapshot.
+    /// @param reader Reader of a snapshot positioned at a world written by save(BinaryWriter&).
+    /// @see Snapshot
+    explicit World(BinaryReader& reader);
+
+    /// @brief Constructor from a XML stream.
+    /// @details If the reader reads a file, the locations are only skipped by it and parsed in
+    ///   parallel from their byte ranges of the file.
+    /// @param reader Reader positioned at the world element, read up to its end.
+    /// @param threadCount Number of threads used to parse the locations. Zero means one per
+    ///   hardware thread.
+    explicit World(XmlStreamReader& reader, unsigned int threadCount = 1);
 
     /// @brief Add a location to the world.
     /// @param location Location to be added.
     void addLocation(Location&& location);
 
+    /// @brief Sets the strategy used to split the resources in all the locations.
+    /// @details The mode is also applied to the locations added afterwards.
+    /// @param mode Resource split mode.
+    void setResourceSplitMode(ResourceSplitter::Mode mode);
+
+    /// @brief Gets the strategy used to split the resources in all the locations.
+    /// @return Resource split mode.
+    ResourceSplitter::Mode getResourceSplitMode() const;
+
+    /// @brief Sets whether the resources of every location are split in parallel shards.
+    /// @details The setting is also applied to the locations added afterwards.
+    /// @param sharded @e true to shard the populations and @e false otherwise.
+    /// @see Location::setShardedResourceSplit
+    void setShardedResourceSplit(bool sharded);
+
+    /// @brief Checks whether the resources of every location are split in parallel shards.
+    /// @return @e true if the populations are sharded and @e false otherwise.
+    bool isShardedResourceSplit() const;
+
+    /// @brief Sets the number of threads used to run the cycles.
+    /// @param threadCount Number of threads. Zero means one per hardware thread.
+    void setThreadCount(unsigned int threadCount);
+
+    /// @brief Gets the number of threads used to run the cycles.
+    /// @return Number of threads. Zero means one per hardware thread.
+    unsigned int getThreadCount() const;
+
+    /// @brief Sets the number of threads used inside each location.
+    /// @details The count is also applied to the locations added afterwards. The locations run
+    ///   by the other threads of the world run inline in their thread (see Parallel), so the
+    ///   counts do not multiply.
+    /// @param threadCount Number of threads. Zero means one per hardware thread.
+    /// @see Location::setThreadCount
+    void setLocationThreadCount(unsigned int threadCount);
+
+    /// @brief Gets the number of threads used inside each location.
+    /// @return Number of threads. Zero means one per hardware thread.
+    unsigned int getLocationThreadCount() const;
+
     /// @brief Run a cycle over all the locations of the world.
+    /// @details The locations are independent, so they run in parallel, the most expensive ones
+    ///   (according to Location::getCostHint) first. Each one uses its own stream, seeded from a
+    ///   single draw of @p rng and the index of the location, so the results do not depend on
+    ///   the number of threads or on the scheduling.
     /// @param rng Random number generator.
     void cycle(FSM::Rng& rng);
 
     /// @copydoc Descriptable::str
     std::string str(unsigned int indentLevel) const override;
 
+    using XmlSavable::save;
+
+    /// @brief Saves the world in a binary snapshot: its locations, in order.
+    /// @details As in XML, the settings are not saved.
+    /// @param writer Writer of the snapshot.
+    /// @see Snapshot
+    void save(BinaryWriter& writer) const;
+
     /// Name of the main XML node for this class.
     static constexpr char XML_MAIN_NODE_NAME[]{"World"};
 
   private:
 
-    /// @brief Constructor from a XmlNode.
-    /// @param node XML node from where to load the class contents.
-    explicit World(const XmlNode& node);
-
     /// @copydoc XmlSavable::doSave
     void doSave(XmlNode& node) const override;
 
@@ -55,6 +131,18 @@ class World : public XmlSavable, public Descriptable
     /// Location vector.
     std::vector<Location> _locations;
 
+    /// Strategy used to split the resources in the locations.
+    ResourceSplitter::Mode _resourceSplitMode = ResourceSplitter::Mode::Unit;
+
+    /// Whether the resources of the locations are split in parallel shards.
+    bool _shardedResourceSplit = false;
+
+    /// Number of threads used to run the cycles. Zero means one per hardware thread.
+    unsigned int _threadCount = 1;
+
+    /// Number of threads used inside each location. Zero means one per hardware thread.
+    unsigned int _locationThreadCount = 1;
+
 };
 
 } // namespace fictionalfiesta
@@ -0,0 +1,194 @@
+/// @file Checkpoint.cpp Implementation of the Checkpoint class.
+
+#include "fictional-fiesta/world/itf/Checkpoint.h"
+
+#include "fictional-fiesta/utils/itf/Exception.h"
+#include "fictional-fiesta/utils/itf/XmlNode.h"
+#include "fictional-fiesta/utils/itf/XmlStreamReader.h"
+
+#include <optional>
+#include <utility>
+
+namespace fictionalfiesta
+{
+
+namespace
+{
+
+constexpr char XML_CYCLE_NODE_NAME[]{"Cycle"};
+constexpr char XML_RNG_NODE_NAME[]{"Rng"};
+constexpr char XML_ENGINE_ATTRIBUTE_NAME[]{"Engine"};
+constexpr char XML_RESOURCE_SPLIT_NODE_NAME[]{"ResourceSplit"};
+constexpr char XML_MODE_ATTRIBUTE_NAME[]{"Mode"};
+constexpr char XML_SHARDED_ATTRIBUTE_NAME[]{"Sharded"};
+
+FSM::Rng load_rng(const XmlNode& node);
+
+FSM::Rng load_rng(XmlStreamReader& reader);
+
+void check_engine(const std::string& engine);
+
+/// Resource split mode and whether the split is sharded.
+using ResourceSplit = std::pair<ResourceSplitter::Mode, bool>;
+
+ResourceSplit load_resource_split(const XmlNode& node);
+
+ResourceSplit load_resource_split(XmlStreamReader& reader);
+
+void apply_resource_split(const ResourceSplit& resourceSplit, World& world);
+
+} // anonymous namespace
+
+Checkpoint::Checkpoint(World&& world, const FSM::Rng& rng, unsigned long long cycleCount):
+  _world(std::move(world)),
+  _rng(rng),
+  _cycleCount(cycleCount)
+{
+}
+
+Checkpoint::Checkpoint(const std::experimental::filesystem::path& xmlPath,
+    unsigned int threadCount)
+{
+  XmlStreamReader reader{xmlPath};
+  *this = Checkpoint(reader, threadCount);
+}
+
+Checkpoint::Checkpoint(const XmlNode& node, unsigned int threadCount):
+  _world(node.getChildNode(World::XML_MAIN_NODE_NAME), threadCount),
+  _rng(load_rng(node.getChildNode(XML_RNG_NODE_NAME))),
+  _cycleCount(node.getChildNodeTextAs<unsigned long long>(XML_CYCLE_NODE_NAME))
+{
+  apply_resource_split(load_resource_split(node.getChildNode(XML_RESOURCE_SPLIT_NODE_NAME)),
+      _world);
+}
+
+Checkpoint::Checkpoint(XmlStreamReader& reader, unsigned int threadCount)
+{
+  std::optional<World> world;
+  std::optional<FSM::Rng> rng;
+  std::optional<unsigned long long> cycle_count;
+  std::optional<ResourceSplit> resource_split;
+
+  const auto depth = reader.getDepth();
+  while (reader.nextChildElement(depth))
+  {
+    const auto& name = reader.getName();
+    if (name == World::XML_MAIN_NODE_NAME)
+    {
+      world.emplace(reader, threadCount);
+    }
+    else if (name == XML_RNG_NODE_NAME)
+    {
+      rng = load_rng(reader);
+    }
+    else if (name == XML_CYCLE_NODE_NAME)
+    {
+      cycle_count = reader.getTextAs<unsigned long long>();
+    }
+    else if (name == XML_RESOURCE_SPLIT_NODE_NAME)
+    {
+      resource_split = load_resource_split(reader);
+    }
+  }
+
+  _world = XmlStreamReader::getMandatory(std::move(world), XML_MAIN_NODE_NAME,
+      World::XML_MAIN_NODE_NAME);
+  _rng = XmlStreamReader::getMandatory(std::move(rng), XML_MAIN_NODE_NAME, XML_RNG_NODE_NAME);
+  _cycleCount = XmlStreamReader::getMandatory(std::move(cycle_count), XML_MAIN_NODE_NAME,
+      XML_CYCLE_NODE_NAME);
+  apply_resource_split(XmlStreamReader::getMandatory(std::move(resource_split),
+      XML_MAIN_NODE_NAME, XML_RESOURCE_SPLIT_NODE_NAME), _world);
+}
+
+void Checkpoint::cycle()
+{
+  _world.cycle(_rng);
+  ++_cycleCount;
+}
+
+World& Checkpoint::getWorld()
+{
+  return _world;
+}
+
+const World& Checkpoint::getWorld() const
+{
+  return _world;
+}
+
+const FSM::Rng& Checkpoint::getRng() const
+{
+  return _rng;
+}
+
+unsigned long long Checkpoint::getCycleCount() const
+{
+  return _cycleCount;
+}
+
+void Checkpoint::doSave(XmlNode& node) const
+{
+  node.appendChildNode(XML_CYCLE_NODE_NAME).setText(_cycleCount);
+
+  auto rng_node = node.appendChildNode(XML_RNG_NODE_NAME);
+  rng_node.setAttribute(XML_ENGINE_ATTRIBUTE_NAME, std::string{FSM::RNG_ENGINE_NAME});
+  rng_node.setText(FSM::rngToString(_rng));
+
+  auto resource_split_node = node.appendChildNode(XML_RESOURCE_SPLIT_NODE_NAME);
+  resource_split_node.setAttribute(XML_MODE_ATTRIBUTE_NAME,
+      ResourceSplitter::modeToString(_world.getResourceSplitMode()));
+  resource_split_node.setAttribute(XML_SHARDED_ATTRIBUTE_NAME, _world.isShardedResourceSplit());
+
+  _world.save(node.appendChildNode(World::XML_MAIN_NODE_NAME));
+}
+
+std::string Checkpoint::getDefaultXmlName() const
+{
+  return XML_MAIN_NODE_NAME;
+}
+
+namespace
+{
+
+FSM::Rng load_rng(const XmlNode& node)
+{
+  check_engine(node.getAttribute(XML_ENGINE_ATTRIBUTE_NAME));
+  return FSM::rngFromString(node.getText());
+}
+
+FSM::Rng load_rng(XmlStreamReader& reader)
+{
+  check_engine(reader.getAttribute(XML_ENGINE_ATTRIBUTE_NAME));
+  return FSM::rngFromString(reader.getText());
+}
+
+void check_engine(const std::string& engine)
+{
+  if (engine != FSM::RNG_ENGINE_NAME)
+  {
+    throw Exception("The checkpoint was saved with the '" + engine + "' random number engine, "
+        "but this build uses '" + FSM::RNG_ENGINE_NAME + "'.");
+  }
+}
+
+ResourceSplit load_resource_split(const XmlNode& node)
+{
+  return {ResourceSplitter::modeFromString(node.getAttribute(XML_MODE_ATTRIBUTE_NAME)),
+      node.getAttributeAs<bool>(XML_SHARDED_ATTRIBUTE_NAME)};
+}
+
+ResourceSplit load_resource_split(XmlStreamReader& reader)
+{
+  return {ResourceSplitter::modeFromString(reader.getAttribute(XML_MODE_ATTRIBUTE_NAME)),
+      reader.getAttributeAs<bool>(XML_SHARDED_ATTRIBUTE_NAME)};
+}
+
+void apply_resource_split(const ResourceSplit& resourceSplit, World& world)
+{
+  world.setResourceSplitMode(resourceSplit.first);
+  world.setShardedResourceSplit(resourceSplit.second);
+}
+
+} // anonymous namespace
+
+} // namespace fictionalfiesta
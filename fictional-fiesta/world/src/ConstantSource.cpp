@@ -2,21 +2,17 @@
 
 #include "fictional-fiesta/world/itf/ConstantSource.h"
 
+#include "fictional-fiesta/utils/itf/BinaryReader.h"
+#include "fictional-fiesta/utils/itf/BinaryWriter.h"
 #include "fictional-fiesta/utils/itf/Exception.h"
 #include "fictional-fiesta/utils/itf/XmlNode.h"
 
+#include <cstdint>
 #include <limits>
 
 namespace fictionalfiesta
 {
 
-namespace
-{
-
-unsigned int get_unit_count_from_node(const XmlNode& fixedUnitNode);
-
-} // anonymous namespace
-
 ConstantSource::ConstantSource(const std::string& resourceId, unsigned int fixedUnitCount,
     unsigned int currentUnitCount):
   Source(resourceId, currentUnitCount),
@@ -43,10 +39,21 @@ ConstantSource::ConstantSource(const XmlNode& node, unsigned int fixedUnitCount)
 }
 
 ConstantSource::ConstantSource(const XmlNode& node):
-  ConstantSource(node, get_unit_count_from_node(node.getChildNode(XML_FIXED_UNIT_COUNT_NODE_NAME)))
+  ConstantSource(node, unitsFromNode(node.getChildNode(XML_FIXED_UNIT_COUNT_NODE_NAME)))
 {
 }
 
+ConstantSource::ConstantSource(BinaryReader& reader):
+  Source(reader),
+  _fixedUnitCount(reader.read<std::uint32_t>())
+{
+}
+
+std::string ConstantSource::getType() const
+{
+  return XML_SOURCE_TYPE_ATTRIBUTE_VALUE;
+}
+
 void ConstantSource::regenerate()
 {
   setCurrentUnitCount(_fixedUnitCount);
@@ -64,31 +71,18 @@ std::string ConstantSource::str(unsigned int indentLevel) const
 
 void ConstantSource::doSave(XmlNode& node) const
 {
-  node.setAttribute(XML_SOURCE_TYPE_ATTRIBUTE_NAME, XML_SOURCE_TYPE_ATTRIBUTE_VALUE);
-
   auto fixed_units_node = node.appendChildNode(XML_FIXED_UNIT_COUNT_NODE_NAME);
   fixed_units_node.setText(unitsToString(_fixedUnitCount));
 }
 
-ConstantSource* ConstantSource::doClone() const
+void ConstantSource::doSave(BinaryWriter& writer) const
 {
-  return new ConstantSource(*this);
+  writer.write(static_cast<std::uint32_t>(_fixedUnitCount));
 }
 
-namespace
-{
-
-unsigned int get_unit_count_from_node(const XmlNode& fixedUnitNode)
+ConstantSource* ConstantSource::doClone() const
 {
-  const std::string value_string = fixedUnitNode.getText();
-  if (value_string == "infinity")
-  {
-    return Source::INFINITY_UNITS;
-  }
-
-  return fixedUnitNode.getTextAs<unsigned int>();
+  return new ConstantSource(*this);
 }
 
-} // anonymous namespace
-
 } // namespace fictionalfiesta
@@ -2,9 +2,46 @@
 
 #include "fictional-fiesta/world/itf/Individual.h"
 
+#include "fictional-fiesta/utils/itf/Exception.h"
+
+#include <cmath>
+#include <sstream>
+
 namespace fictionalfiesta
 {
 
+namespace
+{
+
+std::uint64_t mix(std::uint64_t value) noexcept;
+
+std::uint64_t hash_key(std::initializer_list<std::uint64_t> key) noexcept;
+
+/// Increment of the SplitMix64 state (golden ratio), used to hash the key tuples.
+constexpr std::uint64_t SPLIT_MIX_GAMMA{0x9e3779b97f4a7c15ULL};
+
+/// Rounds of the Philox bijection.
+constexpr unsigned int PHILOX_ROUNDS{10};
+
+/// Multipliers of the Philox rounds.
+constexpr std::uint32_t PHILOX_MULTIPLIER_0{0xD2511F53};
+constexpr std::uint32_t PHILOX_MULTIPLIER_1{0xCD9E8D57};
+
+/// Increments of the Philox key between rounds (golden ratio and sqrt(3) - 1).
+constexpr std::uint32_t PHILOX_WEYL_0{0x9E3779B9};
+constexpr std::uint32_t PHILOX_WEYL_1{0xBB67AE85};
+
+/// Number of different raw 32-bit values.
+constexpr std::uint64_t TWO_TO_32{std::uint64_t{1} << 32};
+
+/// Factor that maps a raw 32-bit value to [0, 1).
+constexpr double UNIFORM_SCALE{1.0 / TWO_TO_32};
+
+/// Two times pi.
+constexpr double TWO_PI{6.283185307179586476925286766559};
+
+} // anonymous namespace
+
 FSM::Rng FSM::createRng()
 {
   std::random_device rd;
@@ -16,4 +53,204 @@ FSM::Rng FSM::createRng(unsigned int seed)
   return FSM::Rng(seed);
 }
 
+FSM::Rng FSM::createRng(std::uint64_t seed, unsigned long long stream)
+{
+  // The seed sequence spreads the entropy of the seed and the stream over the whole state.
+  std::seed_seq sequence{static_cast<unsigned int>(seed), static_cast<unsigned int>(seed >> 32),
+      static_cast<unsigned int>(stream), static_cast<unsigned int>(stream >> 32)};
+  return FSM::Rng(sequence);
+}
+
+std::string FSM::rngToString(const Rng& rng)
+{
+  std::ostringstream stream;
+  stream << rng;
+  return stream.str();
+}
+
+FSM::Rng FSM::rngFromString(const std::string& state)
+{
+  std::istringstream stream{state};
+  Rng rng;
+  stream >> rng;
+  if (!stream || !(stream >> std::ws).eof())
+  {
+    throw Exception(std::string{"Invalid state for the '"} + RNG_ENGINE_NAME +
+        "' random number generator.");
+  }
+  return rng;
+}
+
+FSM::CounterRng FSM::createStream(std::uint64_t seed,
+    std::initializer_list<std::uint64_t> streamKey) noexcept
+{
+  return CounterRng(seed, streamKey);
+}
+
+FSM::CounterRng::CounterRng(std::uint64_t seed,
+    std::initializer_list<std::uint64_t> streamKey) noexcept:
+  _key{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)},
+  _stream(hash_key(streamKey))
+{
+}
+
+FSM::CounterRng::result_type FSM::CounterRng::operator()() noexcept
+{
+  if (_position == BLOCK_SIZE)
+  {
+    generateBlock(_block + 1);
+  }
+  return _values[_position++];
+}
+
+void FSM::CounterRng::discard(unsigned long long count) noexcept
+{
+  const auto remaining = BLOCK_SIZE - _position;
+  if (count <= remaining)
+  {
+    _position += static_cast<unsigned int>(count);
+    return;
+  }
+
+  // Jump to the block of the next value, counting from the start of the following block.
+  count -= remaining;
+  generateBlock(_block + 1 + count / BLOCK_SIZE);
+  _position = static_cast<unsigned int>(count % BLOCK_SIZE);
+}
+
+FSM::CounterRng::Counter FSM::CounterRng::encrypt(Counter counter, Key key) noexcept
+{
+  for (unsigned int round = 0; round < PHILOX_ROUNDS; ++round)
+  {
+    const auto product_0 = static_cast<std::uint64_t>(PHILOX_MULTIPLIER_0) * counter[0];
+    const auto product_1 = static_cast<std::uint64_t>(PHILOX_MULTIPLIER_1) * counter[2];
+    counter = {static_cast<std::uint32_t>(product_1 >> 32) ^ counter[1] ^ key[0],
+        static_cast<std::uint32_t>(product_1),
+        static_cast<std::uint32_t>(product_0 >> 32) ^ counter[3] ^ key[1],
+        static_cast<std::uint32_t>(product_0)};
+    key[0] += PHILOX_WEYL_0;
+    key[1] += PHILOX_WEYL_1;
+  }
+  return counter;
+}
+
+FSM::StreamBatch::StreamBatch(std::uint64_t seed, std::uint64_t firstStream) noexcept
+{
+  // Same bijection as CounterRng::encrypt, transposed so that every step loops over the lanes.
+  std::array<Values, VALUE_COUNT> counter{};
+  for (std::size_t lane = 0; lane < SIZE; ++lane)
+  {
+    const auto stream = hash_key({firstStream + lane});
+    counter[2][lane] = static_cast<std::uint32_t>(stream);
+    counter[3][lane] = static_cast<std::uint32_t>(stream >> 32);
+  }
+
+  auto key_0 = static_cast<std::uint32_t>(seed);
+  auto key_1 = static_cast<std::uint32_t>(seed >> 32);
+  for (unsigned int round = 0; round < PHILOX_ROUNDS; ++round)
+  {
+    for (std::size_t lane = 0; lane < SIZE; ++lane)
+    {
+      const auto product_0 = static_cast<std::uint64_t>(PHILOX_MULTIPLIER_0) * counter[0][lane];
+      const auto product_1 = static_cast<std::uint64_t>(PHILOX_MULTIPLIER_1) * counter[2][lane];
+      counter[0][lane] = static_cast<std::uint32_t>(product_1 >> 32) ^ counter[1][lane] ^ key_0;
+      counter[1][lane] = static_cast<std::uint32_t>(product_1);
+      counter[2][lane] = static_cast<std::uint32_t>(product_0 >> 32) ^ counter[3][lane] ^ key_1;
+      counter[3][lane] = static_cast<std::uint32_t>(product_0);
+    }
+    key_0 += PHILOX_WEYL_0;
+    key_1 += PHILOX_WEYL_1;
+  }
+  _values = counter;
+}
+
+const FSM::StreamBatch::Values& FSM::StreamBatch::getValues(unsigned int position) const noexcept
+{
+  return _values[position];
+}
+
+void FSM::StreamBatch::bernoulli(unsigned int position, const Thresholds& thresholds,
+    Outcomes& outcomes) const noexcept
+{
+  const auto& values = _values[position];
+  for (std::size_t lane = 0; lane < SIZE; ++lane)
+  {
+    outcomes[lane] = values[lane] < thresholds[lane];
+  }
+}
+
+void FSM::StreamBatch::uniforms(unsigned int position,
+    std::array<double, SIZE>& uniforms) const noexcept
+{
+  const auto& values = _values[position];
+  for (std::size_t lane = 0; lane < SIZE; ++lane)
+  {
+    uniforms[lane] = values[lane] * UNIFORM_SCALE;
+  }
+}
+
+std::uint64_t FSM::StreamBatch::bernoulliThreshold(double probability) noexcept
+{
+  if (!(probability > 0))
+  {
+    return 0;
+  }
+  if (probability >= 1)
+  {
+    return TWO_TO_32;
+  }
+  return static_cast<std::uint64_t>(probability * static_cast<double>(TWO_TO_32));
+}
+
+void FSM::NormalGenerator::transform(const double* radii, const double* angles,
+    std::size_t count, double* first, double* second) noexcept
+{
+  for (std::size_t index = 0; index < count; ++index)
+  {
+    const auto radius = std::sqrt(-2 * std::log(radii[index]));
+    first[index] = radius * std::cos(TWO_PI * angles[index]);
+    second[index] = radius * std::sin(TWO_PI * angles[index]);
+  }
+}
+
+void FSM::NormalGenerator::reset() noexcept
+{
+  _hasCached = false;
+}
+
+void FSM::CounterRng::generateBlock(std::uint64_t block) noexcept
+{
+  // The block index is stored one-based, so that zero means that nothing was generated yet.
+  _block = block;
+  _values = encrypt({static_cast<std::uint32_t>(block - 1),
+      static_cast<std::uint32_t>((block - 1) >> 32), static_cast<std::uint32_t>(_stream),
+      static_cast<std::uint32_t>(_stream >> 32)}, _key);
+  _position = 0;
+}
+
+namespace
+{
+
+/// @brief Finalizer of SplitMix64, a bijection that scrambles all the bits of the value.
+std::uint64_t mix(std::uint64_t value) noexcept
+{
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+  return value ^ (value >> 31);
+}
+
+/// @brief Hashes a key tuple into a stream identifier.
+/// @details The length is hashed too, so (a) and (a, 0) are different streams.
+std::uint64_t hash_key(std::initializer_list<std::uint64_t> key) noexcept
+{
+  auto hash = mix(key.size() + SPLIT_MIX_GAMMA);
+  for (const auto value : key)
+  {
+    hash = mix((hash + SPLIT_MIX_GAMMA) ^ value);
+  }
+  return hash;
+}
+
+} // anonymous namespace
+
 } //namespace fictionalfiesta
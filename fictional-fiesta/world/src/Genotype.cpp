@@ -6,6 +6,7 @@
 
 #include "fictional-fiesta/utils/itf/Exception.h"
 #include "fictional-fiesta/utils/itf/XmlNode.h"
+#include "fictional-fiesta/utils/itf/XmlStreamReader.h"
 
 #include <sstream>
 
@@ -17,6 +18,8 @@ namespace
 
 double normalized_distance(const double first, const double second);
 
+Genotype read_genotype(XmlStreamReader& reader);
+
 constexpr char XML_REPRODUCTION_ENERGY_THRESHOLD_NAME[]{"ReproductionEnergyThreshold"};
 constexpr char XML_REPRODUCTION_PROBABILITY_NAME[]{"ReproductionProbability"};
 constexpr char XML_MUTABILITY_RATIO_NAME[]{"MutabilityRatio"};
@@ -50,6 +53,11 @@ Genotype::Genotype(const XmlNode& node):
 {
 }
 
+Genotype::Genotype(XmlStreamReader& reader):
+  Genotype(read_genotype(reader))
+{
+}
+
 double Genotype::getReproductionEnergyThreshold() const
 {
   return _reproductionEnergyThreshold;
@@ -65,7 +73,8 @@ double Genotype::getMutabilityRatio() const
   return _mutabilityRatio;
 }
 
-bool Genotype::willReproduce(const Phenotype& phenotype, FSM::Rng& rng) const
+template <typename Generator>
+bool Genotype::willReproduce(const Phenotype& phenotype, Generator& rng) const
 {
   if (phenotype.getEnergy() >= _reproductionEnergyThreshold)
   {
@@ -74,27 +83,53 @@ bool Genotype::willReproduce(const Phenotype& phenotype, FSM::Rng& rng) const
   return false;
 }
 
-Genotype Genotype::reproduce(FSM::Rng& rng) const
+template <typename Generator>
+Genotype Genotype::reproduce(Generator& rng) const
+{
+  FSM::NormalGenerator normal;
+  return reproduce(rng, normal);
+}
+
+template <typename Generator>
+Genotype Genotype::reproduce(Generator& rng, FSM::NormalGenerator& normal) const
+{
+  const auto reproduction_energy_threshold_variate = normal(rng);
+  const auto reproduction_probability_variate = normal(rng);
+  const auto mutability_ratio_variate = normal(rng);
+  return mutate(reproduction_energy_threshold_variate, reproduction_probability_variate,
+      mutability_ratio_variate);
+}
+
+Genotype Genotype::mutate(double reproductionEnergyThresholdVariate,
+    double reproductionProbabilityVariate, double mutabilityRatioVariate) const
 {
   // The genotype features change accordingly to a normal distribution with mean,
   // the original value and standard deviation, the mutability ratio.
-  const auto reproduction_energy_threshold =
-      std::normal_distribution(_reproductionEnergyThreshold,
-      _mutabilityRatio * _reproductionEnergyThreshold)(rng);
-  const auto reproduction_probability = std::min(1.0,
-      std::normal_distribution(_reproductionProbability,
-      _mutabilityRatio * _reproductionProbability)(rng));
-  const auto mutabilityRatio = std::max(MINIMUM_MUTABILITY, std::normal_distribution(
-      _mutabilityRatio, _mutabilityRatio * _mutabilityRatio)(rng));
+  const auto reproduction_energy_threshold = _reproductionEnergyThreshold +
+      _mutabilityRatio * _reproductionEnergyThreshold * reproductionEnergyThresholdVariate;
+  const auto reproduction_probability = std::min(1.0, _reproductionProbability +
+      _mutabilityRatio * _reproductionProbability * reproductionProbabilityVariate);
+  const auto mutabilityRatio = std::max(MINIMUM_MUTABILITY,
+      _mutabilityRatio + _mutabilityRatio * _mutabilityRatio * mutabilityRatioVariate);
 
   return Genotype{reproduction_energy_threshold, reproduction_probability, mutabilityRatio};
 }
 
-bool Genotype::producedDeadlyMutation(FSM::Rng& rng) const
+template <typename Generator>
+bool Genotype::producedDeadlyMutation(Generator& rng) const
 {
   return std::bernoulli_distribution(_mutabilityRatio)(rng);
 }
 
+template bool Genotype::willReproduce(const Phenotype& phenotype, FSM::Rng& rng) const;
+template bool Genotype::willReproduce(const Phenotype& phenotype, FSM::CounterRng& rng) const;
+template Genotype Genotype::reproduce(FSM::Rng& rng) const;
+template Genotype Genotype::reproduce(FSM::CounterRng& rng) const;
+template Genotype Genotype::reproduce(FSM::Rng& rng, FSM::NormalGenerator& normal) const;
+template Genotype Genotype::reproduce(FSM::CounterRng& rng, FSM::NormalGenerator& normal) const;
+template bool Genotype::producedDeadlyMutation(FSM::Rng& rng) const;
+template bool Genotype::producedDeadlyMutation(FSM::CounterRng& rng) const;
+
 double Genotype::distance(const Genotype& other) const
 {
   const unsigned int feature_number = 3;
@@ -195,6 +230,40 @@ double normalized_distance(const double first, const double second)
   return 2 * std::abs(first - second) / (first + second);
 }
 
+Genotype read_genotype(XmlStreamReader& reader)
+{
+  std::optional<double> reproduction_energy_threshold;
+  std::optional<double> reproduction_probability;
+  std::optional<double> mutability_ratio;
+
+  const auto depth = reader.getDepth();
+  while (reader.nextChildElement(depth))
+  {
+    const auto& name = reader.getName();
+    if (name == XML_REPRODUCTION_ENERGY_THRESHOLD_NAME)
+    {
+      reproduction_energy_threshold = reader.getTextAs<double>();
+    }
+    else if (name == XML_REPRODUCTION_PROBABILITY_NAME)
+    {
+      reproduction_probability = reader.getTextAs<double>();
+    }
+    else if (name == XML_MUTABILITY_RATIO_NAME)
+    {
+      mutability_ratio = reader.getTextAs<double>();
+    }
+  }
+
+  const auto& element_name = Genotype::XML_MAIN_NODE_NAME;
+  return Genotype{
+      XmlStreamReader::getMandatory(std::move(reproduction_energy_threshold), element_name,
+          XML_REPRODUCTION_ENERGY_THRESHOLD_NAME),
+      XmlStreamReader::getMandatory(std::move(reproduction_probability), element_name,
+          XML_REPRODUCTION_PROBABILITY_NAME),
+      XmlStreamReader::getMandatory(std::move(mutability_ratio), element_name,
+          XML_MUTABILITY_RATIO_NAME)};
+}
+
 } // anonymous namespace
 
 } // namespace fictionalfiesta
@@ -3,7 +3,11 @@
 #include "fictional-fiesta/world/itf/Individual.h"
 
 #include "fictional-fiesta/utils/itf/XmlNode.h"
+#include "fictional-fiesta/utils/itf/XmlStreamReader.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <sstream>
 
 namespace
@@ -17,6 +21,13 @@ namespace
 namespace fictionalfiesta
 {
 
+namespace
+{
+
+Individual read_individual(XmlStreamReader& reader);
+
+} // anonymous namespace
+
 Individual::Individual(const Genotype& genotype, double initialEnergy):
   _genotype(genotype),
   _phenotype(initialEnergy)
@@ -27,7 +38,12 @@ Individual::Individual(const XmlNode& node):
   _genotype(node.getChildNode(Genotype::XML_MAIN_NODE_NAME)),
   _phenotype(node.getChildNode(Phenotype::XML_MAIN_NODE_NAME)),
   _isDead(node.getOptionalAttributeAs("IsDead", false)),
-  _resourceCount(node.getOptionalAttributeAs("ResourceCount", 0))
+  _resourceCount(node.getOptionalAttributeAs("ResourceCount", 0u))
+{
+}
+
+Individual::Individual(XmlStreamReader& reader):
+  Individual(read_individual(reader))
 {
 }
 
@@ -62,6 +78,11 @@ bool Individual::isHungry() const
   return _resourceCount < _phenotype.getEnergy();
 }
 
+unsigned int Individual::getUnitsToSatiety() const
+{
+  return unitsToSatiety(_phenotype.getEnergy(), _resourceCount);
+}
+
 Individual& Individual::feed(unsigned int units)
 {
   _resourceCount += units;
@@ -88,28 +109,17 @@ Individual Individual::reproduce(FSM::Rng& rng)
 
 void Individual::performMaintenance(FSM::Rng& rng)
 {
-  // An individual uses at least half its energy in resources just to survive.
-  const auto maintenance_cost = _phenotype.getEnergy() / 2;
-
-  // If there are not enough units, the individual might die out of starvation.
-  if (_resourceCount < maintenance_cost)
+  const auto surplus = maintenanceSurplus(_phenotype.getEnergy(), _resourceCount, rng);
+  if (surplus)
   {
-    const auto starvation_probability = 1.0 - (_resourceCount / maintenance_cost);
-    if (std::bernoulli_distribution(starvation_probability)(rng))
-    {
-      die();
-    }
-    _resourceCount = 0;
+    // TODO: Currently the individual consumes all the resources.
+    _phenotype.feed(*surplus, _genotype);
   }
   else
   {
-    // The units of resource are always consumed as integers.
-    const auto remaining_energy = static_cast<double>(_resourceCount) - maintenance_cost;
-
-    // TODO: Currently the individual consumes all the resources.
-    _phenotype.feed(remaining_energy, _genotype);
-    _resourceCount = 0;
+    die();
   }
+  _resourceCount = 0;
 }
 
 std::string Individual::str(unsigned int indentLevel) const
@@ -130,8 +140,7 @@ std::string Individual::str(unsigned int indentLevel) const
 
 void Individual::doSave(XmlNode& node) const
 {
-  _genotype.save(node.appendChildNode("Genotype"));
-  _phenotype.save(node.appendChildNode("Phenotype"));
+  // The attributes go before the children, so the node can be streamed.
   if (_isDead)
   {
     node.setAttribute("IsDead", true);
@@ -141,8 +150,64 @@ void Individual::doSave(XmlNode& node) const
   {
     node.setAttribute("ResourceCount", _resourceCount);
   }
+
+  _genotype.save(node.appendChildNode("Genotype"));
+  _phenotype.save(node.appendChildNode("Phenotype"));
 }
 
+unsigned int Individual::unitsToSatiety(double energy, unsigned int resourceCount)
+{
+  if (resourceCount >= energy)
+  {
+    return 0;
+  }
+
+  const auto deficit = std::ceil(energy - resourceCount);
+  if (deficit >= std::numeric_limits<unsigned int>::max())
+  {
+    return std::numeric_limits<unsigned int>::max();
+  }
+
+  return std::max(1u, static_cast<unsigned int>(deficit));
+}
+
+double Individual::starvationProbability(double energy, unsigned int resourceCount)
+{
+  // An individual uses at least half its energy in resources just to survive.
+  const auto maintenance_cost = energy / 2;
+
+  // If there are not enough units, the individual might die out of starvation.
+  if (resourceCount < maintenance_cost)
+  {
+    return 1.0 - (resourceCount / maintenance_cost);
+  }
+  return 0.0;
+}
+
+double Individual::survivalSurplus(double energy, unsigned int resourceCount)
+{
+  // The units of resource are always consumed as integers.
+  return std::max(0.0, static_cast<double>(resourceCount) - energy / 2);
+}
+
+template <typename Generator>
+std::optional<double> Individual::maintenanceSurplus(double energy, unsigned int resourceCount,
+    Generator& rng)
+{
+  const auto starvation_probability = starvationProbability(energy, resourceCount);
+  if (starvation_probability > 0 &&
+      std::bernoulli_distribution(starvation_probability)(rng))
+  {
+    return std::nullopt;
+  }
+  return survivalSurplus(energy, resourceCount);
+}
+
+template std::optional<double> Individual::maintenanceSurplus(double energy,
+    unsigned int resourceCount, FSM::Rng& rng);
+template std::optional<double> Individual::maintenanceSurplus(double energy,
+    unsigned int resourceCount, FSM::CounterRng& rng);
+
 std::string Individual::getDefaultXmlName() const
 {
   return XML_MAIN_NODE_NAME;
@@ -178,4 +243,45 @@ bool operator!=(const Individual& lhs, const Individual& rhs)
   return !(lhs == rhs);
 }
 
+namespace
+{
+
+Individual read_individual(XmlStreamReader& reader)
+{
+  // The attributes are only available before reading the children.
+  const auto is_dead = reader.getOptionalAttributeAs("IsDead", false);
+  const auto resource_count = reader.getOptionalAttributeAs("ResourceCount", 0u);
+
+  std::optional<Genotype> genotype;
+  std::optional<Phenotype> phenotype;
+  const auto depth = reader.getDepth();
+  while (reader.nextChildElement(depth))
+  {
+    if (reader.getName() == Genotype::XML_MAIN_NODE_NAME)
+    {
+      genotype.emplace(reader);
+    }
+    else if (reader.getName() == Phenotype::XML_MAIN_NODE_NAME)
+    {
+      phenotype.emplace(reader);
+    }
+  }
+
+  const auto& element_name = Individual::XML_MAIN_NODE_NAME;
+  Individual individual{
+      XmlStreamReader::getMandatory(std::move(genotype), element_name,
+          Genotype::XML_MAIN_NODE_NAME),
+      XmlStreamReader::getMandatory(std::move(phenotype), element_name,
+          Phenotype::XML_MAIN_NODE_NAME).getEnergy()};
+  individual.feed(resource_count);
+  if (is_dead)
+  {
+    individual.die();
+  }
+
+  return individual;
+}
+
+} // anonymous namespace
+
 } // namespace fictionalfiesta
@@ -2,13 +2,19 @@
 
 #include "fictional-fiesta/world/itf/Location.h"
 
+#include "fictional-fiesta/world/itf/ResourceSplitter.h"
 #include "fictional-fiesta/world/itf/Source.h"
 #include "fictional-fiesta/world/itf/SourceFactory.h"
 
+#include "fictional-fiesta/utils/itf/BinaryReader.h"
+#include "fictional-fiesta/utils/itf/BinaryWriter.h"
 #include "fictional-fiesta/utils/itf/Exception.h"
+#include "fictional-fiesta/utils/itf/Parallel.h"
 #include "fictional-fiesta/utils/itf/XmlNode.h"
+#include "fictional-fiesta/utils/itf/XmlStreamReader.h"
 
 #include <algorithm>
+#include <cstdint>
 
 namespace fictionalfiesta
 {
@@ -19,16 +25,17 @@ namespace
 constexpr char XML_RESOURCES_NODE_NAME[]{"Resources"};
 constexpr char XML_INDIVIDUALS_NODE_NAME[]{"Individuals"};
 
-unsigned int draw_resource_unit(
-    const std::vector<double>& weights,
-    FSM::Rng& rng);
+std::size_t chunk_count(std::size_t size);
 
-bool die_during_feed(
-    const Individual& individual,
-    FSM::Rng& rng);
+std::size_t chunk_end(std::size_t chunk, std::size_t size);
+
+PopulationStore read_individuals_in_parallel(XmlStreamReader& reader, unsigned int threadCount);
 
 } // anonymous namespace
 
+static_assert(Location::CHUNK_SIZE % PopulationStore::DEAD_FLAG_ALIGNMENT == 0,
+    "The chunks processed in parallel must not share dead flags.");
+
 Location::Location() = default;
 
 Location::Location(const XmlNode& node)
@@ -44,12 +51,70 @@ Location::Location(const XmlNode& node)
       .getChildNodes(Individual::XML_MAIN_NODE_NAME);
   for (const auto& individual_node : individual_nodes)
   {
-    _individuals.push_back(Individual(individual_node));
+    _population.addIndividual(Individual(individual_node));
+  }
+}
+
+Location::Location(BinaryReader& reader)
+{
+  const auto source_count = reader.read<std::uint64_t>();
+  for (std::uint64_t index = 0; index < source_count; ++index)
+  {
+    _sources.push_back(SourceFactory::createSource(reader));
   }
+
+  _population = PopulationStore(reader);
+}
+
+Location::Location(XmlStreamReader& reader, unsigned int threadCount)
+{
+  bool has_resources = false;
+  bool has_individuals = false;
+  const auto depth = reader.getDepth();
+  while (reader.nextChildElement(depth))
+  {
+    if (reader.getName() == XML_RESOURCES_NODE_NAME && !has_resources)
+    {
+      has_resources = true;
+      while (reader.nextChildElement(depth + 1))
+      {
+        if (reader.getName() == Source::XML_MAIN_NODE_NAME)
+        {
+          _sources.push_back(SourceFactory::createSource(reader));
+        }
+      }
+    }
+    else if (reader.getName() == XML_INDIVIDUALS_NODE_NAME && !has_individuals)
+    {
+      has_individuals = true;
+      if (!reader.getFilePath().empty() && Parallel::resolveThreadCount(threadCount) > 1)
+      {
+        _population = read_individuals_in_parallel(reader, threadCount);
+      }
+      else
+      {
+        while (reader.nextChildElement(depth + 1))
+        {
+          if (reader.getName() == Individual::XML_MAIN_NODE_NAME)
+          {
+            _population.addIndividual(Individual(reader));
+          }
+        }
+      }
+    }
+  }
+
+  XmlStreamReader::checkMandatory(has_resources, XML_MAIN_NODE_NAME, XML_RESOURCES_NODE_NAME);
+  XmlStreamReader::checkMandatory(has_individuals, XML_MAIN_NODE_NAME,
+      XML_INDIVIDUALS_NODE_NAME);
 }
 
 Location::Location(const Location& other):
-    _individuals(other._individuals)
+    _population(other._population),
+    _resourceSplitMode(other._resourceSplitMode),
+    _shardedResourceSplit(other._shardedResourceSplit),
+    _threadCount(other._threadCount),
+    _hasTombstones(other._hasTombstones)
 {
   for (const auto& source : other._sources)
   {
@@ -76,35 +141,46 @@ void Location::splitResources(FSM::Rng& rng)
 
   for (auto& source : _sources)
   {
-    while (!source->empty())
+    if (_shardedResourceSplit)
     {
-      std::vector<double> weights;
-      double total_weight = 0;
-      for (const auto& individual : _individuals)
-      {
-        const auto& weight = (individual.isDead() || !individual.isHungry()) ?
-          0 : individual.getPhenotype().getEnergy();
-        weights.push_back(weight);
-        total_weight += weight;
-      }
+      ResourceSplitter::splitSharded(_resourceSplitMode, *source, _population, rng,
+          _threadCount);
+    }
+    else
+    {
+      ResourceSplitter::split(_resourceSplitMode, *source, _population, rng);
+    }
+  }
+}
 
-      if (total_weight == 0)
-      {
-        break;
-      }
+void Location::setResourceSplitMode(ResourceSplitter::Mode mode)
+{
+  _resourceSplitMode = mode;
+}
 
-      const auto individual_index = draw_resource_unit(weights, rng);
-      auto& winner = _individuals[individual_index];
-      winner.feed(1);
+ResourceSplitter::Mode Location::getResourceSplitMode() const
+{
+  return _resourceSplitMode;
+}
 
-      source->consume(1);
+void Location::setShardedResourceSplit(bool sharded)
+{
+  _shardedResourceSplit = sharded;
+}
 
-      if (die_during_feed(winner, rng))
-      {
-        winner.die();
-      }
-    }
-  }
+bool Location::isShardedResourceSplit() const
+{
+  return _shardedResourceSplit;
+}
+
+void Location::setThreadCount(unsigned int threadCount)
+{
+  _threadCount = threadCount;
+}
+
+unsigned int Location::getThreadCount() const
+{
+  return _threadCount;
 }
 
 void Location::addSource(std::unique_ptr<Source>&& source)
@@ -114,25 +190,48 @@ void Location::addSource(std::unique_ptr<Source>&& source)
 
 void Location::addIndividual(const Individual& individual)
 {
-  _individuals.push_back(individual);
+  // Otherwise a dead individual would be taken for a tombstone.
+  if (_hasTombstones)
+  {
+    cleanDeadIndividuals();
+  }
+  _population.addIndividual(individual);
 }
 
-const std::vector<Individual>& Location::getIndividuals() const
+std::vector<Individual> Location::getIndividuals() const
 {
-  return _individuals;
+  if (!_hasTombstones)
+  {
+    return _population.getIndividuals();
+  }
+
+  std::vector<Individual> individuals;
+  individuals.reserve(_population.size() - _population.getDeadCount());
+  for (std::size_t index = 0; index < _population.size(); ++index)
+  {
+    if (!isTombstone(index))
+    {
+      individuals.push_back(_population.getIndividual(index));
+    }
+  }
+  return individuals;
+}
+
+const PopulationStore& Location::getPopulation() const
+{
+  return _population;
 }
 
 void Location::cleanDeadIndividuals()
 {
-  _individuals.erase(
-      std::remove_if(_individuals.begin(), _individuals.end(),
-      [](const auto& o) { return o.isDead(); }), _individuals.end());
+  _population.removeDead();
+  _hasTombstones = false;
 }
 
 void Location::resourcePhase(FSM::Rng& rng)
 {
   splitResources(rng);
-  cleanDeadIndividuals();
+  _hasTombstones = true;
 
   for (auto& source : _sources)
   {
@@ -142,27 +241,66 @@ void Location::resourcePhase(FSM::Rng& rng)
 
 void Location::maintenancePhase(FSM::Rng& rng)
 {
-  for (auto& individual : _individuals)
+  const auto phase_seed = rng();
+  Parallel::forEach(chunk_count(_population.size()), _threadCount,
+      [this, phase_seed](std::size_t chunk)
   {
-    individual.performMaintenance(rng);
-  }
-  cleanDeadIndividuals();
+    _population.performMaintenance(chunk * CHUNK_SIZE, chunk_end(chunk, _population.size()),
+        phase_seed);
+  });
+  _hasTombstones = true;
 }
 
 void Location::reproductionPhase(FSM::Rng& rng)
 {
-  std::vector<Individual> new_individuals;
-  for (auto& individual : _individuals)
+  const auto phase_seed = rng();
+  const auto parent_count = _population.size();
+  const auto chunks = chunk_count(parent_count);
+  if (_reproductionPlans.size() < chunks)
   {
-    if (individual.willReproduce(rng))
-    {
-      new_individuals.push_back(individual.reproduce(rng));
-    }
+    _reproductionPlans.resize(chunks);
+    _birthOffsets.resize(chunks);
   }
 
-  _individuals.insert(_individuals.end(), new_individuals.begin(), new_individuals.end());
+  // The population is not grown yet, so its size is still the parent count.
+  Parallel::forEach(chunks, _threadCount, [this, phase_seed](std::size_t chunk)
+  {
+    _population.planReproduction(chunk * CHUNK_SIZE, chunk_end(chunk, _population.size()),
+        phase_seed, _reproductionPlans[chunk]);
+  });
 
-  cleanDeadIndividuals();
+  auto new_size = parent_count;
+  for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+  {
+    _birthOffsets[chunk] = new_size;
+    new_size += _reproductionPlans[chunk].birthCount;
+  }
+
+  // Grown geometrically, so a population fluctuating around its carrying capacity does not
+  // reallocate every column whenever it reaches a new maximum.
+  if (new_size > _population.capacity())
+  {
+    _population.reserve(std::max(new_size, _population.capacity() + _population.capacity() / 2));
+  }
+  _population.resize(new_size);
+
+  Parallel::forEach(chunks, _threadCount, [this, phase_seed](std::size_t chunk)
+  {
+    _population.reproduce(_reproductionPlans[chunk], phase_seed, _population,
+        _birthOffsets[chunk]);
+  });
+  _hasTombstones = true;
+}
+
+double Location::getCostHint() const
+{
+  double units = 1;
+  for (const auto& source : _sources)
+  {
+    const auto unit_count = source->getCurrentUnitCount();
+    units += (unit_count == Source::INFINITY_UNITS) ? 1 : unit_count;
+  }
+  return static_cast<double>(_population.size()) * units;
 }
 
 void Location::cycle(FSM::Rng& rng)
@@ -170,6 +308,7 @@ void Location::cycle(FSM::Rng& rng)
   resourcePhase(rng);
   maintenancePhase(rng);
   reproductionPhase(rng);
+  cleanDeadIndividuals();
 }
 
 std::string Location::str(unsigned int indentLevel) const
@@ -186,18 +325,45 @@ std::string Location::str(unsigned int indentLevel) const
 
   ss << indent(indentLevel) << "-Individuals:\n";
 
-  for (const auto& individual : _individuals)
+  for (std::size_t index = 0; index < _population.size(); ++index)
   {
-    ss << individual.str(indentLevel + 1);
+    if (!isTombstone(index))
+    {
+      ss << _population.getIndividual(index).str(indentLevel + 1);
+    }
   }
 
   return ss.str();
 }
 
+void Location::save(BinaryWriter& writer) const
+{
+  writer.write(static_cast<std::uint64_t>(_sources.size()));
+  for (const auto& source : _sources)
+  {
+    source->save(writer);
+  }
+
+  if (_hasTombstones)
+  {
+    _population.saveLiving(writer);
+  }
+  else
+  {
+    _population.save(writer);
+  }
+}
+
 void Location::swap(Location& other)
 {
-  std::swap(this->_individuals, other._individuals);
+  std::swap(this->_population, other._population);
   std::swap(this->_sources, other._sources);
+  std::swap(this->_resourceSplitMode, other._resourceSplitMode);
+  std::swap(this->_shardedResourceSplit, other._shardedResourceSplit);
+  std::swap(this->_threadCount, other._threadCount);
+  std::swap(this->_reproductionPlans, other._reproductionPlans);
+  std::swap(this->_birthOffsets, other._birthOffsets);
+  std::swap(this->_hasTombstones, other._hasTombstones);
 }
 
 void Location::doSave(XmlNode& node) const
@@ -210,9 +376,13 @@ void Location::doSave(XmlNode& node) const
 
   auto individuals_node = node.appendChildNode(XML_INDIVIDUALS_NODE_NAME);
 
-  for (const auto& individual : _individuals)
+  for (std::size_t index = 0; index < _population.size(); ++index)
   {
-    individual.save(individuals_node.appendChildNode(Individual::XML_MAIN_NODE_NAME));
+    if (!isTombstone(index))
+    {
+      _population.getIndividual(index).save(
+          individuals_node.appendChildNode(Individual::XML_MAIN_NODE_NAME));
+    }
   }
 }
 
@@ -221,23 +391,83 @@ std::string Location::getDefaultXmlName() const
   return XML_MAIN_NODE_NAME;
 }
 
+bool Location::isTombstone(std::size_t index) const
+{
+  return _hasTombstones && _population.isDead(index);
+}
+
 namespace
 {
 
-unsigned int draw_resource_unit(
-    const std::vector<double>& weights,
-    FSM::Rng& rng)
+/// @brief Gets the number of chunks of a population.
+/// @param size Number of individuals in the population.
+/// @return Number of chunks of Location::CHUNK_SIZE individuals (the last one might be smaller).
+std::size_t chunk_count(std::size_t size)
 {
-  std::discrete_distribution<unsigned int> distribution(weights.begin(), weights.end());
+  return (size + Location::CHUNK_SIZE - 1) / Location::CHUNK_SIZE;
+}
 
-  return distribution(rng);
+/// @brief Gets the end of a chunk of a population.
+/// @param chunk Index of the chunk.
+/// @param size Number of individuals in the population.
+/// @return Index past the last individual of the chunk.
+std::size_t chunk_end(std::size_t chunk, std::size_t size)
+{
+  return std::min(size, (chunk + 1) * Location::CHUNK_SIZE);
 }
 
-bool die_during_feed(
-    const Individual& individual,
-    FSM::Rng& rng)
+PopulationStore read_individuals_in_parallel(XmlStreamReader& reader, unsigned int threadCount)
 {
-  return std::bernoulli_distribution(0.04)(rng);
+  // The individuals are only skipped here, to know the byte range of each chunk.
+  std::vector<std::uint64_t> chunk_offsets;
+  std::size_t individual_count = 0;
+  std::uint64_t end = 0;
+  const auto depth = reader.getDepth();
+  while (reader.nextChildElement(depth))
+  {
+    if (reader.getName() == Individual::XML_MAIN_NODE_NAME)
+    {
+      if (individual_count % Location::CHUNK_SIZE == 0)
+      {
+        chunk_offsets.push_back(reader.getElementOffset());
+      }
+      end = reader.skipElement();
+      ++individual_count;
+    }
+  }
+  if (individual_count == 0)
+  {
+    return {};
+  }
+  chunk_offsets.push_back(end);
+
+  const auto count = chunk_offsets.size() - 1;
+  std::vector<PopulationStore> chunks(count);
+  const auto& file_path = reader.getFilePath();
+  Parallel::forEach(count, threadCount, [&chunks, &chunk_offsets, &file_path](std::size_t chunk)
+  {
+    XmlStreamReader chunk_reader{file_path, chunk_offsets[chunk], chunk_offsets[chunk + 1]};
+    chunks[chunk].reserve(Location::CHUNK_SIZE);
+    do
+    {
+      if (chunk_reader.getName() == Individual::XML_MAIN_NODE_NAME)
+      {
+        chunks[chunk].addIndividual(Individual(chunk_reader));
+      }
+    }
+    while (chunk_reader.nextElement());
+  });
+
+  // The chunks are concatenated in order, so the population is the same as read serially.
+  PopulationStore population;
+  population.reserve(individual_count);
+  for (auto& chunk : chunks)
+  {
+    population.append(chunk);
+    chunk = PopulationStore{};
+  }
+
+  return population;
 }
 
 } // anonymous namespace
@@ -3,6 +3,7 @@
 #include "fictional-fiesta/world/itf/Phenotype.h"
 
 #include "fictional-fiesta/utils/itf/XmlNode.h"
+#include "fictional-fiesta/utils/itf/XmlStreamReader.h"
 
 #include <sstream>
 
@@ -12,6 +13,8 @@ namespace fictionalfiesta
 namespace
 {
   constexpr char XML_ENERGY_NAME[]{"Energy"};
+
+  double read_energy(XmlStreamReader& reader);
 } // anonymous namespace
 
 Phenotype::Phenotype(double initialEnergy):
@@ -24,6 +27,11 @@ Phenotype::Phenotype(const XmlNode& node):
 {
 }
 
+Phenotype::Phenotype(XmlStreamReader& reader):
+  _energy(read_energy(reader))
+{
+}
+
 double Phenotype::getEnergy() const
 {
   return _energy;
@@ -77,4 +85,25 @@ bool operator!=(const Phenotype& lhs, const Phenotype& rhs)
   return !(lhs == rhs);
 }
 
+namespace
+{
+
+double read_energy(XmlStreamReader& reader)
+{
+  std::optional<double> energy;
+  const auto depth = reader.getDepth();
+  while (reader.nextChildElement(depth))
+  {
+    if (reader.getName() == XML_ENERGY_NAME)
+    {
+      energy = reader.getTextAs<double>();
+    }
+  }
+
+  return XmlStreamReader::getMandatory(std::move(energy), Phenotype::XML_MAIN_NODE_NAME,
+      XML_ENERGY_NAME);
+}
+
+} // anonymous namespace
+
 } // namespace fictionalfiesta
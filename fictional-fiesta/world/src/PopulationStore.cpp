@@ -0,0 +1,589 @@
+/// @file PopulationStore.cpp Implementation of the PopulationStore class.
+
+#include "fictional-fiesta/world/itf/PopulationStore.h"
+
+#include "fictional-fiesta/world/itf/Genotype.h"
+#include "fictional-fiesta/world/itf/Individual.h"
+#include "fictional-fiesta/world/itf/Phenotype.h"
+
+#include "fictional-fiesta/utils/itf/BinaryReader.h"
+#include "fictional-fiesta/utils/itf/BinaryWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+namespace fictionalfiesta
+{
+
+namespace
+{
+
+template <typename T>
+void remove_flagged(std::vector<T>& column, const PopulationStore::DeadFlags& flags);
+
+template <typename T>
+std::size_t column_bytes(const std::vector<T>& column);
+
+template <typename Stored, typename Column>
+void save_column(BinaryWriter& writer, const Column& column);
+
+template <typename Stored, typename Column>
+void save_living_column(BinaryWriter& writer, const Column& column,
+    const PopulationStore::DeadFlags& flags);
+
+template <typename Stored, typename Column>
+void load_column(BinaryReader& reader, std::size_t size, Column& column);
+
+} // anonymous namespace
+
+static_assert(sizeof(unsigned int) == sizeof(std::uint32_t),
+    "The resource counts are saved as 32-bit unsigned integers.");
+
+PopulationStore::PopulationStore(BinaryReader& reader)
+{
+  const auto size = static_cast<std::size_t>(reader.read<std::uint64_t>());
+  load_column<double>(reader, size, _reproductionEnergyThresholds);
+  load_column<double>(reader, size, _reproductionProbabilities);
+  load_column<double>(reader, size, _mutabilityRatios);
+  load_column<double>(reader, size, _energies);
+  load_column<std::uint32_t>(reader, size, _resourceCounts);
+  load_column<unsigned char>(reader, size, _deadFlags);
+}
+
+std::size_t PopulationStore::size() const noexcept
+{
+  return _energies.size();
+}
+
+std::size_t PopulationStore::getDeadCount() const noexcept
+{
+  // Not kept as a member, so the individuals can be killed concurrently.
+  return static_cast<std::size_t>(std::count(_deadFlags.begin(), _deadFlags.end(), true));
+}
+
+bool PopulationStore::empty() const noexcept
+{
+  return _energies.empty();
+}
+
+void PopulationStore::reserve(std::size_t capacity)
+{
+  _reproductionEnergyThresholds.reserve(capacity);
+  _reproductionProbabilities.reserve(capacity);
+  _mutabilityRatios.reserve(capacity);
+  _energies.reserve(capacity);
+  _resourceCounts.reserve(capacity);
+  _deadFlags.reserve(capacity);
+}
+
+std::size_t PopulationStore::capacity() const noexcept
+{
+  return _energies.capacity();
+}
+
+void PopulationStore::clear() noexcept
+{
+  _reproductionEnergyThresholds.clear();
+  _reproductionProbabilities.clear();
+  _mutabilityRatios.clear();
+  _energies.clear();
+  _resourceCounts.clear();
+  _deadFlags.clear();
+}
+
+void PopulationStore::resize(std::size_t size)
+{
+  _reproductionEnergyThresholds.resize(size);
+  _reproductionProbabilities.resize(size);
+  _mutabilityRatios.resize(size);
+  _energies.resize(size);
+  _resourceCounts.resize(size);
+  _deadFlags.resize(size, false);
+}
+
+std::size_t PopulationStore::getMemoryUsage() const noexcept
+{
+  return column_bytes(_reproductionEnergyThresholds) + column_bytes(_reproductionProbabilities) +
+      column_bytes(_mutabilityRatios) + column_bytes(_energies) + column_bytes(_resourceCounts) +
+      column_bytes(_deadFlags);
+}
+
+void PopulationStore::addIndividual(const Individual& individual)
+{
+  append(individual.getGenotype(), individual.getPhenotype().getEnergy(),
+      individual.getResourceCount(), individual.isDead());
+}
+
+void PopulationStore::append(const PopulationStore& other)
+{
+  _reproductionEnergyThresholds.insert(_reproductionEnergyThresholds.end(),
+      other._reproductionEnergyThresholds.begin(), other._reproductionEnergyThresholds.end());
+  _reproductionProbabilities.insert(_reproductionProbabilities.end(),
+      other._reproductionProbabilities.begin(), other._reproductionProbabilities.end());
+  _mutabilityRatios.insert(_mutabilityRatios.end(), other._mutabilityRatios.begin(),
+      other._mutabilityRatios.end());
+  _energies.insert(_energies.end(), other._energies.begin(), other._energies.end());
+  _resourceCounts.insert(_resourceCounts.end(), other._resourceCounts.begin(),
+      other._resourceCounts.end());
+  _deadFlags.insert(_deadFlags.end(), other._deadFlags.begin(), other._deadFlags.end());
+}
+
+Individual PopulationStore::getIndividual(std::size_t index) const
+{
+  auto individual = Individual{getGenotype(index), _energies[index]};
+  individual.feed(_resourceCounts[index]);
+  if (_deadFlags[index])
+  {
+    individual.die();
+  }
+  return individual;
+}
+
+void PopulationStore::setIndividual(std::size_t index, const Individual& individual)
+{
+  const auto& genotype = individual.getGenotype();
+  _reproductionEnergyThresholds[index] =
+      static_cast<Trait>(genotype.getReproductionEnergyThreshold());
+  _reproductionProbabilities[index] = static_cast<Trait>(genotype.getReproductionProbability());
+  _mutabilityRatios[index] = static_cast<Trait>(genotype.getMutabilityRatio());
+  _energies[index] = individual.getPhenotype().getEnergy();
+  _resourceCounts[index] = individual.getResourceCount();
+  _deadFlags[index] = individual.isDead();
+}
+
+std::vector<Individual> PopulationStore::getIndividuals() const
+{
+  std::vector<Individual> individuals;
+  individuals.reserve(size());
+  for (std::size_t index = 0; index < size(); ++index)
+  {
+    individuals.push_back(getIndividual(index));
+  }
+  return individuals;
+}
+
+Genotype PopulationStore::getGenotype(std::size_t index) const
+{
+  return Genotype{_reproductionEnergyThresholds[index], _reproductionProbabilities[index],
+      _mutabilityRatios[index]};
+}
+
+double PopulationStore::getEnergy(std::size_t index) const
+{
+  return _energies[index];
+}
+
+unsigned int PopulationStore::getResourceCount(std::size_t index) const
+{
+  return _resourceCounts[index];
+}
+
+bool PopulationStore::isDead(std::size_t index) const
+{
+  return _deadFlags[index];
+}
+
+bool PopulationStore::isHungry(std::size_t index) const
+{
+  return _resourceCounts[index] < _energies[index];
+}
+
+unsigned int PopulationStore::getUnitsToSatiety(std::size_t index) const
+{
+  return Individual::unitsToSatiety(_energies[index], _resourceCounts[index]);
+}
+
+void PopulationStore::feed(std::size_t index, unsigned int units)
+{
+  _resourceCounts[index] += units;
+}
+
+void PopulationStore::die(std::size_t index)
+{
+  _deadFlags[index] = true;
+}
+
+template <typename Generator>
+void PopulationStore::performMaintenance(std::size_t index, Generator& rng)
+{
+  const auto surplus = Individual::maintenanceSurplus(_energies[index], _resourceCounts[index],
+      rng);
+  if (surplus)
+  {
+    // Same as Phenotype::feed: the phenotype is currently just energy.
+    _energies[index] += *surplus;
+  }
+  else
+  {
+    die(index);
+  }
+  _resourceCounts[index] = 0;
+}
+
+template <typename Generator>
+bool PopulationStore::willReproduce(std::size_t index, Generator& rng) const
+{
+  return !isDead(index) && getGenotype(index).willReproduce(Phenotype{_energies[index]}, rng);
+}
+
+template <typename Generator>
+bool PopulationStore::reproduce(std::size_t index, Generator& rng)
+{
+  return reproduce(index, rng, *this);
+}
+
+template <typename Generator>
+bool PopulationStore::reproduce(std::size_t index, Generator& rng, PopulationStore& offspring)
+{
+  // Same steps as Individual::reproduce.
+  const auto genotype = getGenotype(index);
+  const auto offspring_genotype = genotype.reproduce(rng);
+  auto phenotype = Phenotype{_energies[index]};
+  const auto offspring_phenotype = phenotype.split(genotype);
+  _energies[index] = phenotype.getEnergy();
+
+  // A stillborn offspring would be removed right away, so it is not even stored.
+  if (genotype.producedDeadlyMutation(rng))
+  {
+    return false;
+  }
+
+  offspring.append(offspring_genotype, offspring_phenotype.getEnergy(), 0, false);
+  return true;
+}
+
+void PopulationStore::performMaintenance(std::size_t begin, std::size_t end, std::uint64_t seed)
+{
+  FSM::StreamBatch::Thresholds thresholds;
+  FSM::StreamBatch::Outcomes starved;
+  for (auto first = begin; first < end; first += FSM::StreamBatch::SIZE)
+  {
+    const auto lanes = std::min(end - first, FSM::StreamBatch::SIZE);
+    thresholds.fill(0);
+    for (std::size_t lane = 0; lane < lanes; ++lane)
+    {
+      const auto index = first + lane;
+      if (!_deadFlags[index])
+      {
+        thresholds[lane] = FSM::StreamBatch::bernoulliThreshold(
+            Individual::starvationProbability(_energies[index], _resourceCounts[index]));
+      }
+    }
+
+    FSM::StreamBatch{seed, first}.bernoulli(0, thresholds, starved);
+
+    for (std::size_t lane = 0; lane < lanes; ++lane)
+    {
+      const auto index = first + lane;
+      if (_deadFlags[index])
+      {
+        continue;
+      }
+
+      if (starved[lane])
+      {
+        die(index);
+      }
+      else
+      {
+        _energies[index] += Individual::survivalSurplus(_energies[index], _resourceCounts[index]);
+      }
+      _resourceCounts[index] = 0;
+    }
+  }
+}
+
+void PopulationStore::reproduce(std::size_t begin, std::size_t end, std::uint64_t seed,
+    PopulationStore& offspring)
+{
+  ReproductionPlan plan;
+  const auto birth_count = planReproduction(begin, end, seed, plan);
+  const auto offset = offspring.size();
+  offspring.resize(offset + birth_count);
+  reproduce(plan, seed, offspring, offset);
+}
+
+std::size_t PopulationStore::planReproduction(std::size_t begin, std::size_t end,
+    std::uint64_t seed, ReproductionPlan& plan) const
+{
+  // Room for every individual of the range, so a plan that is reused does not reallocate.
+  plan.parents.clear();
+  plan.parents.reserve(end - begin);
+  plan.stillborn.clear();
+  plan.stillborn.reserve(end - begin);
+  plan.birthCount = 0;
+
+  FSM::StreamBatch::Thresholds thresholds;
+  FSM::StreamBatch::Outcomes will_reproduce;
+  for (auto first = begin; first < end; first += FSM::StreamBatch::SIZE)
+  {
+    const auto lanes = std::min(end - first, FSM::StreamBatch::SIZE);
+    thresholds.fill(0);
+    for (std::size_t lane = 0; lane < lanes; ++lane)
+    {
+      // Same condition as Genotype::willReproduce.
+      const auto index = first + lane;
+      if (!_deadFlags[index] && _energies[index] >= _reproductionEnergyThresholds[index])
+      {
+        thresholds[lane] = FSM::StreamBatch::bernoulliThreshold(_reproductionProbabilities[index]);
+      }
+    }
+
+    FSM::StreamBatch{seed, first}.bernoulli(0, thresholds, will_reproduce);
+
+    // The parents continue their streams after the value used by the batch. The mutation draw
+    // comes after the four uniform variates of the normal ones.
+    for (std::size_t lane = 0; lane < lanes; ++lane)
+    {
+      if (will_reproduce[lane])
+      {
+        const auto index = first + lane;
+        auto rng = FSM::createStream(seed, {index});
+        rng.discard(5);
+        const bool is_stillborn =
+            rng() < FSM::StreamBatch::bernoulliThreshold(_mutabilityRatios[index]);
+        plan.parents.push_back(index);
+        plan.stillborn.push_back(is_stillborn);
+        plan.birthCount += is_stillborn ? 0 : 1;
+      }
+    }
+  }
+
+  return plan.birthCount;
+}
+
+void PopulationStore::reproduce(const ReproductionPlan& plan, std::uint64_t seed,
+    PopulationStore& offspring, std::size_t offset)
+{
+  // Two Box-Muller pairs per parent, as Genotype::reproduce draws them: three variates are
+  // used and the last one is dropped.
+  constexpr auto PAIR_COUNT = 2 * FSM::StreamBatch::SIZE;
+  std::array<double, PAIR_COUNT> radii;
+  std::array<double, PAIR_COUNT> angles;
+  std::array<double, PAIR_COUNT> first_variates;
+  std::array<double, PAIR_COUNT> second_variates;
+
+  for (std::size_t first = 0; first < plan.parents.size(); first += FSM::StreamBatch::SIZE)
+  {
+    const auto parent_count = std::min(plan.parents.size() - first, FSM::StreamBatch::SIZE);
+    for (std::size_t parent = 0; parent < parent_count; ++parent)
+    {
+      auto rng = FSM::createStream(seed, {plan.parents[first + parent]});
+      rng.discard(1);
+      for (const auto pair : {2 * parent, 2 * parent + 1})
+      {
+        radii[pair] = FSM::NormalGenerator::openUniform(rng);
+        angles[pair] = FSM::NormalGenerator::openUniform(rng);
+      }
+    }
+
+    FSM::NormalGenerator::transform(radii.data(), angles.data(), 2 * parent_count,
+        first_variates.data(), second_variates.data());
+
+    for (std::size_t parent = 0; parent < parent_count; ++parent)
+    {
+      // Same steps as reproduce(std::size_t, Generator&, PopulationStore&).
+      const auto index = plan.parents[first + parent];
+      const auto genotype = getGenotype(index);
+      const auto offspring_genotype = genotype.mutate(first_variates[2 * parent],
+          second_variates[2 * parent], first_variates[2 * parent + 1]);
+      auto phenotype = Phenotype{_energies[index]};
+      const auto offspring_phenotype = phenotype.split(genotype);
+      _energies[index] = phenotype.getEnergy();
+
+      if (!plan.stillborn[first + parent])
+      {
+        offspring.setNewborn(offset++, offspring_genotype, offspring_phenotype.getEnergy());
+      }
+    }
+  }
+}
+
+template void PopulationStore::performMaintenance(std::size_t index, FSM::Rng& rng);
+template void PopulationStore::performMaintenance(std::size_t index, FSM::CounterRng& rng);
+template bool PopulationStore::willReproduce(std::size_t index, FSM::Rng& rng) const;
+template bool PopulationStore::willReproduce(std::size_t index, FSM::CounterRng& rng) const;
+template bool PopulationStore::reproduce(std::size_t index, FSM::Rng& rng);
+template bool PopulationStore::reproduce(std::size_t index, FSM::CounterRng& rng);
+template bool PopulationStore::reproduce(std::size_t index, FSM::Rng& rng,
+    PopulationStore& offspring);
+template bool PopulationStore::reproduce(std::size_t index, FSM::CounterRng& rng,
+    PopulationStore& offspring);
+
+void PopulationStore::save(BinaryWriter& writer) const
+{
+  writer.write(static_cast<std::uint64_t>(size()));
+  save_column<double>(writer, _reproductionEnergyThresholds);
+  save_column<double>(writer, _reproductionProbabilities);
+  save_column<double>(writer, _mutabilityRatios);
+  save_column<double>(writer, _energies);
+  save_column<std::uint32_t>(writer, _resourceCounts);
+  save_column<unsigned char>(writer, _deadFlags);
+}
+
+void PopulationStore::saveLiving(BinaryWriter& writer) const
+{
+  const auto living_count = static_cast<std::uint64_t>(
+      std::count(_deadFlags.begin(), _deadFlags.end(), false));
+  writer.write(living_count);
+  save_living_column<double>(writer, _reproductionEnergyThresholds, _deadFlags);
+  save_living_column<double>(writer, _reproductionProbabilities, _deadFlags);
+  save_living_column<double>(writer, _mutabilityRatios, _deadFlags);
+  save_living_column<double>(writer, _energies, _deadFlags);
+  save_living_column<std::uint32_t>(writer, _resourceCounts, _deadFlags);
+  // All false, as left by removeDead.
+  save_living_column<unsigned char>(writer, _deadFlags, _deadFlags);
+}
+
+void PopulationStore::removeDead()
+{
+  if (std::find(_deadFlags.begin(), _deadFlags.end(), true) == _deadFlags.end())
+  {
+    return;
+  }
+
+  remove_flagged(_reproductionEnergyThresholds, _deadFlags);
+  remove_flagged(_reproductionProbabilities, _deadFlags);
+  remove_flagged(_mutabilityRatios, _deadFlags);
+  remove_flagged(_energies, _deadFlags);
+  remove_flagged(_resourceCounts, _deadFlags);
+
+  // Only the living individuals are left.
+  _deadFlags.assign(_energies.size(), false);
+}
+
+void PopulationStore::setNewborn(std::size_t index, const Genotype& genotype, double energy)
+{
+  _reproductionEnergyThresholds[index] =
+      static_cast<Trait>(genotype.getReproductionEnergyThreshold());
+  _reproductionProbabilities[index] = static_cast<Trait>(genotype.getReproductionProbability());
+  _mutabilityRatios[index] = static_cast<Trait>(genotype.getMutabilityRatio());
+  _energies[index] = energy;
+}
+
+void PopulationStore::append(const Genotype& genotype, double energy,
+    unsigned int resourceCount, bool isDead)
+{
+  _reproductionEnergyThresholds.push_back(
+      static_cast<Trait>(genotype.getReproductionEnergyThreshold()));
+  _reproductionProbabilities.push_back(static_cast<Trait>(genotype.getReproductionProbability()));
+  _mutabilityRatios.push_back(static_cast<Trait>(genotype.getMutabilityRatio()));
+  _energies.push_back(energy);
+  _resourceCounts.push_back(resourceCount);
+  _deadFlags.push_back(isDead);
+}
+
+const std::vector<double>& PopulationStore::getEnergies() const noexcept
+{
+  return _energies;
+}
+
+const std::vector<unsigned int>& PopulationStore::getResourceCounts() const noexcept
+{
+  return _resourceCounts;
+}
+
+const PopulationStore::DeadFlags& PopulationStore::getDeadFlags() const noexcept
+{
+  return _deadFlags;
+}
+
+namespace
+{
+
+template <typename T>
+void remove_flagged(std::vector<T>& column, const PopulationStore::DeadFlags& flags)
+{
+  std::size_t kept = 0;
+  for (std::size_t index = 0; index < column.size(); ++index)
+  {
+    if (!flags[index])
+    {
+      column[kept++] = column[index];
+    }
+  }
+  column.resize(kept);
+}
+
+template <typename T>
+std::size_t column_bytes(const std::vector<T>& column)
+{
+  if constexpr (std::is_same_v<T, bool>)
+  {
+    // Packed in bits.
+    return (column.capacity() + CHAR_BIT - 1) / CHAR_BIT;
+  }
+  else
+  {
+    return column.capacity() * sizeof(T);
+  }
+}
+
+/// @brief Saves a column as an aligned array.
+/// @tparam Stored Type of the elements in the snapshot.
+/// @tparam Column Type of the column.
+/// @param writer Writer of the snapshot.
+/// @param column Column to be saved. It is converted first if its elements are not Stored.
+template <typename Stored, typename Column>
+void save_column(BinaryWriter& writer, const Column& column)
+{
+  if constexpr (std::is_same_v<typename Column::value_type, Stored>)
+  {
+    writer.writeArray(column.data(), column.size());
+  }
+  else
+  {
+    const std::vector<Stored> converted(column.begin(), column.end());
+    writer.writeArray(converted.data(), converted.size());
+  }
+}
+
+/// @brief Saves the elements of the living individuals of a column as an aligned array.
+/// @details Same output as save_column on the column without the dead individuals. The elements
+///   are gathered in blocks whose size is a multiple of the alignment, so the arrays written
+///   for the blocks are contiguous.
+/// @tparam Stored Type of the elements in the snapshot.
+/// @tparam Column Type of the column.
+/// @param writer Writer of the snapshot.
+/// @param column Column to be saved.
+/// @param flags Dead flags of the individuals.
+template <typename Stored, typename Column>
+void save_living_column(BinaryWriter& writer, const Column& column,
+    const PopulationStore::DeadFlags& flags)
+{
+  constexpr std::size_t BLOCK_SIZE{8 * BinaryWriter::ARRAY_ALIGNMENT};
+  std::array<Stored, BLOCK_SIZE> block;
+  std::size_t count = 0;
+  for (std::size_t index = 0; index < column.size(); ++index)
+  {
+    if (!flags[index])
+    {
+      block[count++] = static_cast<Stored>(column[index]);
+      if (count == BLOCK_SIZE)
+      {
+        writer.writeArray(block.data(), count);
+        count = 0;
+      }
+    }
+  }
+  writer.writeArray(block.data(), count);
+}
+
+/// @brief Loads a column saved by save_column.
+/// @tparam Stored Type of the elements in the snapshot.
+/// @tparam Column Type of the column.
+/// @param reader Reader of the snapshot.
+/// @param size Number of elements.
+/// @param column Column where the elements are copied (converted if needed).
+template <typename Stored, typename Column>
+void load_column(BinaryReader& reader, std::size_t size, Column& column)
+{
+  const auto* const values = reader.readArray<Stored>(size);
+  column.assign(values, values + size);
+}
+
+} // anonymous namespace
+
+} // namespace fictionalfiesta
@@ -0,0 +1,513 @@
+/// @file ResourceSplitter.cpp Implementation of the ResourceSplitter class.
+
+#include "fictional-fiesta/world/itf/ResourceSplitter.h"
+
+#include "fictional-fiesta/world/itf/PopulationStore.h"
+#include "fictional-fiesta/world/itf/Source.h"
+#include "fictional-fiesta/world/itf/WeightedSampler.h"
+
+#include "fictional-fiesta/utils/itf/Exception.h"
+#include "fictional-fiesta/utils/itf/Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+
+namespace fictionalfiesta
+{
+
+namespace
+{
+
+bool is_competing(const PopulationStore& population, std::size_t index);
+
+std::vector<double> feeding_weights(const PopulationStore& population, std::size_t begin,
+    std::size_t end);
+
+double total_weight(const PopulationStore& population,
+    const std::vector<std::size_t>& competitors);
+
+double competing_weight(const PopulationStore& population, std::size_t begin, std::size_t end);
+
+void deal_units(unsigned int units, const std::vector<double>& weights,
+    std::vector<unsigned int>& dealtUnits, FSM::Rng& rng);
+
+double competing_demand(const PopulationStore& population, std::size_t begin, std::size_t end);
+
+template <typename DrawUnits>
+unsigned int split_in_rounds(unsigned int units, PopulationStore& population, std::size_t begin,
+    std::size_t end, bool redistribute, FSM::Rng& rng, DrawUnits drawUnits);
+
+/// @brief Stream of the resource units consumed in a split that knows which of them are fatal.
+/// @details Each unit kills the individual eating it with a fixed probability, so the gap
+///   between two fatal units is geometric. Skipping from one fatal unit to the next makes the
+///   number of random draws proportional to the deaths instead of to the units consumed.
+class FeedingDeathStream
+{
+  public:
+
+    /// @brief Constructor from the random number generator.
+    /// @param rng Random number generator used to draw the fatal units.
+    explicit FeedingDeathStream(FSM::Rng& rng);
+
+    /// @brief Feeds an individual with the next units of the stream.
+    /// @details The individual stops eating (and dies) if one of the units is fatal.
+    /// @param population Population of the individual.
+    /// @param index Index of the individual to be fed.
+    /// @param units Units offered to the individual.
+    /// @return Units actually eaten by the individual.
+    unsigned long long feed(PopulationStore& population, std::size_t index,
+        unsigned long long units);
+
+  private:
+
+    /// Random number generator.
+    FSM::Rng& _rng;
+
+    /// Distribution of the number of safe units between two fatal ones.
+    std::geometric_distribution<unsigned long long> _safeUnits;
+
+    /// Units left until the next fatal one (included). Zero if it has not been drawn yet.
+    unsigned long long _unitsUntilDeath = 0;
+};
+
+} // anonymous namespace
+
+static_assert(ResourceSplitter::SHARD_SIZE % PopulationStore::DEAD_FLAG_ALIGNMENT == 0,
+    "The shards split in parallel must not share dead flags.");
+
+void ResourceSplitter::split(Mode mode, Source& source, PopulationStore& population,
+    FSM::Rng& rng)
+{
+  if (source.empty())
+  {
+    return;
+  }
+
+  if (source.getCurrentUnitCount() == Source::INFINITY_UNITS)
+  {
+    splitInfinite(population, 0, population.size(), rng);
+    return;
+  }
+
+  source.consume(splitRange(mode, source.getCurrentUnitCount(), population, 0,
+      population.size(), true, rng));
+}
+
+void ResourceSplitter::splitSharded(Mode mode, Source& source, PopulationStore& population,
+    FSM::Rng& rng, unsigned int threadCount)
+{
+  if (source.empty())
+  {
+    return;
+  }
+
+  const auto size = population.size();
+  const auto shard_count = (size + SHARD_SIZE - 1) / SHARD_SIZE;
+  const auto shard_end = [size](std::size_t shard)
+  {
+    return std::min(size, (shard + 1) * SHARD_SIZE);
+  };
+
+  if (source.getCurrentUnitCount() == Source::INFINITY_UNITS)
+  {
+    const std::uint64_t seed = rng();
+    Parallel::forEach(shard_count, threadCount, [&](std::size_t shard)
+    {
+      auto shard_rng = FSM::createRng(seed, shard);
+      splitInfinite(population, shard * SHARD_SIZE, shard_end(shard), shard_rng);
+    });
+    return;
+  }
+
+  std::vector<double> weights(shard_count);
+  std::vector<double> demands(shard_count);
+  std::vector<unsigned int> shard_units(shard_count);
+  auto remaining_units = source.getCurrentUnitCount();
+
+  // Every round feeds at least an individual, since the first unit of every shard goes to a
+  // competitor.
+  while (remaining_units > 0)
+  {
+    Parallel::forEach(shard_count, threadCount, [&](std::size_t shard)
+    {
+      weights[shard] = competing_weight(population, shard * SHARD_SIZE, shard_end(shard));
+      demands[shard] = competing_demand(population, shard * SHARD_SIZE, shard_end(shard));
+    });
+
+    if (std::all_of(weights.begin(), weights.end(), [](double weight) { return weight <= 0; }))
+    {
+      break;
+    }
+
+    // There is no point in handing out more units than the ones that can be eaten.
+    const auto demand = std::accumulate(demands.begin(), demands.end(), 0.0);
+    deal_units(static_cast<unsigned int>(std::min<double>(remaining_units, demand)), weights,
+        shard_units, rng);
+
+    const std::uint64_t seed = rng();
+    Parallel::forEach(shard_count, threadCount, [&](std::size_t shard)
+    {
+      if (shard_units[shard] > 0)
+      {
+        auto shard_rng = FSM::createRng(seed, shard);
+        shard_units[shard] = splitRange(mode, shard_units[shard], population,
+            shard * SHARD_SIZE, shard_end(shard), false, shard_rng);
+      }
+    });
+
+    const auto consumed_units = std::accumulate(shard_units.begin(), shard_units.end(), 0u);
+    source.consume(consumed_units);
+    remaining_units -= consumed_units;
+  }
+}
+
+ResourceSplitter::Mode ResourceSplitter::modeFromString(const std::string& name)
+{
+  if (name == "unit")
+  {
+    return Mode::Unit;
+  }
+
+  if (name == "bulk")
+  {
+    return Mode::Bulk;
+  }
+
+  if (name == "sweep")
+  {
+    return Mode::Sweep;
+  }
+
+  throw Exception("Unknown resource split mode '" + name + "'.");
+}
+
+std::string ResourceSplitter::modeToString(Mode mode)
+{
+  switch (mode)
+  {
+    case Mode::Unit:
+      return "unit";
+    case Mode::Bulk:
+      return "bulk";
+    case Mode::Sweep:
+      return "sweep";
+  }
+
+  throw Exception("Unknown resource split mode.");
+}
+
+unsigned int ResourceSplitter::splitRange(Mode mode, unsigned int units,
+    PopulationStore& population, std::size_t begin, std::size_t end, bool redistribute,
+    FSM::Rng& rng)
+{
+  switch (mode)
+  {
+    case Mode::Unit:
+      return splitUnits(units, population, begin, end, redistribute, rng);
+    case Mode::Bulk:
+      return splitBulk(units, population, begin, end, redistribute, rng);
+    case Mode::Sweep:
+      return splitSweep(units, population, begin, end, redistribute, rng);
+  }
+  return 0;
+}
+
+unsigned int ResourceSplitter::splitUnits(unsigned int units, PopulationStore& population,
+    std::size_t begin, std::size_t end, bool redistribute, FSM::Rng& rng)
+{
+  // The sampler is built once per source and only updated when an individual stops competing.
+  WeightedSampler sampler(feeding_weights(population, begin, end));
+  FeedingDeathStream feeding_deaths(rng);
+
+  unsigned int consumed_units = 0;
+  for (unsigned int unit = 0; unit < units && !sampler.empty(); ++unit)
+  {
+    const auto sample = sampler.draw(rng);
+    const auto individual_index = begin + sample;
+
+    // Without redistribution, the units that go to individuals that stopped competing are left.
+    if (is_competing(population, individual_index))
+    {
+      consumed_units += static_cast<unsigned int>(
+          feeding_deaths.feed(population, individual_index, 1));
+    }
+
+    if (redistribute && !is_competing(population, individual_index))
+    {
+      sampler.setWeight(sample, 0);
+    }
+  }
+  return consumed_units;
+}
+
+unsigned int ResourceSplitter::splitBulk(unsigned int units, PopulationStore& population,
+    std::size_t begin, std::size_t end, bool redistribute, FSM::Rng& rng)
+{
+  // The multinomial draw is done as a sequence of conditional binomials.
+  return split_in_rounds(units, population, begin, end, redistribute, rng, [&population, &rng](
+      const std::vector<std::size_t>& competitors, unsigned long long units,
+      std::vector<unsigned long long>& competitorUnits)
+  {
+    auto remaining_weight = total_weight(population, competitors);
+    for (std::size_t position = 0; position < competitors.size() && units > 0; ++position)
+    {
+      const auto weight = population.getEnergy(competitors[position]);
+      const bool is_last = (position + 1 == competitors.size());
+      const auto probability = (is_last || weight >= remaining_weight) ?
+          1.0 : weight / remaining_weight;
+      competitorUnits[position] =
+          std::binomial_distribution<unsigned long long>(units, probability)(rng);
+      units -= competitorUnits[position];
+      remaining_weight -= weight;
+    }
+  });
+}
+
+unsigned int ResourceSplitter::splitSweep(unsigned int units, PopulationStore& population,
+    std::size_t begin, std::size_t end, bool redistribute, FSM::Rng& rng)
+{
+  return split_in_rounds(units, population, begin, end, redistribute, rng, [&population, &rng](
+      const std::vector<std::size_t>& competitors, unsigned long long units,
+      std::vector<unsigned long long>& competitorUnits)
+  {
+    // The largest of k uniforms is distributed as V^(1/k), so the sorted uniforms are generated
+    // from the top down, U(k) = U(k+1) V^(1/k), without storing them. Their logarithm is
+    // accumulated instead, as -log(V) is an exponential variate.
+    std::exponential_distribution<double> exponential;
+    const auto total = total_weight(population, competitors);
+
+    // Merge the sorted uniforms (scaled to the total weight) with the cumulative weights, from
+    // the last competitor down.
+    auto position = competitors.size() - 1;
+    double lower_weight = total - population.getEnergy(competitors[position]);
+    double log_uniform = 0;
+    for (auto remaining = units; remaining > 0; --remaining)
+    {
+      log_uniform -= exponential(rng) / static_cast<double>(remaining);
+      const auto uniform = std::exp(log_uniform) * total;
+      while (uniform < lower_weight && position > 0)
+      {
+        --position;
+        lower_weight -= population.getEnergy(competitors[position]);
+      }
+      ++competitorUnits[position];
+    }
+  });
+}
+
+void ResourceSplitter::splitInfinite(PopulationStore& population, std::size_t begin,
+    std::size_t end, FSM::Rng& rng)
+{
+  // Without scarcity the order in which the units are handed out does not matter: every
+  // individual eats until it is satiated unless it dies first.
+  FeedingDeathStream feeding_deaths(rng);
+
+  for (auto index = begin; index < end; ++index)
+  {
+    if (is_competing(population, index))
+    {
+      feeding_deaths.feed(population, index, population.getUnitsToSatiety(index));
+    }
+  }
+}
+
+namespace
+{
+
+bool is_competing(const PopulationStore& population, std::size_t index)
+{
+  return !population.isDead(index) && population.isHungry(index);
+}
+
+std::vector<double> feeding_weights(const PopulationStore& population, std::size_t begin,
+    std::size_t end)
+{
+  // Plain loop over the columns, so it can be vectorized.
+  const auto& energies = population.getEnergies();
+  const auto& resource_counts = population.getResourceCounts();
+  const auto& dead_flags = population.getDeadFlags();
+
+  std::vector<double> weights(end - begin);
+  for (std::size_t position = 0; position < weights.size(); ++position)
+  {
+    const auto index = begin + position;
+    const bool is_competing = !dead_flags[index] && resource_counts[index] < energies[index];
+    weights[position] = is_competing ? energies[index] : 0.0;
+  }
+  return weights;
+}
+
+double total_weight(const PopulationStore& population,
+    const std::vector<std::size_t>& competitors)
+{
+  double total = 0;
+  for (const auto index : competitors)
+  {
+    total += population.getEnergy(index);
+  }
+  return total;
+}
+
+double competing_weight(const PopulationStore& population, std::size_t begin, std::size_t end)
+{
+  const auto& energies = population.getEnergies();
+  const auto& resource_counts = population.getResourceCounts();
+  const auto& dead_flags = population.getDeadFlags();
+
+  double weight = 0;
+  for (auto index = begin; index < end; ++index)
+  {
+    const bool is_competing = !dead_flags[index] && resource_counts[index] < energies[index];
+    weight += is_competing ? energies[index] : 0.0;
+  }
+  return weight;
+}
+
+double competing_demand(const PopulationStore& population, std::size_t begin, std::size_t end)
+{
+  double demand = 0;
+  for (auto index = begin; index < end; ++index)
+  {
+    if (is_competing(population, index))
+    {
+      demand += population.getUnitsToSatiety(index);
+    }
+  }
+  return demand;
+}
+
+/// @brief Deals some units with a multinomial draw, as a sequence of conditional binomials.
+/// @param units Units to be dealt.
+/// @param weights Weight of each receiver. At least one of them must be positive.
+/// @param dealtUnits Units dealt to each receiver. Resized to the number of weights.
+/// @param rng Random number generator.
+void deal_units(unsigned int units, const std::vector<double>& weights,
+    std::vector<unsigned int>& dealtUnits, FSM::Rng& rng)
+{
+  dealtUnits.assign(weights.size(), 0);
+
+  // The last receiver with weight takes the rest, whatever the rounding errors.
+  std::size_t last = weights.size() - 1;
+  while (weights[last] <= 0)
+  {
+    --last;
+  }
+
+  double remaining_weight = 0;
+  for (const auto weight : weights)
+  {
+    remaining_weight += std::max(weight, 0.0);
+  }
+
+  for (std::size_t position = 0; position <= last && units > 0; ++position)
+  {
+    const auto weight = std::max(weights[position], 0.0);
+    const auto probability = (position == last || weight >= remaining_weight) ?
+        1.0 : weight / remaining_weight;
+    dealtUnits[position] = std::binomial_distribution<unsigned int>(units, probability)(rng);
+    units -= dealtUnits[position];
+    remaining_weight -= weight;
+  }
+}
+
+template <typename DrawUnits>
+unsigned int split_in_rounds(unsigned int units, PopulationStore& population, std::size_t begin,
+    std::size_t end, bool redistribute, FSM::Rng& rng, DrawUnits drawUnits)
+{
+  std::vector<std::size_t> competitors;
+  unsigned long long demand = 0;
+  for (auto index = begin; index < end; ++index)
+  {
+    if (is_competing(population, index))
+    {
+      competitors.push_back(index);
+      demand += population.getUnitsToSatiety(index);
+    }
+  }
+
+  // There is no point in handing out more units than the ones that can be eaten.
+  auto remaining_units = std::min<unsigned long long>(demand, units);
+  unsigned long long consumed_units = 0;
+
+  FeedingDeathStream feeding_deaths(rng);
+  std::vector<unsigned long long> competitor_units;
+
+  // Each round hands out all the remaining units at once. The units that could not be eaten
+  // because the individual got satiated or died are redistributed in the following round, with
+  // one competitor less at least.
+  while (remaining_units > 0 && !competitors.empty())
+  {
+    competitor_units.assign(competitors.size(), 0);
+    drawUnits(competitors, remaining_units, competitor_units);
+    remaining_units = 0;
+
+    std::size_t kept_competitors = 0;
+    for (std::size_t position = 0; position < competitors.size(); ++position)
+    {
+      const auto index = competitors[position];
+      const auto units = competitor_units[position];
+
+      if (units > 0)
+      {
+        const auto eaten_units = feeding_deaths.feed(population, index,
+            std::min<unsigned long long>(units, population.getUnitsToSatiety(index)));
+        consumed_units += eaten_units;
+        remaining_units += units - eaten_units;
+      }
+
+      if (is_competing(population, index))
+      {
+        competitors[kept_competitors++] = competitors[position];
+      }
+    }
+
+    competitors.resize(kept_competitors);
+
+    if (!redistribute)
+    {
+      break;
+    }
+  }
+
+  // Never more than the units available.
+  return static_cast<unsigned int>(consumed_units);
+}
+
+FeedingDeathStream::FeedingDeathStream(FSM::Rng& rng):
+  _rng(rng),
+  _safeUnits(ResourceSplitter::FEEDING_DEATH_PROBABILITY)
+{
+}
+
+unsigned long long FeedingDeathStream::feed(PopulationStore& population, std::size_t index,
+    unsigned long long units)
+{
+  if (units == 0)
+  {
+    return 0;
+  }
+
+  if (_unitsUntilDeath == 0)
+  {
+    _unitsUntilDeath = _safeUnits(_rng) + 1;
+  }
+
+  if (units < _unitsUntilDeath)
+  {
+    _unitsUntilDeath -= units;
+    population.feed(index, static_cast<unsigned int>(units));
+    return units;
+  }
+
+  const auto eaten_units = _unitsUntilDeath;
+  _unitsUntilDeath = 0;
+  population.feed(index, static_cast<unsigned int>(eaten_units));
+  population.die(index);
+  return eaten_units;
+}
+
+} // anonymous namespace
+
+} // namespace fictionalfiesta
@@ -0,0 +1,172 @@
+/// @file RngEngines.cpp Implementation of the random number engines.
+
+#include "fictional-fiesta/world/itf/RngEngines.h"
+
+namespace fictionalfiesta
+{
+
+namespace
+{
+
+/// Increment of the SplitMix64 state (golden ratio).
+constexpr std::uint64_t SPLIT_MIX_GAMMA{0x9e3779b97f4a7c15ULL};
+
+/// Default stream of the reference pcg64 (its default 128-bit increment is twice this plus one).
+constexpr std::uint64_t PCG_DEFAULT_STREAM_HIGH{0x2c28fa16a64abf96ULL};
+constexpr std::uint64_t PCG_DEFAULT_STREAM_LOW{0x8a02bdbf7bb3c0a7ULL};
+
+std::uint64_t split_mix(std::uint64_t& state) noexcept;
+
+} // anonymous namespace
+
+Xoshiro256PlusPlus::Xoshiro256PlusPlus(result_type seed) noexcept
+{
+  for (auto& word : _state)
+  {
+    word = split_mix(seed);
+  }
+  fixState();
+}
+
+void Xoshiro256PlusPlus::discard(unsigned long long count) noexcept
+{
+  for (unsigned long long index = 0; index < count; ++index)
+  {
+    (*this)();
+  }
+}
+
+bool Xoshiro256PlusPlus::operator==(const Xoshiro256PlusPlus& other) const noexcept
+{
+  return _state == other._state;
+}
+
+bool Xoshiro256PlusPlus::operator!=(const Xoshiro256PlusPlus& other) const noexcept
+{
+  return !(*this == other);
+}
+
+std::ostream& operator<<(std::ostream& stream, const Xoshiro256PlusPlus& engine)
+{
+  const char* separator = "";
+  for (const auto word : engine._state)
+  {
+    stream << separator << word;
+    separator = " ";
+  }
+  return stream;
+}
+
+std::istream& operator>>(std::istream& stream, Xoshiro256PlusPlus& engine)
+{
+  std::array<std::uint64_t, 4> state;
+  for (auto& word : state)
+  {
+    stream >> word;
+  }
+
+  // The all-zero state is a fixed point, so it can not be a saved state.
+  if (state == std::array<std::uint64_t, 4>{})
+  {
+    stream.setstate(std::ios::failbit);
+  }
+  if (stream)
+  {
+    engine._state = state;
+  }
+  return stream;
+}
+
+void Xoshiro256PlusPlus::fixState() noexcept
+{
+  // The all-zero state is a fixed point.
+  if (_state[0] == 0 && _state[1] == 0 && _state[2] == 0 && _state[3] == 0)
+  {
+    _state[0] = SPLIT_MIX_GAMMA;
+  }
+}
+
+Pcg64::Pcg64(result_type seed) noexcept
+{
+  this->seed(seed, (static_cast<State>(PCG_DEFAULT_STREAM_HIGH) << 64) | PCG_DEFAULT_STREAM_LOW);
+}
+
+Pcg64::Pcg64(result_type seed, result_type stream) noexcept
+{
+  this->seed(seed, stream);
+}
+
+void Pcg64::discard(unsigned long long count) noexcept
+{
+  for (unsigned long long index = 0; index < count; ++index)
+  {
+    (*this)();
+  }
+}
+
+bool Pcg64::operator==(const Pcg64& other) const noexcept
+{
+  return _state == other._state && _increment == other._increment;
+}
+
+bool Pcg64::operator!=(const Pcg64& other) const noexcept
+{
+  return !(*this == other);
+}
+
+std::ostream& operator<<(std::ostream& stream, const Pcg64& engine)
+{
+  return stream << static_cast<std::uint64_t>(engine._state >> 64) << ' ' <<
+      static_cast<std::uint64_t>(engine._state) << ' ' <<
+      static_cast<std::uint64_t>(engine._increment >> 64) << ' ' <<
+      static_cast<std::uint64_t>(engine._increment);
+}
+
+std::istream& operator>>(std::istream& stream, Pcg64& engine)
+{
+  std::array<std::uint64_t, 4> halves;
+  for (auto& half : halves)
+  {
+    stream >> half;
+  }
+
+  // The increment is always odd.
+  if ((halves[3] & 1) == 0)
+  {
+    stream.setstate(std::ios::failbit);
+  }
+  if (stream)
+  {
+    engine._state = (static_cast<Pcg64::State>(halves[0]) << 64) | halves[1];
+    engine._increment = (static_cast<Pcg64::State>(halves[2]) << 64) | halves[3];
+  }
+  return stream;
+}
+
+void Pcg64::seed(State seed, State stream) noexcept
+{
+  _increment = (stream << 1) | 1;
+  _state = 0;
+  (*this)();
+  _state += seed;
+  (*this)();
+}
+
+namespace
+{
+
+/// @brief Generates the next SplitMix64 value.
+/// @param state SplitMix64 state, which is advanced.
+/// @return Next value.
+std::uint64_t split_mix(std::uint64_t& state) noexcept
+{
+  state += SPLIT_MIX_GAMMA;
+  auto value = state;
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+  return value ^ (value >> 31);
+}
+
+} // anonymous namespace
+
+} // namespace fictionalfiesta
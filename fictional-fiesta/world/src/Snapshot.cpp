@@ -0,0 +1,175 @@
+/// @file Snapshot.cpp Implementation of the Snapshot class.
+
+#include "fictional-fiesta/world/itf/Snapshot.h"
+
+#include "fictional-fiesta/world/itf/Checkpoint.h"
+#include "fictional-fiesta/world/itf/FSM.h"
+#include "fictional-fiesta/world/itf/World.h"
+
+#include "fictional-fiesta/utils/itf/BinaryReader.h"
+#include "fictional-fiesta/utils/itf/BinaryWriter.h"
+#include "fictional-fiesta/utils/itf/Exception.h"
+
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+namespace fs = std::experimental::filesystem;
+
+namespace fictionalfiesta
+{
+
+namespace
+{
+
+/// Contents of a snapshot.
+enum class Content : std::uint32_t
+{
+  World = 0,
+  Checkpoint = 1
+};
+
+/// Written as is, so it reads differently on a machine with another byte order.
+constexpr std::uint32_t BYTE_ORDER_MARK{0x01020304};
+
+constexpr std::size_t MAGIC_SIZE{sizeof(Snapshot::MAGIC) - 1};
+
+void write_header(BinaryWriter& writer, Content content);
+
+Content read_header(BinaryReader& reader, const fs::path& filePath);
+
+FSM::Rng read_rng(BinaryReader& reader);
+
+} // anonymous namespace
+
+void Snapshot::save(const World& world, const fs::path& filePath)
+{
+  BinaryWriter writer{filePath};
+  write_header(writer, Content::World);
+  world.save(writer);
+  writer.close();
+}
+
+void Snapshot::save(const Checkpoint& checkpoint, const fs::path& filePath)
+{
+  BinaryWriter writer{filePath};
+  write_header(writer, Content::Checkpoint);
+  writer.write(static_cast<std::uint64_t>(checkpoint.getCycleCount()));
+  writer.writeString(FSM::RNG_ENGINE_NAME);
+  writer.writeString(FSM::rngToString(checkpoint.getRng()));
+  const auto& world = checkpoint.getWorld();
+  writer.writeString(ResourceSplitter::modeToString(world.getResourceSplitMode()));
+  writer.write(static_cast<std::uint8_t>(world.isShardedResourceSplit()));
+  world.save(writer);
+  writer.close();
+}
+
+bool Snapshot::isSnapshot(const fs::path& filePath)
+{
+  std::ifstream stream(filePath, std::ios::binary);
+  char magic[MAGIC_SIZE]{};
+  stream.read(magic, MAGIC_SIZE);
+  return stream && std::memcmp(magic, MAGIC, MAGIC_SIZE) == 0;
+}
+
+bool Snapshot::isCheckpoint(const fs::path& filePath)
+{
+  BinaryReader reader{filePath};
+  return read_header(reader, filePath) == Content::Checkpoint;
+}
+
+World Snapshot::loadWorld(const fs::path& filePath)
+{
+  BinaryReader reader{filePath};
+  if (read_header(reader, filePath) == Content::Checkpoint)
+  {
+    // Skip the cycle count, the random number engine and the resource split settings.
+    reader.read<std::uint64_t>();
+    reader.readString();
+    reader.readString();
+    reader.readString();
+    reader.read<std::uint8_t>();
+  }
+  return World{reader};
+}
+
+Checkpoint Snapshot::loadCheckpoint(const fs::path& filePath)
+{
+  BinaryReader reader{filePath};
+  if (read_header(reader, filePath) != Content::Checkpoint)
+  {
+    throw Exception("The snapshot '" + filePath.string() + "' is not a checkpoint.");
+  }
+
+  const auto cycle_count = reader.read<std::uint64_t>();
+  const auto rng = read_rng(reader);
+  const auto split_mode = ResourceSplitter::modeFromString(reader.readString());
+  const auto sharded_split = reader.read<std::uint8_t>() != 0;
+
+  World world{reader};
+  world.setResourceSplitMode(split_mode);
+  world.setShardedResourceSplit(sharded_split);
+  return Checkpoint{std::move(world), rng, cycle_count};
+}
+
+namespace
+{
+
+void write_header(BinaryWriter& writer, Content content)
+{
+  for (std::size_t index = 0; index < MAGIC_SIZE; ++index)
+  {
+    writer.write(Snapshot::MAGIC[index]);
+  }
+  writer.write(BYTE_ORDER_MARK);
+  writer.write(Snapshot::VERSION);
+  writer.write(content);
+}
+
+Content read_header(BinaryReader& reader, const fs::path& filePath)
+{
+  for (std::size_t index = 0; index < MAGIC_SIZE; ++index)
+  {
+    if (reader.read<char>() != Snapshot::MAGIC[index])
+    {
+      throw Exception("The file '" + filePath.string() + "' is not a snapshot.");
+    }
+  }
+
+  if (reader.read<std::uint32_t>() != BYTE_ORDER_MARK)
+  {
+    throw Exception("The snapshot '" + filePath.string() + "' was saved on a machine with "
+        "another byte order.");
+  }
+
+  const auto version = reader.read<std::uint32_t>();
+  if (version != Snapshot::VERSION)
+  {
+    throw Exception("The snapshot '" + filePath.string() + "' has version " +
+        std::to_string(version) + ", but this build reads version " +
+        std::to_string(Snapshot::VERSION) + ".");
+  }
+
+  const auto content = reader.read<Content>();
+  if (content != Content::World && content != Content::Checkpoint)
+  {
+    throw Exception("The snapshot '" + filePath.string() + "' has an unknown content.");
+  }
+  return content;
+}
+
+FSM::Rng read_rng(BinaryReader& reader)
+{
+  const auto engine = reader.readString();
+  if (engine != FSM::RNG_ENGINE_NAME)
+  {
+    throw Exception("The checkpoint was saved with the '" + engine + "' random number engine, "
+        "but this build uses '" + FSM::RNG_ENGINE_NAME + "'.");
+  }
+
+  return FSM::rngFromString(reader.readString());
+}
+
+} // anonymous namespace
+
+} // namespace fictionalfiesta
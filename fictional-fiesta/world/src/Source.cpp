@@ -2,9 +2,16 @@
 
 #include "fictional-fiesta/world/itf/Source.h"
 
+#include "fictional-fiesta/utils/itf/BinaryReader.h"
+#include "fictional-fiesta/utils/itf/BinaryWriter.h"
 #include "fictional-fiesta/utils/itf/Exception.h"
 #include "fictional-fiesta/utils/itf/XmlNode.h"
 
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <limits>
+
 namespace fictionalfiesta
 {
 
@@ -12,6 +19,11 @@ namespace
 {
 constexpr char XML_RESOURCE_ID_NODE_NAME[]{"Resource"};
 constexpr char XML_CURRENT_RESOURCE_UNITS_NAME[]{"CurrentUnits"};
+// The infinite units are written with the first text, but both are read.
+constexpr char XML_INFINITE_UNITS_VALUE[]{"infinite"};
+constexpr char XML_INFINITY_UNITS_VALUE[]{"infinity"};
+
+bool is_infinite_units(const std::string& text);
 }
 
 Source::Source(const std::string& resourceId, unsigned int initialUnitCount):
@@ -22,8 +34,22 @@ Source::Source(const std::string& resourceId, unsigned int initialUnitCount):
 
 Source::Source(const XmlNode& node, unsigned int initialUnitCount):
   _resourceId(node.getChildNodeText(XML_RESOURCE_ID_NODE_NAME)),
-  _currentUnitCount(node.getOptionalChildNodeTextAs<unsigned int>(
-      XML_CURRENT_RESOURCE_UNITS_NAME, initialUnitCount))
+  _currentUnitCount(initialUnitCount)
+{
+  if (node.hasChildNode(XML_CURRENT_RESOURCE_UNITS_NAME))
+  {
+    const auto& units_node = node.getChildNode(XML_CURRENT_RESOURCE_UNITS_NAME);
+    if (!units_node.getOptionalText("").empty())
+    {
+      _currentUnitCount = unitsFromNode(units_node);
+    }
+  }
+}
+
+// The members are initialized in order of declaration, so in the order they were written.
+Source::Source(BinaryReader& reader):
+  _resourceId(reader.readString()),
+  _currentUnitCount(reader.read<std::uint32_t>())
 {
 }
 
@@ -61,6 +87,9 @@ unsigned int Source::consume(const unsigned int requiredUnits)
 
 void Source::save(XmlNode node) const
 {
+  // Before the children, so the node can be streamed.
+  node.setAttribute(XML_SOURCE_TYPE_ATTRIBUTE_NAME, getType());
+
   auto resource_node = node.appendChildNode(XML_RESOURCE_ID_NODE_NAME);
   resource_node.setText(_resourceId);
 
@@ -71,15 +100,37 @@ void Source::save(XmlNode node) const
   doSave(node);
 }
 
+void Source::save(BinaryWriter& writer) const
+{
+  writer.writeString(getType());
+  writer.writeString(_resourceId);
+  writer.write(static_cast<std::uint32_t>(_currentUnitCount));
+
+  // Call to the private virtual method.
+  doSave(writer);
+}
+
 std::string Source::unitsToString(unsigned int units)
 {
   if (units == INFINITY_UNITS)
   {
-    return "infinite";
+    return XML_INFINITE_UNITS_VALUE;
   }
-  std::stringstream ss;
-  ss << units;
-  return ss.str();
+
+  std::array<char, std::numeric_limits<unsigned int>::digits10 + 1> buffer;
+  const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), units);
+  return std::string(buffer.data(), result.ptr);
+}
+
+unsigned int Source::unitsFromNode(const XmlNode& node)
+{
+  if (is_infinite_units(node.getText()))
+  {
+    return INFINITY_UNITS;
+  }
+
+  // Same parsing as the other numbers of the document.
+  return node.getTextAs<unsigned int>();
 }
 
 void Source::setCurrentUnitCount(unsigned int currentUnitCount)
@@ -87,4 +138,22 @@ void Source::setCurrentUnitCount(unsigned int currentUnitCount)
   _currentUnitCount = currentUnitCount;
 }
 
+namespace
+{
+
+bool is_infinite_units(const std::string& text)
+{
+  constexpr char WHITE_SPACES[]{" \t\n\r"};
+  const auto begin = text.find_first_not_of(WHITE_SPACES);
+  if (begin == std::string::npos)
+  {
+    return false;
+  }
+
+  const auto value = text.substr(begin, text.find_last_not_of(WHITE_SPACES) + 1 - begin);
+  return value == XML_INFINITE_UNITS_VALUE || value == XML_INFINITY_UNITS_VALUE;
+}
+
+} // anonymous namespace
+
 } // namespace fictionalfiesta
@@ -5,8 +5,11 @@
 #include "fictional-fiesta/world/itf/ConstantSource.h"
 #include "fictional-fiesta/world/itf/Source.h"
 
+#include "fictional-fiesta/utils/itf/BinaryReader.h"
 #include "fictional-fiesta/utils/itf/Exception.h"
+#include "fictional-fiesta/utils/itf/XmlDocument.h"
 #include "fictional-fiesta/utils/itf/XmlNode.h"
+#include "fictional-fiesta/utils/itf/XmlStreamReader.h"
 
 namespace fictionalfiesta
 {
@@ -25,4 +28,24 @@ std::unique_ptr<Source> SourceFactory::createSource(const XmlNode& node)
   }
 }
 
+std::unique_ptr<Source> SourceFactory::createSource(BinaryReader& reader)
+{
+  const std::string source_type{reader.readString()};
+  if (source_type == ConstantSource::XML_SOURCE_TYPE_ATTRIBUTE_VALUE)
+  {
+    return std::make_unique<ConstantSource>(reader);
+  }
+  else
+  {
+    throw Exception("Unknown source type '" + source_type + "'.");
+  }
+}
+
+std::unique_ptr<Source> SourceFactory::createSource(XmlStreamReader& reader)
+{
+  XmlDocument document;
+  reader.readInto(document.appendRootNode(reader.getName()));
+  return createSource(document.getRootNode());
+}
+
 } // namespace fictionalfiesta
@@ -0,0 +1,171 @@
+/// @file WeightedSampler.cpp Implementation of the WeightedSampler class.
+
+#include "fictional-fiesta/world/itf/WeightedSampler.h"
+
+#include "fictional-fiesta/utils/itf/Exception.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace fictionalfiesta
+{
+
+namespace
+{
+
+void check_weight(double weight);
+
+} // anonymous namespace
+
+WeightedSampler::WeightedSampler(const std::vector<double>& weights):
+  _weights(weights),
+  _tree(weights.size() + 1, 0.0),
+  _positiveCount(0)
+{
+  // Linear time construction: each node pushes its partial sum to its parent.
+  const auto size = _weights.size();
+  for (std::size_t index = 1; index <= size; ++index)
+  {
+    const auto weight = _weights[index - 1];
+    check_weight(weight);
+    if (weight > 0)
+    {
+      ++_positiveCount;
+    }
+
+    _tree[index] += weight;
+    const auto parent = index + (index & (~index + 1));
+    if (parent <= size)
+    {
+      _tree[parent] += _tree[index];
+    }
+  }
+}
+
+std::size_t WeightedSampler::size() const noexcept
+{
+  return _weights.size();
+}
+
+bool WeightedSampler::empty() const noexcept
+{
+  return _positiveCount == 0;
+}
+
+double WeightedSampler::getWeight(std::size_t index) const
+{
+  return _weights.at(index);
+}
+
+double WeightedSampler::getTotalWeight() const
+{
+  if (empty())
+  {
+    return 0;
+  }
+
+  double total = 0;
+  for (auto index = _weights.size(); index > 0; index -= index & (~index + 1))
+  {
+    total += _tree[index];
+  }
+  return total;
+}
+
+void WeightedSampler::setWeight(std::size_t index, double weight)
+{
+  check_weight(weight);
+  const auto old_weight = _weights.at(index);
+
+  if (old_weight > 0 && weight == 0)
+  {
+    --_positiveCount;
+  }
+  else if (old_weight == 0 && weight > 0)
+  {
+    ++_positiveCount;
+  }
+
+  _weights[index] = weight;
+
+  const auto delta = weight - old_weight;
+  for (auto node = index + 1; node < _tree.size(); node += node & (~node + 1))
+  {
+    _tree[node] += delta;
+  }
+}
+
+std::size_t WeightedSampler::draw(FSM::Rng& rng) const
+{
+  // Use the same canonical variate as std::discrete_distribution, so the draws match the ones of
+  // rebuilding the distribution every time equal up to rounding: the Fenwick partial sums might
+  // differ slightly from its normalized cumulative weights, mostly after many weight updates.
+  const auto uniform = std::generate_canonical<double, std::numeric_limits<double>::digits>(rng);
+  return find(uniform * getTotalWeight());
+}
+
+std::size_t WeightedSampler::find(double target) const
+{
+  if (empty())
+  {
+    throw Exception("Cannot draw from a weighted sampler with no positive weights.");
+  }
+
+  const auto size = _weights.size();
+  std::size_t step = 1;
+  while (step <= size / 2)
+  {
+    step *= 2;
+  }
+
+  std::size_t position = 0;
+  for (; step > 0; step /= 2)
+  {
+    const auto next = position + step;
+    if (next <= size && _tree[next] <= target)
+    {
+      position = next;
+      target -= _tree[next];
+    }
+  }
+
+  // Rounding errors in the partial sums might end in an index with no weight, take the closest
+  // one with weight in that case.
+  if (position < size && _weights[position] > 0)
+  {
+    return position;
+  }
+
+  for (auto index = position; index < size; ++index)
+  {
+    if (_weights[index] > 0)
+    {
+      return index;
+    }
+  }
+
+  for (auto index = std::min(position, size); index > 0; --index)
+  {
+    if (_weights[index - 1] > 0)
+    {
+      return index - 1;
+    }
+  }
+
+  return position;
+}
+
+namespace
+{
+
+void check_weight(double weight)
+{
+  if (!(weight >= 0))
+  {
+    throw Exception("Invalid weight for the weighted sampler. It should be non-negative.");
+  }
+}
+
+} // anonymous namespace
+
+} // namespace fictionalfiesta
@@ -2,8 +2,15 @@
 
 #include "fictional-fiesta/world/itf/World.h"
 
-#include "fictional-fiesta/utils/itf/XmlDocument.h"
+#include "fictional-fiesta/utils/itf/BinaryReader.h"
+#include "fictional-fiesta/utils/itf/BinaryWriter.h"
+#include "fictional-fiesta/utils/itf/Parallel.h"
 #include "fictional-fiesta/utils/itf/XmlNode.h"
+#include "fictional-fiesta/utils/itf/XmlStreamReader.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
 
 namespace fictionalfiesta
 {
@@ -13,34 +20,133 @@ namespace
 
 constexpr char XML_LOCATIONS_NODE_NAME[]{"Locations"};
 
-std::vector<Location> load_locations(const XmlNode& node);
+std::vector<Location> load_locations(const XmlNode& node, unsigned int threadCount);
+
+std::vector<Location> read_locations(XmlStreamReader& reader);
+
+std::vector<Location> read_locations_in_parallel(XmlStreamReader& reader,
+    unsigned int threadCount);
+
+}
+
+World::World(const XmlNode& node, unsigned int threadCount):
+  _locations(load_locations(node, threadCount))
+{
+}
 
+World::World(const std::experimental::filesystem::path& xmlPath, unsigned int threadCount)
+{
+  XmlStreamReader reader{xmlPath};
+  *this = World(reader, threadCount);
 }
 
-World::World(const XmlNode& node):
-  _locations(load_locations(node.getChildNode(XML_LOCATIONS_NODE_NAME)))
+World::World(BinaryReader& reader)
 {
+  const auto location_count = reader.read<std::uint64_t>();
+  for (std::uint64_t index = 0; index < location_count; ++index)
+  {
+    _locations.emplace_back(reader);
+  }
 }
 
-World::World(const std::experimental::filesystem::path& xmlPath)
+World::World(XmlStreamReader& reader, unsigned int threadCount)
 {
-  XmlDocument document{xmlPath};
-  _locations = load_locations(document.getRootNode());
+  bool has_locations = false;
+  const auto depth = reader.getDepth();
+  while (reader.nextChildElement(depth))
+  {
+    if (reader.getName() == XML_LOCATIONS_NODE_NAME && !has_locations)
+    {
+      has_locations = true;
+      // The locations of a file can be read again from their byte ranges, in parallel.
+      const auto is_parallel = !reader.getFilePath().empty() &&
+          Parallel::resolveThreadCount(threadCount) > 1;
+      _locations = is_parallel ? read_locations_in_parallel(reader, threadCount) :
+          read_locations(reader);
+    }
+  }
+
+  XmlStreamReader::checkMandatory(has_locations, XML_MAIN_NODE_NAME, XML_LOCATIONS_NODE_NAME);
 }
 
 void World::addLocation(Location&& location)
 {
   _locations.push_back(std::move(location));
+  _locations.back().setResourceSplitMode(_resourceSplitMode);
+  _locations.back().setShardedResourceSplit(_shardedResourceSplit);
+  _locations.back().setThreadCount(_locationThreadCount);
 }
 
-void World::cycle(FSM::Rng& rng)
+void World::setResourceSplitMode(ResourceSplitter::Mode mode)
+{
+  _resourceSplitMode = mode;
+  for (auto& location : _locations)
+  {
+    location.setResourceSplitMode(mode);
+  }
+}
+
+ResourceSplitter::Mode World::getResourceSplitMode() const
+{
+  return _resourceSplitMode;
+}
+
+void World::setShardedResourceSplit(bool sharded)
+{
+  _shardedResourceSplit = sharded;
+  for (auto& location : _locations)
+  {
+    location.setShardedResourceSplit(sharded);
+  }
+}
+
+bool World::isShardedResourceSplit() const
+{
+  return _shardedResourceSplit;
+}
+
+void World::setThreadCount(unsigned int threadCount)
+{
+  _threadCount = threadCount;
+}
+
+unsigned int World::getThreadCount() const
+{
+  return _threadCount;
+}
+
+void World::setLocationThreadCount(unsigned int threadCount)
 {
+  _locationThreadCount = threadCount;
   for (auto& location : _locations)
   {
-    location.cycle(rng);
+    location.setThreadCount(threadCount);
   }
 }
 
+unsigned int World::getLocationThreadCount() const
+{
+  return _locationThreadCount;
+}
+
+void World::cycle(FSM::Rng& rng)
+{
+  const std::uint64_t cycle_seed = rng();
+
+  std::vector<double> costs;
+  costs.reserve(_locations.size());
+  for (const auto& location : _locations)
+  {
+    costs.push_back(location.getCostHint());
+  }
+
+  Parallel::forEach(costs, _threadCount, [this, cycle_seed](std::size_t index)
+  {
+    auto location_rng = FSM::createRng(cycle_seed, index);
+    _locations[index].cycle(location_rng);
+  });
+}
+
 std::string World::str(unsigned int indentLevel) const
 {
   std::stringstream ss;
@@ -55,6 +161,15 @@ std::string World::str(unsigned int indentLevel) const
   return ss.str();
 }
 
+void World::save(BinaryWriter& writer) const
+{
+  writer.write(static_cast<std::uint64_t>(_locations.size()));
+  for (const auto& location : _locations)
+  {
+    location.save(writer);
+  }
+}
+
 void World::doSave(XmlNode& node) const
 {
   auto locations_node = node.appendChildNode(XML_LOCATIONS_NODE_NAME);
@@ -73,20 +188,74 @@ std::string World::getDefaultXmlName() const
 namespace
 {
 
-std::vector<Location> load_locations(const XmlNode& node)
+std::vector<Location> load_locations(const XmlNode& node, unsigned int threadCount)
 {
-  std::vector<Location> locations;
-
   const std::vector<XmlNode> location_nodes = node.getChildNode(XML_LOCATIONS_NODE_NAME).
       getChildNodes(Location::XML_MAIN_NODE_NAME);
-  for (const auto& location_node : location_nodes)
+
+  std::vector<Location> locations(location_nodes.size());
+  Parallel::forEach(location_nodes.size(), threadCount,
+      [&locations, &location_nodes](std::size_t index)
+  {
+    locations[index] = Location(location_nodes[index]);
+  });
+
+  return locations;
+}
+
+std::vector<Location> read_locations(XmlStreamReader& reader)
+{
+  std::vector<Location> locations;
+  const auto depth = reader.getDepth();
+  while (reader.nextChildElement(depth))
   {
-    locations.push_back(Location(location_node));
+    if (reader.getName() == Location::XML_MAIN_NODE_NAME)
+    {
+      locations.emplace_back(reader);
+    }
   }
 
   return locations;
 }
 
+std::vector<Location> read_locations_in_parallel(XmlStreamReader& reader,
+    unsigned int threadCount)
+{
+  // The locations are only skipped here, which is much faster than parsing them, to know the
+  // byte range of each one.
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> ranges;
+  std::vector<double> costs;
+  const auto depth = reader.getDepth();
+  while (reader.nextChildElement(depth))
+  {
+    if (reader.getName() == Location::XML_MAIN_NODE_NAME)
+    {
+      const auto begin = reader.getElementOffset();
+      const auto end = reader.skipElement();
+      ranges.emplace_back(begin, end);
+      costs.push_back(static_cast<double>(end - begin));
+    }
+  }
+
+  // The threads left when there are few locations parse their individuals in parallel.
+  const auto resolved_thread_count = Parallel::resolveThreadCount(threadCount);
+  const auto busy_thread_count = std::min<std::size_t>(resolved_thread_count,
+      std::max<std::size_t>(ranges.size(), 1));
+  const auto location_thread_count = std::max(1u,
+      resolved_thread_count / static_cast<unsigned int>(busy_thread_count));
+
+  std::vector<Location> locations(ranges.size());
+  const auto& file_path = reader.getFilePath();
+  Parallel::forEach(costs, threadCount,
+      [&locations, &ranges, &file_path, location_thread_count](std::size_t index)
+  {
+    XmlStreamReader location_reader{file_path, ranges[index].first, ranges[index].second};
+    locations[index] = Location(location_reader, location_thread_count);
+  });
+
+  return locations;
+}
+
 } // anonymous namespace
 
 } // namespace fictionalfiesta
@@ -0,0 +1,80 @@
+#include "catch/catch.hpp"
+
+#include "fictional-fiesta/utils/itf/BinaryReader.h"
+#include "fictional-fiesta/utils/itf/BinaryWriter.h"
+#include "fictional-fiesta/utils/itf/Exception.h"
+
+#include <experimental/filesystem>
+
+#include <cstdint>
+#include <vector>
+
+namespace fs = std::experimental::filesystem;
+using namespace fictionalfiesta;
+
+static const fs::path result_directory = fs::path(TEST_BINARY_DIRECTORY)
+    / fs::path("fictional-fiesta/utils/result");
+
+TEST_CASE("Test writing and reading a binary file", "[BinaryReaderTest][TestRoundTrip]")
+{
+  const auto file_path = result_directory / fs::path("binary_round_trip.bin");
+  const std::vector<double> values{0.1, -2.5, 1e300, 4.9e-324};
+
+  BinaryWriter writer{file_path};
+  writer.write(std::uint32_t{42});
+  writer.writeString("Light");
+  writer.writeArray(values.data(), values.size());
+  writer.write('x');
+  writer.writeArray(values.data(), 0);
+  CHECK(writer.tell() % BinaryWriter::ARRAY_ALIGNMENT == 0);
+  writer.close();
+
+  BinaryReader reader{file_path};
+  CHECK(reader.size() == fs::file_size(file_path));
+  CHECK(reader.read<std::uint32_t>() == 42);
+  CHECK(reader.readString() == "Light");
+
+  // The arrays are used in place, aligned in the mapping of the file.
+  const auto* const read_values = reader.readArray<double>(values.size());
+  CHECK(reinterpret_cast<std::uintptr_t>(read_values) % BinaryWriter::ARRAY_ALIGNMENT == 0);
+  CHECK(std::vector<double>(read_values, read_values + values.size()) == values);
+
+  CHECK(reader.read<char>() == 'x');
+  reader.readArray<double>(0);
+  CHECK(reader.tell() == reader.size());
+
+  CHECK_THROWS_AS(reader.read<char>(), Exception);
+}
+
+TEST_CASE("Test reading past the end of a binary file", "[BinaryReaderTest][TestTruncated]")
+{
+  const auto file_path = result_directory / fs::path("binary_truncated.bin");
+
+  BinaryWriter writer{file_path};
+  writer.write(std::uint64_t{1000});
+  writer.close();
+
+  SECTION("String")
+  {
+    BinaryReader reader{file_path};
+    CHECK_THROWS_AS(reader.readString(), Exception);
+  }
+
+  SECTION("Array")
+  {
+    BinaryReader reader{file_path};
+    reader.read<std::uint64_t>();
+    CHECK_THROWS_AS(reader.readArray<double>(1), Exception);
+  }
+
+  SECTION("Huge array")
+  {
+    BinaryReader reader{file_path};
+    CHECK_THROWS_AS(reader.readArray<double>(SIZE_MAX / 4), Exception);
+  }
+
+  SECTION("Missing file")
+  {
+    CHECK_THROWS_AS(BinaryReader{result_directory / fs::path("binary_missing.bin")}, Exception);
+  }
+}
@@ -0,0 +1,124 @@
+#include "catch/catch.hpp"
+
+#include "fictional-fiesta/utils/itf/Parallel.h"
+
+#include "fictional-fiesta/utils/itf/Exception.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace fictionalfiesta;
+
+TEST_CASE("Test running every task once", "[ParallelTest][TestForEach]")
+{
+  for (const unsigned int thread_count : {0u, 1u, 2u, 7u, 64u})
+  {
+    for (const std::size_t task_count : {0u, 1u, 5u, 1000u})
+    {
+      std::vector<std::atomic<int>> runs(task_count);
+      Parallel::forEach(task_count, thread_count, [&runs](std::size_t index)
+      {
+        ++runs[index];
+      });
+
+      for (const auto& run : runs)
+      {
+        CHECK(run == 1);
+      }
+    }
+  }
+}
+
+TEST_CASE("Test running every task once with cost hints", "[ParallelTest][TestForEachCosts]")
+{
+  for (const unsigned int thread_count : {0u, 1u, 2u, 7u, 64u})
+  {
+    for (const std::size_t task_count : {0u, 1u, 5u, 1000u})
+    {
+      // Skewed costs: a few expensive tasks and lots of free ones.
+      std::vector<double> costs(task_count, 0.0);
+      for (std::size_t index = 0; index < task_count; index += 7)
+      {
+        costs[index] = static_cast<double>(index * index);
+      }
+
+      std::vector<std::atomic<int>> runs(task_count);
+      Parallel::forEach(costs, thread_count, [&runs](std::size_t index)
+      {
+        ++runs[index];
+      });
+
+      for (const auto& run : runs)
+      {
+        CHECK(run == 1);
+      }
+    }
+  }
+}
+
+TEST_CASE("Test that the most expensive tasks start first", "[ParallelTest][TestCostOrder]")
+{
+  const std::vector<double> costs{1, 5, 0, 5, 100, 2};
+  std::vector<std::size_t> order;
+  Parallel::forEach(costs, 1, [&order](std::size_t index)
+  {
+    order.push_back(index);
+  });
+
+  CHECK(order == std::vector<std::size_t>{4, 1, 3, 5, 0, 2});
+}
+
+TEST_CASE("Test rethrowing the exceptions of the tasks", "[ParallelTest][TestException]")
+{
+  const auto task = [](std::size_t index)
+  {
+    if (index == 42)
+    {
+      throw Exception("Task failed.");
+    }
+  };
+
+  for (const unsigned int thread_count : {1u, 4u})
+  {
+    REQUIRE_THROWS_AS(Parallel::forEach(100, thread_count, task), Exception);
+    REQUIRE_THROWS_AS(Parallel::forEach(std::vector<double>(100, 1.0), thread_count, task),
+        Exception);
+  }
+}
+
+TEST_CASE("Test running the nested calls inline", "[ParallelTest][TestNested]")
+{
+  const std::size_t inner_task_count = 100;
+  std::vector<std::atomic<int>> runs(8 * inner_task_count);
+  std::atomic<bool> nested_inline{true};
+
+  for (int repetition = 0; repetition < 10; ++repetition)
+  {
+    Parallel::forEach(8, 4, [&](std::size_t outer_index)
+    {
+      const auto outer_thread = std::this_thread::get_id();
+      Parallel::forEach(inner_task_count, 4, [&, outer_index](std::size_t inner_index)
+      {
+        ++runs[outer_index * inner_task_count + inner_index];
+        // Whichever thread runs the outer task, the calling one included.
+        if (std::this_thread::get_id() != outer_thread)
+        {
+          nested_inline = false;
+        }
+      });
+    });
+  }
+
+  CHECK(nested_inline);
+  for (const auto& run : runs)
+  {
+    CHECK(run == 10);
+  }
+}
+
+TEST_CASE("Test resolving the thread count", "[ParallelTest][TestResolveThreadCount]")
+{
+  CHECK(Parallel::resolveThreadCount(3) == 3);
+  CHECK(Parallel::resolveThreadCount(0) >= 1);
+}
@@ -4,9 +4,11 @@
 #include "fictional-fiesta/utils/itf/XmlDocument.h"
 #include "fictional-fiesta/utils/itf/XmlNode.h"
 
+#include "test/test_utils/itf/AllocationCounter.h"
 #include "test/test_utils/itf/BenchmarkFiles.h"
 
 #include <experimental/filesystem>
+#include <limits>
 
 namespace fs = std::experimental::filesystem;
 using namespace fictionalfiesta;
@@ -193,6 +195,40 @@ TEST_CASE("Test getting multiple child nodes of other XML nodes", "[XmlNodeTest]
   }
 }
 
+TEST_CASE("Test copying XML nodes", "[XmlNodeTest][TestCopy]")
+{
+  const auto& input_file = input_directory / fs::path("example_2.xml");
+  const auto& document = XmlDocument {input_file};
+  const auto root_node = document.getRootNode();
+
+  // The copies refer to the same node.
+  auto node = root_node.getChildNode("Node2");
+  const XmlNode copy{node};
+  CHECK(copy.getText() == "N2_1");
+
+  node = root_node.getChildNode("Node1");
+  CHECK(node.getAttribute("name") == "fff");
+  CHECK(copy.getName() == "Node2");
+
+  node = copy;
+  CHECK(node.getText() == "N2_1");
+}
+
+TEST_CASE("Test that the node handles do not allocate", "[XmlNodeTest][TestAllocations]")
+{
+  const auto& input_file = input_directory / fs::path("example_3.xml");
+  const auto& document = XmlDocument {input_file};
+  const auto root_node = document.getRootNode();
+
+  const auto allocation_count = getAllocationCount();
+  auto value = root_node.getChildNodeTextAs<int>("Int");
+  value += root_node.getChildNode("UInt").getTextAs<int>();
+  const auto node_copy = root_node;
+  CHECK(getAllocationCount() == allocation_count);
+  CHECK(value == 54);
+  CHECK(node_copy.hasChildNode("Int"));
+}
+
 TEST_CASE("Test getting text as other types", "[XmlNodeTest][TestGetTextAs]")
 {
   const auto& input_file = input_directory / fs::path("example_3.xml");
@@ -304,6 +340,84 @@ TEST_CASE("Test setting text in nodes", "[XmlNodeTest][TestSetText]")
   benchmarkFiles(benchmark_file, result_file, result_directory);
 }
 
+TEST_CASE("Test that characters are written as characters", "[XmlNodeTest][TestSetCharacters]")
+{
+  XmlDocument document{};
+
+  auto root = document.appendRootNode("Root");
+  root.setText('A');
+  CHECK(root.getText() == "A");
+
+  root.setAttribute("signed", static_cast<signed char>('b'));
+  root.setAttribute("unsigned", static_cast<unsigned char>('c'));
+  CHECK(root.getAttribute("signed") == "b");
+  CHECK(root.getAttribute("unsigned") == "c");
+}
+
+TEST_CASE("Test that floating point values are written exactly",
+    "[XmlNodeTest][TestFloatingPointRoundTrip]")
+{
+  XmlDocument document{};
+  auto root = document.appendRootNode("Root");
+
+  // Short values are kept short.
+  root.setText(0.1);
+  CHECK(root.getText() == "0.1");
+  root.setAttribute("float", 42.01f);
+  CHECK(root.getAttribute("float") == "42.01");
+
+  // Any other value reads back to the same one.
+  for (const double value : {1.0 / 3, 2.0 / 3 * 1e-300, 123456.78901234567, 5e-324})
+  {
+    root.setText(value);
+    CHECK(root.getTextAs<double>() == value);
+    root.setAttribute("double", value);
+    CHECK(root.getAttributeAs<double>("double") == value);
+  }
+
+  root.setText(1.0f / 3);
+  CHECK(root.getTextAs<float>() == 1.0f / 3);
+}
+
+TEST_CASE("Test parsing numbers in texts and attributes", "[XmlNodeTest][TestParseNumbers]")
+{
+  XmlDocument document{};
+  auto root = document.appendRootNode("Root");
+
+  root.setAttribute("Value", " +42\n");
+  CHECK(root.getAttributeAs<int>("Value") == 42);
+  root.setAttribute("Value", "-0x1F");
+  CHECK(root.getAttributeAs<long long>("Value") == -31);
+  root.setAttribute("Value", "-2147483648");
+  CHECK(root.getAttributeAs<int>("Value") == std::numeric_limits<int>::min());
+  root.setAttribute("Value", "18446744073709551615");
+  CHECK(root.getAttributeAs<unsigned long long>("Value") ==
+      std::numeric_limits<unsigned long long>::max());
+  root.setAttribute("Value", "Yes");
+  CHECK(root.getAttributeAs<bool>("Value"));
+  root.setAttribute("Value", "");
+  CHECK_FALSE(root.getAttributeAs<bool>("Value"));
+
+  // The texts that are not numbers, or are out of range, are not read as zero.
+  for (const auto& text : {"", "abc", "12abc", "1.5", "+-3", "2147483648", "-2147483649"})
+  {
+    root.setText(text);
+    CHECK_THROWS_AS(root.getTextAs<int>(), Exception);
+  }
+  root.setText("-1");
+  CHECK_THROWS_AS(root.getTextAs<unsigned int>(), Exception);
+  root.setText("1e400");
+  CHECK_THROWS_AS(root.getTextAs<double>(), Exception);
+  root.setText("1e40");
+  CHECK_THROWS_AS(root.getTextAs<float>(), Exception);
+
+  root.setText(std::numeric_limits<long long>::min());
+  CHECK(root.getTextAs<long long>() == std::numeric_limits<long long>::min());
+  root.setText(true);
+  CHECK(root.getText() == "true");
+  CHECK(root.getTextAs<bool>());
+}
+
 TEST_CASE("Test adding child nodes", "[XmlNodeTest][TestAddChildNode]")
 {
   XmlDocument document{};
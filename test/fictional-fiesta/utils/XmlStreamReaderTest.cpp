@@ -0,0 +1,272 @@
+#include "catch/catch.hpp"
+
+#include "fictional-fiesta/utils/itf/Exception.h"
+#include "fictional-fiesta/utils/itf/XmlDocument.h"
+#include "fictional-fiesta/utils/itf/XmlNode.h"
+#include "fictional-fiesta/utils/itf/XmlStreamReader.h"
+
+#include <experimental/filesystem>
+#include <sstream>
+#include <vector>
+
+namespace fs = std::experimental::filesystem;
+using namespace fictionalfiesta;
+
+static const fs::path input_directory = fs::path(TEST_SOURCE_DIRECTORY)
+    / fs::path("fictional-fiesta/utils/input");
+
+TEST_CASE("Test reading the elements in order", "[XmlStreamReaderTest][TestNextChildElement]")
+{
+  XmlStreamReader reader{input_directory / fs::path("example_2.xml")};
+  REQUIRE(reader.getName() == "Example");
+  REQUIRE(reader.getDepth() == 0);
+
+  std::vector<std::string> names;
+  std::vector<std::string> texts;
+  while (reader.nextChildElement(0))
+  {
+    REQUIRE(reader.getDepth() == 1);
+    names.push_back(reader.getName());
+    if (reader.hasAttribute("name"))
+    {
+      names.push_back(reader.getAttribute("name"));
+    }
+    texts.push_back(reader.getText());
+  }
+
+  CHECK(names == std::vector<std::string>{"Node1", "fff", "Node1", "N1_2", "Node2", "Node1",
+      "MyName"});
+  CHECK(texts == std::vector<std::string>{"N1_1", "N1_2", "N2_1", "N1_3"});
+  CHECK_FALSE(reader.nextChildElement(0));
+  CHECK_THROWS_AS(reader.getDepth(), Exception);
+}
+
+TEST_CASE("Test parsing the texts and attributes", "[XmlStreamReaderTest][TestParse]")
+{
+  {
+    XmlStreamReader reader{input_directory / fs::path("example_3.xml")};
+    XmlDocument document{input_directory / fs::path("example_3.xml")};
+    const auto root = document.getRootNode();
+
+    REQUIRE(reader.nextChildElement(0));
+    CHECK(reader.getTextAs<int>() == root.getChildNodeTextAs<int>("Int"));
+    REQUIRE(reader.nextChildElement(0));
+    CHECK(reader.getTextAs<unsigned int>() == root.getChildNodeTextAs<unsigned int>("UInt"));
+    REQUIRE(reader.nextChildElement(0));
+    CHECK(reader.getTextAs<double>() == root.getChildNodeTextAs<double>("Double"));
+    REQUIRE(reader.nextChildElement(0));
+    CHECK(reader.getTextAs<float>() == root.getChildNodeTextAs<float>("Float"));
+    REQUIRE(reader.nextChildElement(0));
+    CHECK(reader.getTextAs<long long>() == root.getChildNodeTextAs<long long>("LongLong"));
+    REQUIRE(reader.nextChildElement(0));
+    CHECK(reader.getTextAs<bool>() == root.getChildNodeTextAs<bool>("Bool"));
+    REQUIRE(reader.nextChildElement(0));
+    CHECK(reader.getTextAs<unsigned long long>() ==
+        root.getChildNodeTextAs<unsigned long long>("ULongLong"));
+  }
+  {
+    std::stringstream stream{"<Root Int='-7' Hex=\"0x1F\" Flag=\"yes\" Ratio=\"0.25\"/>"};
+    XmlStreamReader reader{stream};
+    CHECK(reader.getAttributeAs<int>("Int") == -7);
+    CHECK(reader.getAttributeAs<unsigned int>("Hex") == 31);
+    CHECK(reader.getAttributeAs<bool>("Flag"));
+    CHECK(reader.getAttributeAs<double>("Ratio") == 0.25);
+    CHECK(reader.getOptionalAttributeAs<int>("Missing", 3) == 3);
+    CHECK_THROWS_AS(reader.getAttribute("Missing"), Exception);
+    CHECK_FALSE(reader.nextChildElement(0));
+  }
+}
+
+TEST_CASE("Test decoding the XML syntax", "[XmlStreamReaderTest][TestSyntax]")
+{
+  std::stringstream stream{
+      "<?xml version=\"1.0\"?>\r\n"
+      "<!DOCTYPE Root [<!ELEMENT Root ANY>]>\n"
+      "<!-- A comment with <tags> -->\n"
+      "<Root Name=\"a&amp;b &lt;c&gt; &quot;d&quot;\tx\">\n"
+      "  <Entities>&lt;&#65;&#x42;&apos;&unknown;&gt;</Entities>\n"
+      "  <Cdata><![CDATA[<not> &amp; a tag]]></Cdata>\n"
+      "  <Lines>first\r\nsecond</Lines>\n"
+      "  <Empty/>\n"
+      "  <Commented><!-- skipped -->text</Commented>\n"
+      "</Root>\n"};
+  XmlStreamReader reader{stream};
+
+  CHECK(reader.getAttribute("Name") == "a&b <c> \"d\" x");
+  REQUIRE(reader.nextChildElement(0));
+  CHECK(reader.getText() == "<AB'&unknown;>");
+  REQUIRE(reader.nextChildElement(0));
+  CHECK(reader.getText() == "<not> &amp; a tag");
+  REQUIRE(reader.nextChildElement(0));
+  CHECK(reader.getText() == "first\nsecond");
+  REQUIRE(reader.nextChildElement(0));
+  CHECK(reader.getName() == "Empty");
+  CHECK_THROWS_AS(reader.getText(), Exception);
+  REQUIRE(reader.nextChildElement(0));
+  CHECK(reader.getText() == "text");
+  CHECK_FALSE(reader.nextChildElement(0));
+}
+
+TEST_CASE("Test skipping the elements not read", "[XmlStreamReaderTest][TestSkip]")
+{
+  XmlStreamReader reader{input_directory / fs::path("example_1.xml")};
+
+  std::vector<std::string> names;
+  while (reader.nextChildElement(0))
+  {
+    names.push_back(reader.getName());
+    if (reader.getName() == "Node")
+    {
+      REQUIRE(reader.nextChildElement(1));
+      CHECK(reader.getDepth() == 2);
+      CHECK(reader.getText() == " Content ");
+      CHECK_FALSE(reader.nextChildElement(1));
+      // The parent is closed, so there is nothing else to read in it.
+      CHECK_FALSE(reader.nextChildElement(1));
+    }
+  }
+
+  CHECK(names == std::vector<std::string>{"Node1", "Node1", "Node", "Node1"});
+}
+
+TEST_CASE("Test reading an element into a document", "[XmlStreamReaderTest][TestReadInto]")
+{
+  std::stringstream expected;
+  XmlDocument{input_directory / fs::path("example_2.xml")}.save(expected);
+
+  XmlStreamReader reader{input_directory / fs::path("example_2.xml")};
+  XmlDocument document;
+  reader.readInto(document.appendRootNode(reader.getName()));
+  std::stringstream result;
+  document.save(result);
+
+  CHECK(result.str() == expected.str());
+  CHECK_FALSE(reader.nextChildElement(0));
+
+  XmlStreamReader read_reader{input_directory / fs::path("example_2.xml")};
+  REQUIRE(read_reader.nextChildElement(0));
+  CHECK(read_reader.getText() == "N1_1");
+  XmlDocument other_document;
+  CHECK_THROWS_AS(read_reader.readInto(other_document.appendRootNode("Late")), Exception);
+}
+
+TEST_CASE("Test reading the elements from their byte ranges", "[XmlStreamReaderTest][TestRanges]")
+{
+  const auto& input_file = input_directory / fs::path("example_1.xml");
+  XmlStreamReader reader{input_file};
+  CHECK(reader.getFilePath() == input_file);
+
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> ranges;
+  while (reader.nextChildElement(0))
+  {
+    const auto begin = reader.getElementOffset();
+    ranges.emplace_back(begin, reader.skipElement());
+  }
+  REQUIRE(ranges.size() == 4);
+  CHECK_THROWS_AS(reader.skipElement(), Exception);
+
+  std::vector<std::string> names;
+  std::vector<std::size_t> child_counts;
+  for (const auto& range : ranges)
+  {
+    XmlStreamReader range_reader{input_file, range.first, range.second};
+    names.push_back(range_reader.getName());
+    CHECK(range_reader.getDepth() == 0);
+    CHECK(range_reader.getElementOffset() == range.first);
+
+    child_counts.push_back(0);
+    while (range_reader.nextChildElement(0))
+    {
+      ++child_counts.back();
+      if (range_reader.getName() == "SubNode1")
+      {
+        CHECK(range_reader.getText() == " Content ");
+      }
+    }
+  }
+  CHECK(names == std::vector<std::string>{"Node1", "Node1", "Node", "Node1"});
+  CHECK(child_counts == std::vector<std::size_t>{2, 0, 1, 0});
+
+  // A range may also hold several elements.
+  XmlStreamReader elements_reader{input_file, ranges[1].first, ranges[3].second};
+  std::vector<std::string> element_names{elements_reader.getName()};
+  while (elements_reader.nextElement())
+  {
+    CHECK(elements_reader.getDepth() == 0);
+    element_names.push_back(elements_reader.getName());
+  }
+  CHECK(element_names == std::vector<std::string>{"Node1", "Node", "Node1"});
+
+  // The range must hold a whole element.
+  XmlStreamReader truncated_reader{input_file, ranges[2].first, ranges[2].second - 1};
+  CHECK_THROWS_AS(truncated_reader.skipElement(), Exception);
+}
+
+TEST_CASE("Test reading malformed documents", "[XmlStreamReaderTest][TestMalformed]")
+{
+  const auto read_all = [](const std::string& text)
+  {
+    std::stringstream stream{text};
+    XmlStreamReader reader{stream};
+    while (reader.nextChildElement(0))
+    {
+    }
+  };
+
+  CHECK_NOTHROW(read_all("<Root><A/><B>text</B></Root>"));
+  CHECK_THROWS_AS(read_all(""), Exception);
+  CHECK_THROWS_AS(read_all("<!-- only a comment -->"), Exception);
+  CHECK_THROWS_AS(read_all("<Root><A></B></Root>"), Exception);
+  CHECK_THROWS_AS(read_all("<Root><A>"), Exception);
+  CHECK_THROWS_AS(read_all("<Root Name=value/>"), Exception);
+  CHECK_THROWS_AS(read_all("<Root Name=\"value/>"), Exception);
+
+  CHECK_THROWS_AS(XmlStreamReader{input_directory / fs::path("missing.xml")}, Exception);
+}
+
+TEST_CASE("Test reading the character references",
+    "[XmlStreamReaderTest][TestCharacterReferences]")
+{
+  const auto read_text = [](const std::string& text)
+  {
+    std::stringstream stream{"<Root>" + text + "</Root>"};
+    return XmlStreamReader{stream}.getText();
+  };
+
+  CHECK(read_text("&#0065;&#x42;&#9;") == "AB\t");
+  CHECK(read_text("&#00000000065;&#x000000000042;") == "AB");
+  CHECK(read_text("&#xE9;&#x20AC;&#x10FFFF;") == "\u00E9\u20AC\U0010FFFF");
+
+  // They must be made of digits only and name a character allowed in XML.
+  CHECK_THROWS_AS(read_text("&#;"), Exception);
+  CHECK_THROWS_AS(read_text("&#x;"), Exception);
+  CHECK_THROWS_AS(read_text("&#12ab;"), Exception);
+  CHECK_THROWS_AS(read_text("&#-65;"), Exception);
+  CHECK_THROWS_AS(read_text("&#0;"), Exception);
+  CHECK_THROWS_AS(read_text("&#xD800;"), Exception);
+  CHECK_THROWS_AS(read_text("&#x110000;"), Exception);
+
+  std::stringstream stream{"<Root Name=\"&#x41G;\"/>"};
+  CHECK_THROWS_AS(XmlStreamReader{stream}, Exception);
+}
+
+TEST_CASE("Test reading the ampersands of the attributes",
+    "[XmlStreamReaderTest][TestAttributeAmpersands]")
+{
+  // An ampersand that does not start a reference is kept and the quote still ends the value.
+  std::stringstream stream{"<Root A=\"x&y\" B=\"&#12\" C=\"&#000000000000000066;\" D=\"z\"/>"};
+  XmlStreamReader reader{stream};
+  CHECK(reader.getAttribute("A") == "x&y");
+  CHECK(reader.getAttribute("B") == "&#12");
+  CHECK(reader.getAttribute("C") == "B");
+  CHECK(reader.getAttribute("D") == "z");
+}
+
+TEST_CASE("Test getting mandatory values", "[XmlStreamReaderTest][TestGetMandatory]")
+{
+  CHECK(XmlStreamReader::getMandatory(std::optional<int>{3}, "Parent", "Child") == 3);
+  CHECK_THROWS_AS(XmlStreamReader::getMandatory(std::optional<int>{}, "Parent", "Child"),
+      Exception);
+  CHECK_NOTHROW(XmlStreamReader::checkMandatory(true, "Parent", "Child"));
+  CHECK_THROWS_AS(XmlStreamReader::checkMandatory(false, "Parent", "Child"), Exception);
+}
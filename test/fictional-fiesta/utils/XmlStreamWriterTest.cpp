@@ -0,0 +1,94 @@
+#include "catch/catch.hpp"
+
+#include "fictional-fiesta/utils/itf/Exception.h"
+#include "fictional-fiesta/utils/itf/XmlDocument.h"
+#include "fictional-fiesta/utils/itf/XmlNode.h"
+#include "fictional-fiesta/utils/itf/XmlStreamWriter.h"
+
+#include <sstream>
+
+using namespace fictionalfiesta;
+
+namespace
+{
+
+/// Fills a document in order, as the doSave methods do.
+void fill(XmlNode root)
+{
+  root.setAttribute("Version", 2);
+  auto first = root.appendChildNode("First");
+  first.setText(1.5);
+  root.appendChildNode("Empty").setAttribute("Name", "a \"quoted\" <name> & more");
+  auto nested = root.appendChildNode("Nested");
+  auto inner = nested.appendChildNode("Inner");
+  inner.appendChildNode("Leaf").setText("x < y && y > z");
+  nested.appendChildNode("Other").setText(true);
+  root.appendChildNode("Last").setText("");
+}
+
+} // anonymous namespace
+
+TEST_CASE("Test streaming the same document as XmlDocument", "[XmlStreamWriterTest][TestOutput]")
+{
+  XmlDocument document;
+  fill(document.appendRootNode("Example"));
+  std::stringstream document_stream;
+  document.save(document_stream);
+
+  std::stringstream streamed;
+  XmlStreamWriter writer{streamed};
+  fill(writer.appendRootNode("Example"));
+  writer.finish();
+
+  CHECK(streamed.str() == document_stream.str());
+
+  std::stringstream empty;
+  XmlStreamWriter empty_writer{empty};
+  empty_writer.appendRootNode("Empty");
+  empty_writer.finish();
+  CHECK(empty.str() == "<?xml version=\"1.0\"?>\n<Empty />\n");
+}
+
+TEST_CASE("Test writing out of document order", "[XmlStreamWriterTest][TestOrder]")
+{
+  std::stringstream stream;
+  XmlStreamWriter writer{stream};
+  auto root = writer.appendRootNode("Root");
+
+  SECTION("Attribute after a child")
+  {
+    root.appendChildNode("Child");
+    CHECK_THROWS_AS(root.setAttribute("Name", "value"), Exception);
+  }
+
+  SECTION("Attribute after the text")
+  {
+    root.setText(3);
+    CHECK_THROWS_AS(root.setAttribute("Name", "value"), Exception);
+  }
+
+  SECTION("Repeated attribute")
+  {
+    root.setAttribute("Name", "value");
+    CHECK_THROWS_AS(root.setAttribute("Name", "other value"), Exception);
+  }
+
+  SECTION("Finished node")
+  {
+    auto first = root.appendChildNode("First");
+    root.appendChildNode("Second");
+    CHECK_THROWS_AS(first.setText(1), Exception);
+    CHECK_THROWS_AS(first.appendChildNode("Late"), Exception);
+  }
+
+  SECTION("Child after the text")
+  {
+    root.setText(3);
+    CHECK_THROWS_AS(root.appendChildNode("Child"), Exception);
+  }
+
+  SECTION("Second root")
+  {
+    CHECK_THROWS_AS(writer.appendRootNode("Root"), Exception);
+  }
+}
@@ -0,0 +1,75 @@
+#include "catch/catch.hpp"
+
+#include "fictional-fiesta/world/itf/Checkpoint.h"
+
+#include "fictional-fiesta/utils/itf/Exception.h"
+#include "fictional-fiesta/utils/itf/XmlDocument.h"
+#include "fictional-fiesta/utils/itf/XmlNode.h"
+
+#include "test/test_utils/itf/CheckpointResume.h"
+
+#include <experimental/filesystem>
+#include <fstream>
+
+namespace fs = std::experimental::filesystem;
+using namespace fictionalfiesta;
+
+static const fs::path result_directory = fs::path(TEST_BINARY_DIRECTORY)
+    / fs::path("fictional-fiesta/world/result");
+
+TEST_CASE("Test resuming a run from a checkpoint", "[CheckpointTest][TestResume]")
+{
+  const auto checkpoint_file = result_directory / fs::path("checkpoint_0.xml");
+  testutils::checkResume([&checkpoint_file](const Checkpoint& interrupted)
+  {
+    interrupted.save(checkpoint_file);
+    Checkpoint resumed{checkpoint_file};
+
+    // The locations may be parsed in parallel, with the same result.
+    CHECK(Checkpoint(checkpoint_file, 3).saveXmlToString() == resumed.saveXmlToString());
+    return resumed;
+  });
+}
+
+TEST_CASE("Test resuming a run from a checkpoint node", "[CheckpointTest][TestResumeNode]")
+{
+  testutils::checkResume([](const Checkpoint& interrupted)
+  {
+    XmlDocument document;
+    interrupted.save(document.appendRootNode(Checkpoint::XML_MAIN_NODE_NAME));
+    return Checkpoint{document.getRootNode()};
+  });
+}
+
+TEST_CASE("Test loading a checkpoint of another engine", "[CheckpointTest][TestEngineMismatch]")
+{
+  auto checkpoint_xml = Checkpoint{World{}, FSM::createRng(0)}.saveXmlToString();
+
+  const std::string engine_attribute = std::string{"Engine=\""} + FSM::RNG_ENGINE_NAME + "\"";
+  const auto position = checkpoint_xml.find(engine_attribute);
+  REQUIRE(position != std::string::npos);
+  checkpoint_xml.replace(position, engine_attribute.size(), "Engine=\"other\"");
+
+  const auto checkpoint_file = result_directory / fs::path("checkpoint_other_engine.xml");
+  std::ofstream{checkpoint_file} << checkpoint_xml;
+
+  CHECK_THROWS_AS(Checkpoint{checkpoint_file}, Exception);
+}
+
+TEST_CASE("Test loading a checkpoint without resource split settings",
+    "[CheckpointTest][TestMissingSplitSettings]")
+{
+  auto checkpoint_xml = Checkpoint{World{}, FSM::createRng(0)}.saveXmlToString();
+
+  const auto begin = checkpoint_xml.find("<ResourceSplit");
+  REQUIRE(begin != std::string::npos);
+  const auto end = checkpoint_xml.find("/>", begin);
+  REQUIRE(end != std::string::npos);
+  checkpoint_xml.erase(begin, end + 2 - begin);
+
+  const auto checkpoint_file = result_directory / fs::path("checkpoint_no_split.xml");
+  std::ofstream{checkpoint_file} << checkpoint_xml;
+
+  CHECK_THROWS_AS(Checkpoint{checkpoint_file}, Exception);
+  CHECK_THROWS_AS(Checkpoint{XmlDocument(checkpoint_file).getRootNode()}, Exception);
+}
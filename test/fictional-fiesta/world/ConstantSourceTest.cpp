@@ -131,3 +131,60 @@ TEST_CASE("Test saving ConstantSource instances to XML.", "[ConstantSourceTest][
   const auto& benchmark_file = benchmark_directory / fs::path("example_save_0.xml");
   benchmarkFiles(benchmark_file, result_file, result_directory);
 }
+
+TEST_CASE("Test loading saved ConstantSource instances", "[ConstantSourceTest][TestReloadXml]")
+{
+  auto document = XmlDocument{};
+  auto root_node = document.appendRootNode("Sources");
+
+  const ConstantSource light_source("Light", Source::INFINITY_UNITS);
+  light_source.save(root_node.appendChildNode("Source"));
+
+  const ConstantSource time_source("Time", 40, 30);
+  time_source.save(root_node.appendChildNode("Source"));
+
+  const auto& source_nodes{root_node.getChildNodes("Source")};
+  REQUIRE(source_nodes.size() == 2);
+
+  // The infinite units are written as "infinite" and read back.
+  const auto light_copy{ConstantSource(source_nodes[0])};
+  CHECK(light_copy.getCurrentUnitCount() == Source::INFINITY_UNITS);
+  CHECK(light_copy.str(0) == light_source.str(0));
+
+  const auto time_copy{ConstantSource(source_nodes[1])};
+  CHECK(time_copy.getCurrentUnitCount() == 30);
+  CHECK(time_copy.str(0) == time_source.str(0));
+
+  source_nodes[1].getChildNode("CurrentUnits").setText("many");
+  CHECK_THROWS_AS(ConstantSource(source_nodes[1]), Exception);
+}
+
+TEST_CASE("Test loading units with white spaces", "[ConstantSourceTest][TestWhiteSpaceUnits]")
+{
+  auto document = XmlDocument{};
+  auto source_node = document.appendRootNode("Source");
+  source_node.setAttribute("Type", "Constant");
+  source_node.appendChildNode("Resource").setText("Water");
+  auto fixed_units_node = source_node.appendChildNode("FixedUnits");
+  auto current_units_node = source_node.appendChildNode("CurrentUnits");
+
+  // Read as the other numbers of the document.
+  fixed_units_node.setText(" 100 ");
+  current_units_node.setText("\n      +30\n    ");
+  {
+    const auto source{ConstantSource(source_node)};
+    CHECK(source.getCurrentUnitCount() == 30);
+    CHECK(source.str(0) == ConstantSource("Water", 100, 30).str(0));
+  }
+
+  fixed_units_node.setText("\n      infinity\n    ");
+  current_units_node.setText(" infinite ");
+  {
+    const auto source{ConstantSource(source_node)};
+    CHECK(source.getCurrentUnitCount() == Source::INFINITY_UNITS);
+    CHECK(source.str(0) == ConstantSource("Water", Source::INFINITY_UNITS).str(0));
+  }
+
+  fixed_units_node.setText("infinities");
+  CHECK_THROWS_AS(ConstantSource(source_node), Exception);
+}
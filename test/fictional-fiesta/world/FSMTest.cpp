@@ -0,0 +1,457 @@
+#include "catch/catch.hpp"
+
+#include "fictional-fiesta/world/itf/FSM.h"
+
+#include "fictional-fiesta/world/itf/RngEngines.h"
+
+#include "fictional-fiesta/utils/itf/Exception.h"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace fictionalfiesta;
+
+namespace
+{
+
+std::vector<FSM::CounterRng::result_type> draw(FSM::CounterRng rng, std::size_t count)
+{
+  std::vector<FSM::CounterRng::result_type> values(count);
+  for (auto& value : values)
+  {
+    value = rng();
+  }
+  return values;
+}
+
+/// Mean and variance of the uniform variates of an engine.
+template <typename Engine>
+std::pair<double, double> uniform_moments(Engine& engine)
+{
+  std::uniform_real_distribution<double> uniform;
+  const unsigned int count = 100000;
+  double sum = 0;
+  double square_sum = 0;
+  for (unsigned int index = 0; index < count; ++index)
+  {
+    const auto value = uniform(engine);
+    sum += value;
+    square_sum += value * value;
+  }
+  const auto mean = sum / count;
+  return {mean, square_sum / count - mean * mean};
+}
+
+/// Runs the distribution mix of a cycle (the Genotype, Individual and ResourceSplitter draws)
+/// and prints the time taken. Returns a checksum so the draws are not optimized away.
+template <typename Engine>
+double benchmark_engine(const std::string& name, Engine engine)
+{
+  const unsigned int iterations = 2000000;
+  std::bernoulli_distribution reproduction(0.5);
+  std::bernoulli_distribution starvation(0.3);
+  std::geometric_distribution<unsigned long long> feeding_deaths(0.04);
+
+  double checksum = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned int iteration = 0; iteration < iterations; ++iteration)
+  {
+    // Individual::maintenanceSurplus and Genotype::willReproduce.
+    checksum += starvation(engine) ? 1 : 0;
+    if (reproduction(engine))
+    {
+      // Genotype::reproduce and Genotype::producedDeadlyMutation.
+      FSM::NormalGenerator normal;
+      checksum += 10 + normal(engine);
+      checksum += 0.5 + 0.05 * normal(engine);
+      checksum += 0.1 + 0.01 * normal(engine);
+      checksum += std::bernoulli_distribution(0.1)(engine) ? 1 : 0;
+    }
+
+    // ResourceSplitter: sampler draws, feeding deaths and bulk rounds.
+    checksum += std::generate_canonical<double, std::numeric_limits<double>::digits>(engine);
+    checksum += static_cast<double>(feeding_deaths(engine));
+    if (iteration % 16 == 0)
+    {
+      checksum += static_cast<double>(
+          std::binomial_distribution<unsigned int>(1000, 0.1)(engine));
+    }
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  WARN(name << ": " << elapsed.count() << " s");
+  return checksum;
+}
+
+/// Draws normal variates in the three ways of the reproduction phase and prints the time taken.
+/// Returns a checksum so the draws are not optimized away.
+template <typename Engine>
+double benchmark_normals(Engine engine)
+{
+  const unsigned int iterations = 1000000;
+  double checksum = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int iteration = 0; iteration < iterations; ++iteration)
+  {
+    // Three distributions per offspring, as Genotype::reproduce used to do.
+    checksum += std::normal_distribution<double>(10, 1)(engine);
+    checksum += std::normal_distribution<double>(0.5, 0.05)(engine);
+    checksum += std::normal_distribution<double>(0.1, 0.01)(engine);
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  WARN("std::normal_distribution per variate: " << elapsed.count() << " s");
+
+  FSM::NormalGenerator normal;
+  start = std::chrono::steady_clock::now();
+  for (unsigned int iteration = 0; iteration < iterations; ++iteration)
+  {
+    checksum += 10 + normal(engine);
+    checksum += 0.5 + 0.05 * normal(engine);
+    checksum += 0.1 + 0.01 * normal(engine);
+  }
+  elapsed = std::chrono::steady_clock::now() - start;
+  WARN("FSM::NormalGenerator: " << elapsed.count() << " s");
+
+  // Two pairs per offspring, transformed in batches as PopulationStore::reproduce does.
+  constexpr std::size_t batch = 32;
+  std::array<double, batch> radii;
+  std::array<double, batch> angles;
+  std::array<double, batch> first;
+  std::array<double, batch> second;
+  start = std::chrono::steady_clock::now();
+  for (unsigned int iteration = 0; iteration < iterations; iteration += batch / 2)
+  {
+    for (std::size_t pair = 0; pair < batch; ++pair)
+    {
+      radii[pair] = FSM::NormalGenerator::openUniform(engine);
+      angles[pair] = FSM::NormalGenerator::openUniform(engine);
+    }
+    FSM::NormalGenerator::transform(radii.data(), angles.data(), batch, first.data(),
+        second.data());
+    for (std::size_t pair = 0; pair < batch; pair += 2)
+    {
+      checksum += 10 + first[pair];
+      checksum += 0.5 + 0.05 * second[pair];
+      checksum += 0.1 + 0.01 * first[pair + 1];
+    }
+  }
+  elapsed = std::chrono::steady_clock::now() - start;
+  WARN("FSM::NormalGenerator::transform: " << elapsed.count() << " s");
+  return checksum;
+}
+
+} // anonymous namespace
+
+TEST_CASE("Test the Philox bijection known answers", "[FSMTest][TestPhiloxKnownAnswers]")
+{
+  // Known answer tests of the reference implementation (Random123).
+  using Counter = FSM::CounterRng::Counter;
+  using Key = FSM::CounterRng::Key;
+
+  CHECK(FSM::CounterRng::encrypt(Counter{0, 0, 0, 0}, Key{0, 0}) ==
+      Counter{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+  CHECK(FSM::CounterRng::encrypt(Counter{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+      Key{0xffffffff, 0xffffffff}) == Counter{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd});
+  CHECK(FSM::CounterRng::encrypt(Counter{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+      Key{0xa4093822, 0x299f31d0}) == Counter{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1});
+}
+
+TEST_CASE("Test the counter-based streams", "[FSMTest][TestStreams]")
+{
+  const auto values = draw(FSM::createStream(3, {1, 2, 3}), 100);
+
+  // Same seed and key tuple, same stream.
+  CHECK(draw(FSM::createStream(3, {1, 2, 3}), 100) == values);
+
+  // Any change in the seed or the key tuple gives another stream.
+  CHECK(draw(FSM::createStream(4, {1, 2, 3}), 100) != values);
+  CHECK(draw(FSM::createStream(3, {1, 2, 4}), 100) != values);
+  CHECK(draw(FSM::createStream(3, {3, 2, 1}), 100) != values);
+  CHECK(draw(FSM::createStream(3, {1, 2, 3, 0}), 100) != values);
+  CHECK(draw(FSM::createStream(3, {1, 2}), 100) != values);
+}
+
+TEST_CASE("Test skipping values of a counter-based stream", "[FSMTest][TestDiscard]")
+{
+  const auto values = draw(FSM::createStream(0, {7}), 64);
+
+  for (const unsigned long long skipped : {0ull, 1ull, 3ull, 4ull, 5ull, 17ull, 40ull})
+  {
+    for (const unsigned long long drawn : {0ull, 2ull, 4ull})
+    {
+      auto rng = FSM::createStream(0, {7});
+      for (unsigned long long index = 0; index < drawn; ++index)
+      {
+        rng();
+      }
+      rng.discard(skipped);
+      CHECK(rng() == values[drawn + skipped]);
+      CHECK(rng() == values[drawn + skipped + 1]);
+    }
+  }
+}
+
+TEST_CASE("Test the distribution of a counter-based stream", "[FSMTest][TestDistribution]")
+{
+  auto rng = FSM::createStream(11, {0, 1});
+  std::uniform_real_distribution<double> uniform;
+  std::bernoulli_distribution bernoulli(0.25);
+
+  const unsigned int count = 100000;
+  double sum = 0;
+  double square_sum = 0;
+  unsigned int successes = 0;
+  for (unsigned int index = 0; index < count; ++index)
+  {
+    const auto value = uniform(rng);
+    sum += value;
+    square_sum += value * value;
+    successes += bernoulli(rng) ? 1 : 0;
+  }
+
+  CHECK(sum / count == Approx(0.5).margin(0.005));
+  CHECK(square_sum / count - (sum / count) * (sum / count) == Approx(1.0 / 12).margin(0.002));
+  CHECK(static_cast<double>(successes) / count == Approx(0.25).margin(0.005));
+}
+
+TEST_CASE("Test a batch of counter-based streams", "[FSMTest][TestStreamBatch]")
+{
+  const std::uint64_t seed = 0x0123456789abcdefULL;
+  const FSM::StreamBatch batch(seed, 40);
+
+  // Every lane holds the first values of its own stream.
+  for (std::size_t lane = 0; lane < FSM::StreamBatch::SIZE; ++lane)
+  {
+    const auto values = draw(FSM::createStream(seed, {40 + lane}), FSM::StreamBatch::VALUE_COUNT);
+    for (unsigned int position = 0; position < FSM::StreamBatch::VALUE_COUNT; ++position)
+    {
+      CHECK(batch.getValues(position)[lane] == values[position]);
+    }
+  }
+
+  std::array<double, FSM::StreamBatch::SIZE> uniforms;
+  batch.uniforms(2, uniforms);
+  for (std::size_t lane = 0; lane < FSM::StreamBatch::SIZE; ++lane)
+  {
+    CHECK(uniforms[lane] == std::ldexp(batch.getValues(2)[lane], -32));
+    CHECK(uniforms[lane] < 1.0);
+  }
+}
+
+TEST_CASE("Test the Bernoulli variates of a stream batch", "[FSMTest][TestStreamBatchBernoulli]")
+{
+  const std::uint64_t two_to_32 = std::uint64_t{1} << 32;
+  CHECK(FSM::StreamBatch::bernoulliThreshold(-0.5) == 0);
+  CHECK(FSM::StreamBatch::bernoulliThreshold(0) == 0);
+  CHECK(FSM::StreamBatch::bernoulliThreshold(0.25) == two_to_32 / 4);
+  CHECK(FSM::StreamBatch::bernoulliThreshold(1) == two_to_32);
+  CHECK(FSM::StreamBatch::bernoulliThreshold(3) == two_to_32);
+
+  // Probabilities 0 and 1 never and always succeed, the others at their frequency.
+  FSM::StreamBatch::Thresholds thresholds;
+  for (std::size_t lane = 0; lane < FSM::StreamBatch::SIZE; ++lane)
+  {
+    thresholds[lane] = FSM::StreamBatch::bernoulliThreshold(lane / 15.0);
+  }
+
+  const unsigned int batch_count = 10000;
+  std::array<unsigned int, FSM::StreamBatch::SIZE> successes{};
+  FSM::StreamBatch::Outcomes outcomes;
+  for (unsigned int batch_index = 0; batch_index < batch_count; ++batch_index)
+  {
+    const FSM::StreamBatch batch(5, batch_index * FSM::StreamBatch::SIZE);
+    for (unsigned int position = 0; position < FSM::StreamBatch::VALUE_COUNT; ++position)
+    {
+      batch.bernoulli(position, thresholds, outcomes);
+      for (std::size_t lane = 0; lane < FSM::StreamBatch::SIZE; ++lane)
+      {
+        successes[lane] += outcomes[lane] ? 1 : 0;
+      }
+    }
+  }
+
+  const auto draw_count = batch_count * FSM::StreamBatch::VALUE_COUNT;
+  CHECK(successes.front() == 0);
+  CHECK(successes.back() == draw_count);
+  for (std::size_t lane = 0; lane < FSM::StreamBatch::SIZE; ++lane)
+  {
+    CHECK(static_cast<double>(successes[lane]) / draw_count == Approx(lane / 15.0).margin(0.01));
+  }
+}
+
+TEST_CASE("Test the normal variates", "[FSMTest][TestNormalGenerator]")
+{
+  // The second variate of every pair is cached, so a pair uses exactly two values.
+  auto rng = FSM::createStream(9, {1});
+  FSM::NormalGenerator normal;
+  const auto first = normal(rng);
+  const auto second = normal(rng);
+  normal(rng);
+  normal.reset();
+  normal(rng);
+
+  auto same_rng = FSM::createStream(9, {1});
+  const auto radius = FSM::NormalGenerator::openUniform(same_rng);
+  const auto angle = FSM::NormalGenerator::openUniform(same_rng);
+  double first_variate;
+  double second_variate;
+  FSM::NormalGenerator::transform(&radius, &angle, 1, &first_variate, &second_variate);
+  CHECK(first_variate == first);
+  CHECK(second_variate == second);
+
+  // Then a new pair, and another one after the cached variate is dropped.
+  same_rng.discard(4);
+  CHECK(same_rng() == rng());
+
+  // Standard normal moments, with either width of engine.
+  auto mt = std::mt19937(4);
+  auto xoshiro = Xoshiro256PlusPlus(4);
+  const unsigned int count = 200000;
+  double sum[2]{};
+  double square_sum[2]{};
+  unsigned int beyond_two_sigma[2]{};
+  for (unsigned int index = 0; index < count; ++index)
+  {
+    const double values[2]{normal(mt), normal(xoshiro)};
+    for (unsigned int engine = 0; engine < 2; ++engine)
+    {
+      sum[engine] += values[engine];
+      square_sum[engine] += values[engine] * values[engine];
+      beyond_two_sigma[engine] += std::abs(values[engine]) > 2 ? 1 : 0;
+    }
+  }
+
+  for (unsigned int engine = 0; engine < 2; ++engine)
+  {
+    CHECK(sum[engine] / count == Approx(0).margin(0.01));
+    CHECK(square_sum[engine] / count == Approx(1).margin(0.015));
+    CHECK(static_cast<double>(beyond_two_sigma[engine]) / count == Approx(0.0455).margin(0.002));
+  }
+}
+
+TEST_CASE("Test the xoshiro256++ engine", "[FSMTest][TestXoshiro256PlusPlus]")
+{
+  // The state of seed 0 is the first SplitMix64 outputs of 0, whose values are well known, so
+  // the first output can be computed by hand: rotl(s[0] + s[3], 23) + s[0].
+  const std::uint64_t first = 0xe220a8397b1dcdafULL;
+  const std::uint64_t fourth = 0xf88bb8a8724c81ecULL;
+  const std::uint64_t sum = first + fourth;
+  Xoshiro256PlusPlus engine(0);
+  CHECK(engine() == ((sum << 23) | (sum >> 41)) + first);
+
+  Xoshiro256PlusPlus same(0);
+  same.discard(1);
+  CHECK(same() == engine());
+  CHECK(Xoshiro256PlusPlus(1)() != Xoshiro256PlusPlus(0)());
+
+  std::seed_seq sequence{1, 2, 3};
+  Xoshiro256PlusPlus seeded(sequence);
+  const auto moments = uniform_moments(seeded);
+  CHECK(moments.first == Approx(0.5).margin(0.005));
+  CHECK(moments.second == Approx(1.0 / 12).margin(0.002));
+}
+
+TEST_CASE("Test the PCG64 engine", "[FSMTest][TestPcg64]")
+{
+  // Known answers of the reference pcg64(42, 54).
+  Pcg64 engine(42, 54);
+  for (const std::uint64_t expected : {0x86b1da1d72062b68ULL, 0x1304aa46c9853d39ULL,
+      0xa3670e9e0dd50358ULL, 0xf9090e529a7dae00ULL, 0xc85b9fd837996f2cULL,
+      0x606121f8e3919196ULL})
+  {
+    CHECK(engine() == expected);
+  }
+
+  Pcg64 skipped(42, 54);
+  skipped.discard(6);
+  CHECK(skipped() == engine());
+  CHECK(Pcg64(42, 55)() != Pcg64(42, 54)());
+
+  std::seed_seq sequence{1, 2, 3};
+  Pcg64 seeded(sequence);
+  const auto moments = uniform_moments(seeded);
+  CHECK(moments.first == Approx(0.5).margin(0.005));
+  CHECK(moments.second == Approx(1.0 / 12).margin(0.002));
+}
+
+TEST_CASE("Test saving the state of the engines", "[FSMTest][TestEngineState]")
+{
+  Xoshiro256PlusPlus xoshiro(3);
+  xoshiro.discard(10);
+  std::stringstream xoshiro_state;
+  xoshiro_state << xoshiro;
+  Xoshiro256PlusPlus restored_xoshiro;
+  CHECK(restored_xoshiro != xoshiro);
+  REQUIRE(xoshiro_state >> restored_xoshiro);
+  CHECK(restored_xoshiro == xoshiro);
+  CHECK(restored_xoshiro() == xoshiro());
+
+  Pcg64 pcg(3, 7);
+  pcg.discard(10);
+  std::stringstream pcg_state;
+  pcg_state << pcg;
+  Pcg64 restored_pcg;
+  CHECK(restored_pcg != pcg);
+  REQUIRE(pcg_state >> restored_pcg);
+  CHECK(restored_pcg == pcg);
+  CHECK(restored_pcg() == pcg());
+
+  // Invalid states are rejected and leave the engine as it was.
+  std::stringstream zero_state{"0 0 0 0"};
+  CHECK(!(zero_state >> restored_xoshiro));
+  CHECK(restored_xoshiro == xoshiro);
+  std::stringstream even_increment{"1 2 3 4"};
+  CHECK(!(even_increment >> restored_pcg));
+  CHECK(restored_pcg == pcg);
+}
+
+TEST_CASE("Test saving the state of the configured engine", "[FSMTest][TestRngState]")
+{
+  auto rng = FSM::createRng(8);
+  rng.discard(1000);
+  auto restored = FSM::rngFromString(FSM::rngToString(rng));
+  CHECK(restored == rng);
+  for (unsigned int index = 0; index < 10; ++index)
+  {
+    CHECK(restored() == rng());
+  }
+
+  CHECK_THROWS_AS(FSM::rngFromString(""), Exception);
+  CHECK_THROWS_AS(FSM::rngFromString("1 2 x"), Exception);
+  CHECK_THROWS_AS(FSM::rngFromString(FSM::rngToString(rng) + " 1"), Exception);
+}
+
+TEST_CASE("Test the configured engine", "[FSMTest][TestRng]")
+{
+  // Seeded the same, same values. Different streams, different values.
+  auto rng = FSM::createRng(3);
+  auto same_rng = FSM::createRng(3);
+  CHECK(rng() == same_rng());
+  CHECK(FSM::createRng(3, 0)() == FSM::createRng(3, 0)());
+  CHECK(FSM::createRng(3, 0)() != FSM::createRng(3, 1)());
+  CHECK(FSM::createRng(3, 0)() != FSM::createRng(3 + (std::uint64_t{1} << 32), 0)());
+
+  const auto moments = uniform_moments(rng);
+  CHECK(moments.first == Approx(0.5).margin(0.005));
+  CHECK(moments.second == Approx(1.0 / 12).margin(0.002));
+}
+
+TEST_CASE("Benchmark the random number engines", "[FSMTest][.benchmark]")
+{
+  std::seed_seq sequence{0};
+  double checksum = 0;
+  checksum += benchmark_engine("mt19937", std::mt19937(sequence));
+  checksum += benchmark_engine("xoshiro256++", Xoshiro256PlusPlus(sequence));
+  checksum += benchmark_engine("pcg64", Pcg64(sequence));
+  checksum += benchmark_engine("Philox4x32-10 (CounterRng)", FSM::createStream(0, {0}));
+  checksum += benchmark_normals(FSM::createRng(0));
+  CHECK(checksum > 0);
+}
@@ -100,7 +100,54 @@ TEST_CASE("Test genotype XML save method", "[GenotypeTest][TestGenotypeSaveToXml
   }
 }
 
-TEST_CASE("Test genotype willReproduce method", "[GenotypeTest][TestWillReproduce]")
+TEST_CASE("Test genotype distance method", "[GenotypeTest][TestDistance]")
+{
+  const Genotype genotype_0{10, 1, 0.5};
+  CHECK(genotype_0.distance(genotype_0) == 0);
+
+  const Genotype genotype_1{1, 1, 0.4};
+  CHECK(genotype_0.distance(genotype_1) == Approx(0.6195286195286195));
+  CHECK(genotype_1.distance(genotype_0) == genotype_0.distance(genotype_1));
+
+  const Genotype genotype_2{9, 1.1, 0.4};
+  CHECK(genotype_0.distance(genotype_2) == Approx(0.14090782511835143));
+}
+
+TEST_CASE("Test (in)equality operators for Genotype instances", "[GenotypeTest][TestEquality]")
+{
+  {
+    const Genotype genotype_0{10, 1, 0.5};
+    CHECK(genotype_0 == genotype_0);
+    CHECK(!(genotype_0 != genotype_0));
+
+    const Genotype genotype_1{10, 1, 0.5};
+    CHECK(genotype_0 == genotype_1);
+    CHECK(!(genotype_0 != genotype_1));
+  }
+  {
+    const Genotype genotype_0{10, 1, 0.5};
+    const Genotype genotype_1{9, 1, 0.5};
+    CHECK(!(genotype_0 == genotype_1));
+    CHECK(genotype_0 != genotype_1);
+  }
+  {
+    const Genotype genotype_0{10, 0.9999, 0.5};
+    const Genotype genotype_1{10, 1, 0.5};
+    CHECK(!(genotype_0 == genotype_1));
+    CHECK(genotype_0 != genotype_1);
+  }
+  {
+    const Genotype genotype_0{10, 1, 0.5001};
+    const Genotype genotype_1{10, 1, 0.5};
+    CHECK(!(genotype_0 == genotype_1));
+    CHECK(genotype_0 != genotype_1);
+  }
+}
+
+// The expected values of these tests are pinned to the default engine.
+#ifdef FICTIONAL_FIESTA_RNG_MT19937
+
+TEST_CASE("Test genotype willReproduce method", "[GenotypeTest][TestWillReproduce][mt19937]")
 {
   {
     auto rng{FSM::createRng(0)};
@@ -140,7 +187,7 @@ TEST_CASE("Test genotype willReproduce method", "[GenotypeTest][TestWillReproduc
   }
 }
 
-TEST_CASE("Test genotype reproduce method", "[GenotypeTest][TestReproduce]")
+TEST_CASE("Test genotype reproduce method", "[GenotypeTest][TestReproduce][mt19937]")
 {
   {
     auto rng{FSM::createRng(1)};
@@ -150,10 +197,9 @@ TEST_CASE("Test genotype reproduce method", "[GenotypeTest][TestReproduce]")
     const Genotype mutated{genotype.reproduce(rng)};
 
     // Small variation.
-    CHECK(mutated.getReproductionEnergyThreshold() == Approx(9.450253821));
-    // Maximum 1.
-    CHECK(mutated.getReproductionProbability() == 1);
-    CHECK(mutated.getMutabilityRatio() == Approx(0.1025759354));
+    CHECK(mutated.getReproductionEnergyThreshold() == Approx(11.3223786781));
+    CHECK(mutated.getReproductionProbability() == Approx(0.9976606835));
+    CHECK(mutated.getMutabilityRatio() == Approx(0.1073836067));
   }
 
   {
@@ -164,13 +210,15 @@ TEST_CASE("Test genotype reproduce method", "[GenotypeTest][TestReproduce]")
     const Genotype mutated{genotype.reproduce(rng)};
 
     // Big variation.
-    CHECK(mutated.getReproductionEnergyThreshold() == Approx(9.7969172834));
-    CHECK(mutated.getReproductionProbability() == Approx(0.2012590006));
-    CHECK(mutated.getMutabilityRatio() == Approx(0.3379887966));
+    CHECK(mutated.getReproductionEnergyThreshold() == Approx(14.6000599123));
+    // Maximum 1.
+    CHECK(mutated.getReproductionProbability() == 1);
+    CHECK(mutated.getMutabilityRatio() == Approx(2.8898231572));
   }
 }
 
-TEST_CASE("Test genotype producedDeadlyMutation method", "[GenotypeTest][TestProducedDeadlyMutation]")
+TEST_CASE("Test genotype producedDeadlyMutation method",
+    "[GenotypeTest][TestProducedDeadlyMutation][mt19937]")
 {
   {
     auto rng{FSM::createRng(0)};
@@ -204,46 +252,4 @@ TEST_CASE("Test genotype producedDeadlyMutation method", "[GenotypeTest][TestPro
   }
 }
 
-TEST_CASE("Test genotype distance method", "[GenotypeTest][TestDistance]")
-{
-  const Genotype genotype_0{10, 1, 0.5};
-  CHECK(genotype_0.distance(genotype_0) == 0);
-
-  const Genotype genotype_1{1, 1, 0.4};
-  CHECK(genotype_0.distance(genotype_1) == Approx(0.6195286195286195));
-  CHECK(genotype_1.distance(genotype_0) == genotype_0.distance(genotype_1));
-
-  const Genotype genotype_2{9, 1.1, 0.4};
-  CHECK(genotype_0.distance(genotype_2) == Approx(0.14090782511835143));
-}
-
-TEST_CASE("Test (in)equality operators for Genotype instances", "[GenotypeTest][TestEquality]")
-{
-  {
-    const Genotype genotype_0{10, 1, 0.5};
-    CHECK(genotype_0 == genotype_0);
-    CHECK(!(genotype_0 != genotype_0));
-
-    const Genotype genotype_1{10, 1, 0.5};
-    CHECK(genotype_0 == genotype_1);
-    CHECK(!(genotype_0 != genotype_1));
-  }
-  {
-    const Genotype genotype_0{10, 1, 0.5};
-    const Genotype genotype_1{9, 1, 0.5};
-    CHECK(!(genotype_0 == genotype_1));
-    CHECK(genotype_0 != genotype_1);
-  }
-  {
-    const Genotype genotype_0{10, 0.9999, 0.5};
-    const Genotype genotype_1{10, 1, 0.5};
-    CHECK(!(genotype_0 == genotype_1));
-    CHECK(genotype_0 != genotype_1);
-  }
-  {
-    const Genotype genotype_0{10, 1, 0.5001};
-    const Genotype genotype_1{10, 1, 0.5};
-    CHECK(!(genotype_0 == genotype_1));
-    CHECK(genotype_0 != genotype_1);
-  }
-}
+#endif
@@ -5,10 +5,12 @@
 #include "fictional-fiesta/utils/itf/Exception.h"
 #include "fictional-fiesta/utils/itf/XmlDocument.h"
 #include "fictional-fiesta/utils/itf/XmlNode.h"
+#include "fictional-fiesta/utils/itf/XmlStreamReader.h"
 
 #include "test/test_utils/itf/BenchmarkFiles.h"
 
 #include <experimental/filesystem>
+#include <sstream>
 
 namespace fs = std::experimental::filesystem;
 using namespace fictionalfiesta;
@@ -71,6 +73,21 @@ TEST_CASE("Test individual constructor from XML", "[IndividualTest][TestFromXml]
   }
 }
 
+TEST_CASE("Test loading an individual with a negative resource count",
+    "[IndividualTest][TestNegativeResourceCount]")
+{
+  XmlDocument document{};
+  auto node = document.appendRootNode(Individual::XML_MAIN_NODE_NAME);
+  Individual{Genotype{10, 1, 0.1}, 0}.save(node);
+  node.setAttribute("ResourceCount", "-1");
+  CHECK_THROWS_AS(Individual{node}, Exception);
+
+  std::stringstream stream;
+  document.save(stream);
+  XmlStreamReader reader{stream};
+  CHECK_THROWS_AS(Individual{reader}, Exception);
+}
+
 TEST_CASE("Test individual save method", "[IndividualTest][TestSave]")
 {
   {
@@ -98,52 +115,6 @@ TEST_CASE("Test individual save method", "[IndividualTest][TestSave]")
   }
 }
 
-TEST_CASE("Test individual willReproduce method", "[IndividualTest][TestWillReproduce]")
-{
-  {
-    auto rng{FSM::createRng(0)};
-
-    const Genotype genotype{10, 1, 0.1};
-
-    const auto individual = Individual{genotype, 0};
-
-    // Energy lower than the reproduction threshold (should be always false).
-    CHECK(!individual.willReproduce(rng));
-    CHECK(!individual.willReproduce(rng));
-    CHECK(!individual.willReproduce(rng));
-  }
-
-  {
-    auto rng{FSM::createRng(1)};
-
-    const Genotype genotype{10, 1, 0.1};
-
-    const auto individual = Individual{genotype, 10};
-
-    // Energy greater or equal than the reproduction threshold and probability 1
-    // (should be always true).
-    CHECK(individual.willReproduce(rng));
-    CHECK(individual.willReproduce(rng));
-    CHECK(individual.willReproduce(rng));
-    CHECK(individual.willReproduce(rng));
-  }
-
-  {
-    auto rng{FSM::createRng(2)};
-
-    const Genotype genotype{10, 0.5, 0.1};
-
-    const auto individual = Individual{genotype, 11};
-
-    // Energy greater or equal than the reproduction threshold and probability 0.5
-    // (some true, some false).
-    CHECK(individual.willReproduce(rng));
-    CHECK(!individual.willReproduce(rng));
-    CHECK(!individual.willReproduce(rng));
-    CHECK(individual.willReproduce(rng));
-  }
-}
-
 TEST_CASE("Test individual die and isDead methods", "[IndividualTest][TestDie]")
 {
   const Genotype genotype{10, 0.5, 0.1};
@@ -191,41 +162,6 @@ TEST_CASE("Test individual reproduce method", "[IndividualTest][TestReproduce]")
   }
 }
 
-TEST_CASE("Test individual maintenance", "[IndividualTest][TestPerformMaintenanace]")
-{
-  {
-    auto rng{FSM::createRng(0)};
-
-    const Genotype genotype{10, 0.5, 0.01};
-
-    auto dude = Individual{genotype, 10};
-
-    dude.feed(20);
-
-    CHECK(dude.getResourceCount() == 20);
-
-    dude.performMaintenance(rng);
-
-    CHECK(dude.getResourceCount() == 0);
-    CHECK(dude.getPhenotype().getEnergy() == 25);
-
-    // Not enough resources. The dude could die (improbable in this case) but it won't grow.
-    dude.feed(12);
-    dude.performMaintenance(rng);
-
-    CHECK(dude.getResourceCount() == 0);
-    CHECK(dude.getPhenotype().getEnergy() == 25);
-
-    // No resources. The dude will die.
-    REQUIRE(!dude.isDead());
-    dude.performMaintenance(rng);
-
-    CHECK(dude.getResourceCount() == 0);
-    CHECK(dude.getPhenotype().getEnergy() == 25);
-    CHECK(dude.isDead());
-  }
-}
-
 TEST_CASE("Test (in)equality operators for Individual instances", "[IndividualTest][TestEquality]")
 {
   const Genotype genotype_0{10, 1, 0.5};
@@ -265,3 +201,89 @@ TEST_CASE("Test (in)equality operators for Individual instances", "[IndividualTe
     CHECK(individual_0 != individual_1);
   }
 }
+
+// The expected values of these tests are pinned to the default engine.
+#ifdef FICTIONAL_FIESTA_RNG_MT19937
+
+TEST_CASE("Test individual willReproduce method", "[IndividualTest][TestWillReproduce][mt19937]")
+{
+  {
+    auto rng{FSM::createRng(0)};
+
+    const Genotype genotype{10, 1, 0.1};
+
+    const auto individual = Individual{genotype, 0};
+
+    // Energy lower than the reproduction threshold (should be always false).
+    CHECK(!individual.willReproduce(rng));
+    CHECK(!individual.willReproduce(rng));
+    CHECK(!individual.willReproduce(rng));
+  }
+
+  {
+    auto rng{FSM::createRng(1)};
+
+    const Genotype genotype{10, 1, 0.1};
+
+    const auto individual = Individual{genotype, 10};
+
+    // Energy greater or equal than the reproduction threshold and probability 1
+    // (should be always true).
+    CHECK(individual.willReproduce(rng));
+    CHECK(individual.willReproduce(rng));
+    CHECK(individual.willReproduce(rng));
+    CHECK(individual.willReproduce(rng));
+  }
+
+  {
+    auto rng{FSM::createRng(2)};
+
+    const Genotype genotype{10, 0.5, 0.1};
+
+    const auto individual = Individual{genotype, 11};
+
+    // Energy greater or equal than the reproduction threshold and probability 0.5
+    // (some true, some false).
+    CHECK(individual.willReproduce(rng));
+    CHECK(!individual.willReproduce(rng));
+    CHECK(!individual.willReproduce(rng));
+    CHECK(individual.willReproduce(rng));
+  }
+}
+
+TEST_CASE("Test individual maintenance", "[IndividualTest][TestPerformMaintenanace][mt19937]")
+{
+  {
+    auto rng{FSM::createRng(0)};
+
+    const Genotype genotype{10, 0.5, 0.01};
+
+    auto dude = Individual{genotype, 10};
+
+    dude.feed(20);
+
+    CHECK(dude.getResourceCount() == 20);
+
+    dude.performMaintenance(rng);
+
+    CHECK(dude.getResourceCount() == 0);
+    CHECK(dude.getPhenotype().getEnergy() == 25);
+
+    // Not enough resources. The dude could die (improbable in this case) but it won't grow.
+    dude.feed(12);
+    dude.performMaintenance(rng);
+
+    CHECK(dude.getResourceCount() == 0);
+    CHECK(dude.getPhenotype().getEnergy() == 25);
+
+    // No resources. The dude will die.
+    REQUIRE(!dude.isDead());
+    dude.performMaintenance(rng);
+
+    CHECK(dude.getResourceCount() == 0);
+    CHECK(dude.getPhenotype().getEnergy() == 25);
+    CHECK(dude.isDead());
+  }
+}
+
+#endif
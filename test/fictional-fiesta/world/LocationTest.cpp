@@ -8,7 +8,9 @@
 #include "fictional-fiesta/utils/itf/Exception.h"
 #include "fictional-fiesta/utils/itf/XmlDocument.h"
 #include "fictional-fiesta/utils/itf/XmlNode.h"
+#include "fictional-fiesta/utils/itf/XmlStreamReader.h"
 
+#include "test/test_utils/itf/AllocationCounter.h"
 #include "test/test_utils/itf/BenchmarkFiles.h"
 
 #include <experimental/filesystem>
@@ -41,6 +43,35 @@ TEST_CASE("Test loading and saving locations from/to XML", "[LocationTest][TestL
   benchmarkFiles(benchmark_file, result_file, result_directory);
 }
 
+TEST_CASE("Test loading the individuals of a location in parallel",
+    "[LocationTest][TestParallelLoad]")
+{
+  Location location;
+  location.addSource(std::make_unique<ConstantSource>("Light", 10));
+  for (std::size_t index = 0; index < 3 * Location::CHUNK_SIZE + 17; ++index)
+  {
+    Individual individual{Genotype{4.0 + index % 5, 0.5, 0.01}, 1.0 + 0.25 * index};
+    individual.feed(static_cast<unsigned int>(index % 3));
+    if (index % 7 == 0)
+    {
+      individual.die();
+    }
+    location.addIndividual(individual);
+  }
+
+  const auto& result_file = result_directory / fs::path("parallel_location.xml");
+  location.save(result_file);
+  const auto expected = location.saveXmlToString();
+
+  for (const unsigned int thread_count : {1u, 4u})
+  {
+    XmlStreamReader reader{result_file};
+    const Location loaded{reader, thread_count};
+    CHECK(loaded.getPopulation().size() == 3 * Location::CHUNK_SIZE + 17);
+    CHECK(loaded.saveXmlToString() == expected);
+  }
+}
+
 TEST_CASE("Test copying a location", "[LocationTest][TestCopy]")
 {
   const auto& input_file = input_directory / fs::path("location_0.xml");
@@ -76,7 +107,190 @@ TEST_CASE("Test creating a location and saving it to XML", "[LocationTest][TestC
   benchmarkFiles(benchmark_file, result_file, result_directory);
 }
 
-TEST_CASE("Test splitting resources", "[LocationTest][TestSplitResources]")
+TEST_CASE("Test removing dead individuals", "[LocationTest][TestCleanDeadIndividuals]")
+{
+  Location location;
+
+  CHECK(location.getIndividuals().size() == 0);
+
+  const Genotype genotype{10, 0.5, 0.5};
+
+  location.addIndividual(Individual{genotype, 1}.die());
+  location.addIndividual(Individual{genotype, 1}.die());
+
+  CHECK(location.getIndividuals().size() == 2);
+
+  location.cleanDeadIndividuals();
+
+  CHECK(location.getIndividuals().size() == 0);
+
+  location.addIndividual(Individual{genotype, 1}.die());
+  location.addIndividual(Individual{genotype, 60.0});
+  location.addIndividual(Individual{genotype, 10.0});
+  location.addIndividual(Individual{genotype, 10.0});
+  location.addIndividual(Individual{genotype, 1.0});
+  location.addIndividual(Individual{genotype, 1}.die());
+  location.addIndividual(Individual{genotype, 1}.die());
+
+  CHECK(location.getIndividuals().size() == 7);
+
+  location.cleanDeadIndividuals();
+
+  CHECK(location.getIndividuals().size() == 4);
+}
+
+TEST_CASE("Test the cycle cost hint", "[LocationTest][TestCostHint]")
+{
+  Location location;
+  CHECK(location.getCostHint() == 0);
+
+  const Genotype genotype{10, 0.5, 0.5};
+  location.addIndividual(Individual{genotype, 10.0});
+  location.addIndividual(Individual{genotype, 10.0});
+  CHECK(location.getCostHint() == 2);
+
+  location.addSource(std::make_unique<ConstantSource>("Light", 40));
+  CHECK(location.getCostHint() == 82);
+
+  // The infinite sources are split in linear time.
+  location.addSource(std::make_unique<ConstantSource>("Heat", Source::INFINITY_UNITS));
+  CHECK(location.getCostHint() == 84);
+}
+
+TEST_CASE("Test the reproduction phase", "[LocationTest][TestReproductionPhase]")
+{
+  auto rng = FSM::createRng(0);
+  Location location;
+  location.addSource(std::make_unique<ConstantSource>("Light", 50));
+
+  const Genotype genotype{10, 1, 0.01};
+  location.addIndividual(Individual{genotype, 60.0});
+
+  CHECK(location.getIndividuals().size() == 1);
+  location.reproductionPhase(rng);
+
+  const auto& individuals = location.getIndividuals();
+  REQUIRE(individuals.size() == 2);
+
+  CHECK(individuals[0].getPhenotype().getEnergy() == 30);
+  CHECK(individuals[1].getPhenotype().getEnergy() == 30);
+}
+
+TEST_CASE("Test the resource split mode", "[LocationTest][TestResourceSplitMode]")
+{
+  Location location;
+  CHECK(location.getResourceSplitMode() == ResourceSplitter::Mode::Unit);
+
+  location.setResourceSplitMode(ResourceSplitter::Mode::Bulk);
+  CHECK(!location.isShardedResourceSplit());
+  location.setShardedResourceSplit(true);
+  location.addSource(std::make_unique<ConstantSource>("Light", 40));
+
+  const Genotype genotype{10, 0.5, 0.5};
+  location.addIndividual(Individual{genotype, 60.0});
+  location.addIndividual(Individual{genotype, 10.0});
+  location.addIndividual(Individual{genotype, 1.0});
+
+  const auto copied_location = location;
+  CHECK(copied_location.getResourceSplitMode() == ResourceSplitter::Mode::Bulk);
+  CHECK(copied_location.isShardedResourceSplit());
+
+  auto rng = FSM::createRng(0);
+  location.splitResources(rng);
+
+  unsigned int total_resources = 0;
+  for (const auto& individual : location.getIndividuals())
+  {
+    total_resources += individual.getResourceCount();
+  }
+  CHECK(total_resources > 0);
+  CHECK(total_resources <= 40);
+}
+
+TEST_CASE("Test that the phases do not depend on the number of threads",
+    "[LocationTest][TestThreadCount]")
+{
+  // Several chunks, the last one incomplete.
+  const auto create_location = []()
+  {
+    Location location;
+    location.addSource(std::make_unique<ConstantSource>("Light", 30000));
+
+    const Genotype genotype{4, 1, 0.01};
+    for (std::size_t index = 0; index < 2 * Location::CHUNK_SIZE + 1808; ++index)
+    {
+      location.addIndividual(Individual{genotype, 2.0 + index % 5});
+    }
+    return location;
+  };
+
+  std::vector<Individual> reference;
+  for (const unsigned int thread_count : {1u, 2u, 3u, 8u})
+  {
+    auto location = create_location();
+    CHECK(location.getThreadCount() == 1);
+    location.setThreadCount(thread_count);
+    CHECK(location.getThreadCount() == thread_count);
+
+    auto rng = FSM::createRng(0);
+    for (unsigned int cycle = 0; cycle < 3; ++cycle)
+    {
+      location.cycle(rng);
+    }
+
+    const auto individuals = location.getIndividuals();
+    REQUIRE(individuals.size() > 2 * Location::CHUNK_SIZE);
+    if (reference.empty())
+    {
+      reference = individuals;
+    }
+    CHECK(individuals == reference);
+  }
+}
+
+TEST_CASE("Test that the reproduction phase does not allocate in steady state",
+    "[LocationTest][TestReproductionAllocations]")
+{
+  auto rng = FSM::createRng(0);
+  Location location;
+  location.addSource(std::make_unique<ConstantSource>("Light", 400));
+
+  const Genotype genotype{4, 1, 0.01};
+  for (unsigned int index = 0; index < 40; ++index)
+  {
+    location.addIndividual(Individual{genotype, 4.0});
+  }
+
+  // Let the population reach its carrying capacity.
+  for (unsigned int cycle = 0; cycle < 100; ++cycle)
+  {
+    location.cycle(rng);
+  }
+
+  std::size_t births = 0;
+  std::size_t allocations = 0;
+  for (unsigned int cycle = 0; cycle < 20; ++cycle)
+  {
+    location.resourcePhase(rng);
+    location.maintenancePhase(rng);
+
+    const auto size = location.getPopulation().size();
+    const auto previous_allocations = getAllocationCount();
+    location.reproductionPhase(rng);
+    allocations += getAllocationCount() - previous_allocations;
+    births += location.getPopulation().size() - size;
+
+    location.cleanDeadIndividuals();
+  }
+
+  REQUIRE(births > 0);
+  CHECK(allocations == 0);
+}
+
+// The expected values of these tests are pinned to the default engine.
+#ifdef FICTIONAL_FIESTA_RNG_MT19937
+
+TEST_CASE("Test splitting resources", "[LocationTest][TestSplitResources][mt19937]")
 {
   auto rng = FSM::createRng(1);
   Location location;
@@ -103,39 +317,40 @@ TEST_CASE("Test splitting resources", "[LocationTest][TestSplitResources]")
   CHECK(individuals[4].getResourceCount() == 1);
 }
 
-TEST_CASE("Test removing dead individuals", "[LocationTest][TestCleanDeadIndividuals]")
+TEST_CASE("Test that the phases leave tombstones", "[LocationTest][TestTombstones][mt19937]")
 {
+  auto rng = FSM::createRng(0);
   Location location;
-
-  CHECK(location.getIndividuals().size() == 0);
+  location.addSource(std::make_unique<ConstantSource>("Light", 50));
 
   const Genotype genotype{10, 0.5, 0.5};
-
-  location.addIndividual(Individual{genotype, 1}.die());
-  location.addIndividual(Individual{genotype, 1}.die());
-
-  CHECK(location.getIndividuals().size() == 2);
-
-  location.cleanDeadIndividuals();
-
-  CHECK(location.getIndividuals().size() == 0);
-
-  location.addIndividual(Individual{genotype, 1}.die());
   location.addIndividual(Individual{genotype, 60.0});
   location.addIndividual(Individual{genotype, 10.0});
   location.addIndividual(Individual{genotype, 10.0});
+  location.addIndividual(Individual{genotype, 10.0});
   location.addIndividual(Individual{genotype, 1.0});
-  location.addIndividual(Individual{genotype, 1}.die());
-  location.addIndividual(Individual{genotype, 1}.die());
 
-  CHECK(location.getIndividuals().size() == 7);
+  location.resourcePhase(rng);
+  location.maintenancePhase(rng);
 
-  location.cleanDeadIndividuals();
+  // The dead individuals are still stored, but they are not visible.
+  const auto& population = location.getPopulation();
+  CHECK(population.size() == 5);
+  CHECK(population.getDeadCount() == 2);
+  CHECK(location.getIndividuals().size() == 3);
 
+  // Adding an individual compacts the population, so it can be a dead one.
+  location.addIndividual(Individual{genotype, 1}.die());
+  CHECK(population.size() == 4);
   CHECK(location.getIndividuals().size() == 4);
+
+  location.cleanDeadIndividuals();
+  CHECK(population.size() == 3);
+  CHECK(population.getDeadCount() == 0);
+  CHECK(location.getIndividuals().size() == 3);
 }
 
-TEST_CASE("Test the resource phase", "[LocationTest][TestResourcePhase]")
+TEST_CASE("Test the resource phase", "[LocationTest][TestResourcePhase][mt19937]")
 {
   auto rng = FSM::createRng(0);
   Location location;
@@ -154,14 +369,14 @@ TEST_CASE("Test the resource phase", "[LocationTest][TestResourcePhase]")
   const auto& individuals = location.getIndividuals();
   REQUIRE(individuals.size() == 5);
 
-  CHECK(individuals[0].getResourceCount() == 31);
-  CHECK(individuals[1].getResourceCount() == 2);
-  CHECK(individuals[2].getResourceCount() == 3);
-  CHECK(individuals[3].getResourceCount() == 4);
+  CHECK(individuals[0].getResourceCount() == 28);
+  CHECK(individuals[1].getResourceCount() == 4);
+  CHECK(individuals[2].getResourceCount() == 6);
+  CHECK(individuals[3].getResourceCount() == 2);
   CHECK(individuals[4].getResourceCount() == 0);
 }
 
-TEST_CASE("Test the maintenance phase", "[LocationTest][TestMaintenancePhase]")
+TEST_CASE("Test the maintenance phase", "[LocationTest][TestMaintenancePhase][mt19937]")
 {
   auto rng = FSM::createRng(0);
   Location location;
@@ -181,31 +396,12 @@ TEST_CASE("Test the maintenance phase", "[LocationTest][TestMaintenancePhase]")
   const auto& individuals = location.getIndividuals();
   REQUIRE(individuals.size() == 3);
 
-  CHECK(individuals[0].getPhenotype().getEnergy() == 68);
-  CHECK(individuals[1].getPhenotype().getEnergy() == 10);
-  CHECK(individuals[2].getPhenotype().getEnergy() == 11);
-}
-
-TEST_CASE("Test the reproduction phase", "[LocationTest][TestReproductionPhase]")
-{
-  auto rng = FSM::createRng(0);
-  Location location;
-  location.addSource(std::make_unique<ConstantSource>("Light", 50));
-
-  const Genotype genotype{10, 1, 0.01};
-  location.addIndividual(Individual{genotype, 60.0});
-
-  CHECK(location.getIndividuals().size() == 1);
-  location.reproductionPhase(rng);
-
-  const auto& individuals = location.getIndividuals();
-  REQUIRE(individuals.size() == 2);
-
-  CHECK(individuals[0].getPhenotype().getEnergy() == 30);
-  CHECK(individuals[1].getPhenotype().getEnergy() == 30);
+  CHECK(individuals[0].getPhenotype().getEnergy() == 10);
+  CHECK(individuals[1].getPhenotype().getEnergy() == 13);
+  CHECK(individuals[2].getPhenotype().getEnergy() == 10);
 }
 
-TEST_CASE("Test the cycle execution", "[LocationTest][TestCycle]")
+TEST_CASE("Test the cycle execution", "[LocationTest][TestCycle][mt19937]")
 {
   auto rng = FSM::createRng(0);
   Location location;
@@ -221,5 +417,7 @@ TEST_CASE("Test the cycle execution", "[LocationTest][TestCycle]")
   CHECK(location.getIndividuals().size() == 5);
   location.cycle(rng);
 
-  CHECK(location.getIndividuals().size() == 4);
+  CHECK(location.getIndividuals().size() == 6);
 }
+
+#endif
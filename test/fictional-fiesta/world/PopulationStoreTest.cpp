@@ -0,0 +1,415 @@
+#include "catch/catch.hpp"
+
+#include "fictional-fiesta/world/itf/PopulationStore.h"
+
+#include "fictional-fiesta/world/itf/Genotype.h"
+#include "fictional-fiesta/world/itf/Individual.h"
+
+#include "fictional-fiesta/utils/itf/BinaryWriter.h"
+
+#include <experimental/filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace fs = std::experimental::filesystem;
+using namespace fictionalfiesta;
+
+static const fs::path result_directory = fs::path(TEST_BINARY_DIRECTORY)
+    / fs::path("fictional-fiesta/world/result");
+
+namespace
+{
+
+/// The traits are exactly representable in single precision, so they are stored without
+/// rounding in the compact build too.
+std::vector<Individual> create_individuals()
+{
+  std::vector<Individual> individuals;
+  individuals.push_back(Individual{Genotype{10, 1, 0.125}, 4});
+  individuals.push_back(Individual{Genotype{3, 0.4375, 0.5}, 1}.die());
+  individuals.push_back(Individual{Genotype{7, 0.25, 0.0625}, 20}.feed(13));
+  individuals.push_back(Individual{Genotype{1, 0.875, 0.3125}, 2.5}.feed(5));
+  return individuals;
+}
+
+std::string read_file(const fs::path& filePath)
+{
+  std::ifstream stream(filePath, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+/// Individual with its genotype traits rounded as the population stores them.
+Individual stored(const Individual& individual)
+{
+  const auto& genotype = individual.getGenotype();
+  const auto stored_genotype = Genotype{
+      static_cast<PopulationStore::Trait>(genotype.getReproductionEnergyThreshold()),
+      static_cast<PopulationStore::Trait>(genotype.getReproductionProbability()),
+      static_cast<PopulationStore::Trait>(genotype.getMutabilityRatio())};
+
+  auto result = Individual{stored_genotype, individual.getPhenotype().getEnergy()};
+  result.feed(individual.getResourceCount());
+  if (individual.isDead())
+  {
+    result.die();
+  }
+  return result;
+}
+
+PopulationStore create_population(const std::vector<Individual>& individuals)
+{
+  PopulationStore population;
+  for (const auto& individual : individuals)
+  {
+    population.addIndividual(individual);
+  }
+  return population;
+}
+
+} // anonymous namespace
+
+TEST_CASE("Test adding and getting individuals", "[PopulationStoreTest][TestAddAndGet]")
+{
+  PopulationStore empty_population;
+  CHECK(empty_population.empty());
+  CHECK(empty_population.size() == 0);
+
+  const auto individuals = create_individuals();
+  auto population = create_population(individuals);
+
+  REQUIRE(population.size() == individuals.size());
+  CHECK(!population.empty());
+  CHECK(population.getIndividuals() == individuals);
+
+  for (std::size_t index = 0; index < individuals.size(); ++index)
+  {
+    const auto& individual = individuals[index];
+    CHECK(population.getIndividual(index) == individual);
+    CHECK(population.getGenotype(index) == individual.getGenotype());
+    CHECK(population.getEnergy(index) == individual.getPhenotype().getEnergy());
+    CHECK(population.getResourceCount(index) == individual.getResourceCount());
+    CHECK(population.isDead(index) == individual.isDead());
+    CHECK(population.isHungry(index) == individual.isHungry());
+    CHECK(population.getUnitsToSatiety(index) == individual.getUnitsToSatiety());
+  }
+
+  CHECK(population.getDeadCount() == 1);
+  population.setIndividual(1, individuals[0]);
+  CHECK(population.getDeadCount() == 0);
+  CHECK(population.getIndividual(1) == individuals[0]);
+  CHECK(population.getIndividual(0) == individuals[0]);
+}
+
+TEST_CASE("Test feeding and killing individuals", "[PopulationStoreTest][TestFeedAndDie]")
+{
+  auto population = create_population(create_individuals());
+
+  CHECK(population.isHungry(0));
+  CHECK(population.getUnitsToSatiety(0) == 4);
+  population.feed(0, 3);
+  CHECK(population.getResourceCount(0) == 3);
+  CHECK(population.isHungry(0));
+  population.feed(0, 1);
+  CHECK(!population.isHungry(0));
+  CHECK(population.getUnitsToSatiety(0) == 0);
+
+  CHECK(!population.isDead(2));
+  population.die(2);
+  CHECK(population.isDead(2));
+  population.die(2);
+  CHECK(population.getDeadCount() == 2);
+
+  const auto& dead_flags = population.getDeadFlags();
+  CHECK(dead_flags == PopulationStore::DeadFlags{false, true, true, false});
+  CHECK(population.getResourceCounts() == std::vector<unsigned int>{4, 0, 13, 5});
+  CHECK(population.getEnergies() == std::vector<double>{4, 1, 20, 2.5});
+}
+
+TEST_CASE("Test removing the dead individuals", "[PopulationStoreTest][TestRemoveDead]")
+{
+  auto individuals = create_individuals();
+  auto population = create_population(individuals);
+  population.die(0);
+  CHECK(population.getDeadCount() == 2);
+  population.removeDead();
+
+  REQUIRE(population.size() == 2);
+  CHECK(population.getDeadCount() == 0);
+  CHECK(population.getIndividual(0) == individuals[2]);
+  CHECK(population.getIndividual(1) == individuals[3]);
+  CHECK(population.getDeadFlags() == PopulationStore::DeadFlags{false, false});
+
+  population.die(0);
+  population.die(1);
+  population.removeDead();
+  CHECK(population.empty());
+}
+
+TEST_CASE("Test saving the living individuals", "[PopulationStoreTest][TestSaveLiving]")
+{
+  // Several blocks of every column, with dead individuals across their boundaries.
+  PopulationStore population;
+  for (unsigned int index = 0; index < 1500; ++index)
+  {
+    Individual individual{Genotype{1.0 + index, 0.5, 0.25}, 0.75 * index};
+    individual.feed(index);
+    if (index % 3 == 0)
+    {
+      individual.die();
+    }
+    population.addIndividual(individual);
+  }
+
+  const auto living_file = result_directory / fs::path("population_living.ffsnap");
+  {
+    BinaryWriter writer{living_file};
+    population.saveLiving(writer);
+    writer.close();
+  }
+  CHECK(population.size() == 1500);
+
+  const auto removed_file = result_directory / fs::path("population_removed.ffsnap");
+  {
+    auto living_population = population;
+    living_population.removeDead();
+    BinaryWriter writer{removed_file};
+    living_population.save(writer);
+    writer.close();
+  }
+
+  CHECK(read_file(living_file) == read_file(removed_file));
+}
+
+TEST_CASE("Test that the phases match the Individual ones",
+    "[PopulationStoreTest][TestPhasesMatchIndividual]")
+{
+  auto individuals = create_individuals();
+  auto population = create_population(individuals);
+
+  // Same seed, same draws in the same order.
+  auto individual_rng = FSM::createRng(5);
+  auto population_rng = FSM::createRng(5);
+
+  for (unsigned int cycle = 0; cycle < 20; ++cycle)
+  {
+    // The population appends the offspring right away, the stillborn ones are not stored.
+    const auto parent_count = individuals.size();
+    std::vector<Individual> offspring;
+    for (std::size_t index = 0; index < parent_count; ++index)
+    {
+      individuals[index].feed(3);
+      population.feed(index, 3);
+
+      individuals[index].performMaintenance(individual_rng);
+      population.performMaintenance(index, population_rng);
+
+      const bool will_reproduce = individuals[index].willReproduce(individual_rng);
+      REQUIRE(population.willReproduce(index, population_rng) == will_reproduce);
+      if (will_reproduce)
+      {
+        const auto child = individuals[index].reproduce(individual_rng);
+        CHECK(population.reproduce(index, population_rng) == !child.isDead());
+        if (!child.isDead())
+        {
+          offspring.push_back(stored(child));
+        }
+      }
+    }
+
+    individuals.insert(individuals.end(), offspring.begin(), offspring.end());
+    REQUIRE(population.getIndividuals() == individuals);
+  }
+}
+
+TEST_CASE("Test reproducing into another population",
+    "[PopulationStoreTest][TestReproduceIntoOffspring]")
+{
+  const auto individuals = create_individuals();
+  auto in_place = create_population(individuals);
+  auto parents = create_population(individuals);
+  PopulationStore offspring;
+
+  // Same keyed streams, so the same draws.
+  for (std::size_t index = 0; index < individuals.size(); ++index)
+  {
+    auto in_place_rng = FSM::createStream(7, {index});
+    auto parents_rng = FSM::createStream(7, {index});
+    REQUIRE(in_place.willReproduce(index, in_place_rng) ==
+        parents.willReproduce(index, parents_rng));
+    in_place.reproduce(index, in_place_rng);
+    parents.reproduce(index, parents_rng, offspring);
+  }
+
+  REQUIRE(parents.size() == individuals.size());
+  CHECK(offspring.size() == in_place.size() - individuals.size());
+
+  parents.append(offspring);
+  CHECK(parents.getIndividuals() == in_place.getIndividuals());
+
+  offspring.clear();
+  CHECK(offspring.empty());
+  CHECK(offspring.getDeadCount() == 0);
+}
+
+TEST_CASE("Test the batched phases", "[PopulationStoreTest][TestBatchedPhases]")
+{
+  // More individuals than a batch, with all kinds of starvation and reproduction odds.
+  PopulationStore population;
+  for (unsigned int index = 0; index < 3 * FSM::StreamBatch::SIZE + 5; ++index)
+  {
+    auto individual = Individual{Genotype{4, (index % 5) / 4.0, 0.125}, 2.0 + index % 7};
+    individual.feed(index % 9);
+    if (index % 11 == 0)
+    {
+      individual.die();
+    }
+    population.addIndividual(individual);
+  }
+  const auto individuals = population.getIndividuals();
+
+  // Every range boundary gives the same result, since every individual has its own stream.
+  for (const std::size_t split : {std::size_t{0}, std::size_t{7}, FSM::StreamBatch::SIZE})
+  {
+    auto batched = population;
+    batched.performMaintenance(0, split, 13);
+    batched.performMaintenance(split, batched.size(), 13);
+
+    PopulationStore offspring;
+    batched.reproduce(0, split, 17, offspring);
+    batched.reproduce(split, batched.size(), 17, offspring);
+
+    auto whole = population;
+    whole.performMaintenance(0, whole.size(), 13);
+    PopulationStore whole_offspring;
+    whole.reproduce(0, whole.size(), 17, whole_offspring);
+
+    CHECK(batched.getIndividuals() == whole.getIndividuals());
+    CHECK(offspring.getIndividuals() == whole_offspring.getIndividuals());
+  }
+
+  auto batched = population;
+  batched.performMaintenance(0, batched.size(), 13);
+  auto parents = batched;
+  PopulationStore offspring;
+  parents.reproduce(0, parents.size(), 17, offspring);
+  CHECK(!offspring.empty());
+
+  for (std::size_t index = 0; index < individuals.size(); ++index)
+  {
+    const auto& individual = individuals[index];
+    if (individual.isDead())
+    {
+      // The dead individuals are left as they are.
+      CHECK(batched.getIndividual(index) == individual);
+      continue;
+    }
+
+    // The surviving individuals gain the same surplus as with the scalar phases.
+    const auto energy = individual.getPhenotype().getEnergy();
+    CHECK(batched.getResourceCount(index) == 0);
+    if (!batched.isDead(index))
+    {
+      CHECK(batched.getEnergy(index) ==
+          energy + Individual::survivalSurplus(energy, individual.getResourceCount()));
+    }
+
+    const auto probability = Individual::starvationProbability(energy,
+        individual.getResourceCount());
+    if (probability == 0)
+    {
+      CHECK(!batched.isDead(index));
+    }
+    if (probability == 1)
+    {
+      CHECK(batched.isDead(index));
+    }
+  }
+}
+
+TEST_CASE("Test reproducing in place from plans", "[PopulationStoreTest][TestReproductionPlan]")
+{
+  PopulationStore population;
+  for (unsigned int index = 0; index < 3 * FSM::StreamBatch::SIZE + 5; ++index)
+  {
+    auto individual = Individual{Genotype{4, (index % 5) / 4.0, 0.125}, 2.0 + index % 7};
+    if (index % 11 == 0)
+    {
+      individual.die();
+    }
+    population.addIndividual(individual);
+  }
+
+  auto appended = population;
+  PopulationStore offspring;
+  appended.reproduce(0, appended.size(), 17, offspring);
+  appended.append(offspring);
+
+  // The births of every range are counted first, and the ranges are written in any order.
+  const auto parent_count = population.size();
+  const auto split = FSM::StreamBatch::SIZE + 3;
+  PopulationStore::ReproductionPlan first_plan;
+  PopulationStore::ReproductionPlan second_plan;
+  const auto first_births = population.planReproduction(0, split, 17, first_plan);
+  const auto second_births = population.planReproduction(split, parent_count, 17, second_plan);
+  CHECK(first_births + second_births == offspring.size());
+  CHECK(first_plan.stillborn.size() == first_plan.parents.size());
+
+  population.resize(parent_count + first_births + second_births);
+  population.reproduce(second_plan, 17, population, parent_count + first_births);
+  population.reproduce(first_plan, 17, population, parent_count);
+
+  CHECK(population.getIndividuals() == appended.getIndividuals());
+}
+
+TEST_CASE("Test the batched mutations", "[PopulationStoreTest][TestBatchedMutations]")
+{
+  // Every parent reproduces, and deadly mutations are very unlikely.
+  const auto genotype = Genotype{2, 1, 0.001};
+  PopulationStore population;
+  for (unsigned int index = 0; index < FSM::StreamBatch::SIZE + 3; ++index)
+  {
+    population.addIndividual(Individual{genotype, 4.0 + index});
+  }
+
+  PopulationStore offspring;
+  population.reproduce(0, population.size(), 3, offspring);
+  REQUIRE(offspring.size() == population.size());
+
+  // Same mutations as Genotype::reproduce on the rest of the stream of the parent.
+  for (std::size_t index = 0; index < population.size(); ++index)
+  {
+    auto rng = FSM::createStream(3, {index});
+    rng.discard(1);
+    const auto parent_genotype = population.getGenotype(index);
+    const auto child = Individual{parent_genotype.reproduce(rng), (4.0 + index) / 2};
+    CHECK(offspring.getIndividual(index) == stored(child));
+    CHECK(population.getEnergy(index) == (4.0 + index) / 2);
+  }
+}
+
+TEST_CASE("Test the memory used per individual", "[PopulationStoreTest][TestMemoryUsage]")
+{
+  INFO("Bytes per individual: " << PopulationStore::BYTES_PER_INDIVIDUAL << " (Individual: "
+      << sizeof(Individual) << ")");
+
+#ifdef FICTIONAL_FIESTA_COMPACT_POPULATION
+  CHECK(PopulationStore::BYTES_PER_INDIVIDUAL <= 24.125);
+#else
+  CHECK(PopulationStore::BYTES_PER_INDIVIDUAL <= 37);
+#endif
+  CHECK(PopulationStore::BYTES_PER_INDIVIDUAL < sizeof(Individual) / 2.0);
+
+  const std::size_t size = 1000;
+  PopulationStore population;
+  CHECK(population.getMemoryUsage() == 0);
+  population.reserve(size);
+  for (std::size_t index = 0; index < size; ++index)
+  {
+    population.addIndividual(Individual{Genotype{10, 1, 0.125}, 4});
+  }
+
+  const double bytes_per_individual = static_cast<double>(population.getMemoryUsage()) / size;
+  CHECK(bytes_per_individual == Approx(PopulationStore::BYTES_PER_INDIVIDUAL).margin(0.01));
+}
@@ -0,0 +1,381 @@
+#include "catch/catch.hpp"
+
+#include "fictional-fiesta/world/itf/ResourceSplitter.h"
+
+#include "fictional-fiesta/world/itf/ConstantSource.h"
+#include "fictional-fiesta/world/itf/Genotype.h"
+#include "fictional-fiesta/world/itf/Individual.h"
+#include "fictional-fiesta/world/itf/PopulationStore.h"
+
+#include "fictional-fiesta/utils/itf/Exception.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace fictionalfiesta;
+
+namespace
+{
+
+const Genotype genotype{10, 0.5, 0.5};
+
+const std::vector<ResourceSplitter::Mode> all_modes{ResourceSplitter::Mode::Unit,
+    ResourceSplitter::Mode::Bulk, ResourceSplitter::Mode::Sweep};
+
+PopulationStore create_population(const std::vector<double>& energies)
+{
+  PopulationStore population;
+  for (const auto energy : energies)
+  {
+    population.addIndividual(Individual{genotype, energy});
+  }
+  return population;
+}
+
+unsigned int total_resources(const PopulationStore& population)
+{
+  unsigned int total = 0;
+  for (std::size_t index = 0; index < population.size(); ++index)
+  {
+    total += population.getResourceCount(index);
+  }
+  return total;
+}
+
+/// Average resource count of each individual and average number of deaths over several splits.
+struct SplitStatistics
+{
+  std::vector<double> resources;
+  double deaths = 0;
+};
+
+/// Population spanning several shards: a shard of very hungry individuals followed by a shard
+/// and a half of individuals that get satiated with one unit.
+std::vector<double> sharded_energies()
+{
+  std::vector<double> energies(ResourceSplitter::SHARD_SIZE * 5 / 2, 1.0);
+  std::fill(energies.begin(), energies.begin() + ResourceSplitter::SHARD_SIZE, 10.0);
+  return energies;
+}
+
+/// Average units eaten in each shard and average number of deaths over several splits.
+SplitStatistics shard_statistics(bool sharded, ResourceSplitter::Mode mode,
+    const std::vector<double>& energies, unsigned int units, unsigned int repetitions)
+{
+  auto rng = FSM::createRng(2);
+  SplitStatistics statistics;
+  const auto shard_count =
+      (energies.size() + ResourceSplitter::SHARD_SIZE - 1) / ResourceSplitter::SHARD_SIZE;
+  statistics.resources.resize(shard_count, 0.0);
+  for (unsigned int repetition = 0; repetition < repetitions; ++repetition)
+  {
+    auto population = create_population(energies);
+    ConstantSource source("Light", units);
+    if (sharded)
+    {
+      ResourceSplitter::splitSharded(mode, source, population, rng, 3);
+    }
+    else
+    {
+      ResourceSplitter::split(mode, source, population, rng);
+    }
+    REQUIRE(total_resources(population) + source.getCurrentUnitCount() == units);
+
+    for (std::size_t index = 0; index < population.size(); ++index)
+    {
+      statistics.resources[index / ResourceSplitter::SHARD_SIZE] +=
+          population.getResourceCount(index);
+      statistics.deaths += population.isDead(index) ? 1 : 0;
+    }
+  }
+
+  for (auto& resource : statistics.resources)
+  {
+    resource /= repetitions;
+  }
+  statistics.deaths /= repetitions;
+  return statistics;
+}
+
+} // anonymous namespace
+
+TEST_CASE("Test getting the split modes from their names",
+    "[ResourceSplitterTest][TestModeFromString]")
+{
+  CHECK(ResourceSplitter::modeFromString("unit") == ResourceSplitter::Mode::Unit);
+  CHECK(ResourceSplitter::modeFromString("bulk") == ResourceSplitter::Mode::Bulk);
+  CHECK(ResourceSplitter::modeFromString("sweep") == ResourceSplitter::Mode::Sweep);
+  REQUIRE_THROWS_AS(ResourceSplitter::modeFromString("Bulk"), Exception);
+  REQUIRE_THROWS_AS(ResourceSplitter::modeFromString(""), Exception);
+
+  for (const auto mode : {ResourceSplitter::Mode::Unit, ResourceSplitter::Mode::Bulk,
+      ResourceSplitter::Mode::Sweep})
+  {
+    CHECK(ResourceSplitter::modeFromString(ResourceSplitter::modeToString(mode)) == mode);
+  }
+}
+
+TEST_CASE("Test that splitting conserves the resource units",
+    "[ResourceSplitterTest][TestConservation]")
+{
+  const std::vector<double> energies{60, 10, 10, 10, 1, 0.5, 33.3};
+  auto rng = FSM::createRng(3);
+
+  for (const auto mode : all_modes)
+  {
+    for (const unsigned int units : {0u, 1u, 10u, 50u, 200u})
+    {
+      auto population = create_population(energies);
+      ConstantSource source("Light", units);
+      ResourceSplitter::split(mode, source, population, rng);
+
+      CHECK(total_resources(population) + source.getCurrentUnitCount() == units);
+
+      for (std::size_t index = 0; index < population.size(); ++index)
+      {
+        // Nobody eats once it is satiated.
+        CHECK(population.getResourceCount(index) <= std::ceil(population.getEnergy(index)));
+
+        // Units are only left when nobody can eat them.
+        if (source.getCurrentUnitCount() > 0)
+        {
+          CHECK((population.isDead(index) || !population.isHungry(index)));
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Test that dead and satiated individuals do not compete",
+    "[ResourceSplitterTest][TestNoCompetitors]")
+{
+  auto rng = FSM::createRng(0);
+
+  for (const auto mode : all_modes)
+  {
+    PopulationStore population;
+    population.addIndividual(Individual{genotype, 10}.die());
+    population.addIndividual(Individual{genotype, 3}.feed(3));
+
+    ConstantSource source("Light", 10);
+    ResourceSplitter::split(mode, source, population, rng);
+
+    CHECK(source.getCurrentUnitCount() == 10);
+    CHECK(population.getResourceCount(0) == 0);
+    CHECK(population.getResourceCount(1) == 3);
+  }
+}
+
+TEST_CASE("Test splitting an infinite source", "[ResourceSplitterTest][TestInfiniteSource]")
+{
+  auto rng = FSM::createRng(0);
+
+  for (const auto mode : all_modes)
+  {
+    // Everybody eats until it is satiated or dies.
+    const std::size_t population_size = 5000;
+    auto population = create_population(std::vector<double>(population_size, 10));
+    population.addIndividual(Individual{genotype, 1e6});
+    population.addIndividual(Individual{genotype, 10}.die());
+
+    ConstantSource source("Light", Source::INFINITY_UNITS);
+    ResourceSplitter::split(mode, source, population, rng);
+
+    CHECK(source.getCurrentUnitCount() == Source::INFINITY_UNITS);
+    CHECK(population.getResourceCount(population_size + 1) == 0);
+
+    double deaths = 0;
+    for (std::size_t index = 0; index < population_size; ++index)
+    {
+      CHECK((population.isDead(index) || !population.isHungry(index)));
+      CHECK(population.getResourceCount(index) <= 10);
+      if (population.isDead(index))
+      {
+        ++deaths;
+      }
+      else
+      {
+        CHECK(population.getResourceCount(index) == 10);
+      }
+    }
+
+    // Probability of dying in any of the 10 units eaten.
+    const double death_probability =
+        1 - std::pow(1 - ResourceSplitter::FEEDING_DEATH_PROBABILITY, 10);
+    CHECK(deaths / population_size == Approx(death_probability).margin(0.03));
+
+    // A very hungry individual certainly dies before getting satiated.
+    CHECK(population.isDead(population_size));
+  }
+}
+
+TEST_CASE("Test that the feeding deaths follow a binomial distribution",
+    "[ResourceSplitterTest][TestFeedingDeaths]")
+{
+  // The individuals never get satiated and there are enough of them to eat all the units, so
+  // every unit is eaten and kills independently with the feeding death probability.
+  const unsigned int units = 100;
+  const unsigned int repetitions = 20000;
+  const double probability = ResourceSplitter::FEEDING_DEATH_PROBABILITY;
+  const std::vector<double> energies(units + 1, 1e6);
+
+  for (const auto mode : all_modes)
+  {
+    auto rng = FSM::createRng(1);
+    std::vector<unsigned int> histogram(units + 1, 0);
+    for (unsigned int repetition = 0; repetition < repetitions; ++repetition)
+    {
+      auto population = create_population(energies);
+      ConstantSource source("Light", units);
+      ResourceSplitter::split(mode, source, population, rng);
+
+      REQUIRE(source.empty());
+      unsigned int deaths = 0;
+      for (std::size_t index = 0; index < population.size(); ++index)
+      {
+        deaths += population.isDead(index) ? 1 : 0;
+      }
+      ++histogram[deaths];
+    }
+
+    // Compare the observed histogram with the one of the reference per-unit Bernoulli draws.
+    double mean = 0;
+    double second_moment = 0;
+    double pmf = std::pow(1 - probability, units);
+    for (unsigned int deaths = 0; deaths <= 12; ++deaths)
+    {
+      const double frequency = static_cast<double>(histogram[deaths]) / repetitions;
+      CHECK(frequency == Approx(pmf).margin(0.01));
+      pmf *= (units - deaths) / (deaths + 1.0) * probability / (1 - probability);
+    }
+
+    for (unsigned int deaths = 0; deaths <= units; ++deaths)
+    {
+      mean += static_cast<double>(deaths) * histogram[deaths] / repetitions;
+      second_moment += static_cast<double>(deaths) * deaths * histogram[deaths] / repetitions;
+    }
+
+    CHECK(mean == Approx(units * probability).epsilon(0.03));
+    CHECK(second_moment - mean * mean ==
+        Approx(units * probability * (1 - probability)).epsilon(0.05));
+  }
+}
+
+TEST_CASE("Test that the sharded split is statistically equivalent to the serial one",
+    "[ResourceSplitterTest][TestShardedEquivalence]")
+{
+  const unsigned int repetitions = 60;
+  const auto energies = sharded_energies();
+
+  // Scarce units, units enough to satiate the small individuals (so some shards are left with
+  // units to redistribute) and units for everybody.
+  for (const unsigned int units : {10000u, 40000u, 60000u})
+  {
+    const auto serial = shard_statistics(false, ResourceSplitter::Mode::Unit, energies, units,
+        repetitions);
+
+    for (const auto mode : all_modes)
+    {
+      const auto sharded = shard_statistics(true, mode, energies, units, repetitions);
+      for (std::size_t shard = 0; shard < serial.resources.size(); ++shard)
+      {
+        CHECK(sharded.resources[shard] == Approx(serial.resources[shard]).epsilon(0.03));
+      }
+      CHECK(sharded.deaths == Approx(serial.deaths).epsilon(0.05));
+    }
+  }
+}
+
+TEST_CASE("Test that the sharded split does not depend on the number of threads",
+    "[ResourceSplitterTest][TestShardedThreadCount]")
+{
+  const auto energies = sharded_energies();
+
+  for (const auto units : {0u, 30000u, Source::INFINITY_UNITS})
+  {
+    std::vector<unsigned int> reference;
+    for (const unsigned int thread_count : {1u, 2u, 4u})
+    {
+      auto rng = FSM::createRng(4);
+      auto population = create_population(energies);
+      ConstantSource source("Light", units);
+      ResourceSplitter::splitSharded(ResourceSplitter::Mode::Unit, source, population, rng,
+          thread_count);
+
+      const auto& resource_counts = population.getResourceCounts();
+      if (reference.empty())
+      {
+        reference = resource_counts;
+      }
+      CHECK(resource_counts == reference);
+    }
+  }
+}
+
+// The expected values of these tests are pinned to the default engine.
+#ifdef FICTIONAL_FIESTA_RNG_MT19937
+
+namespace
+{
+
+SplitStatistics split_statistics(ResourceSplitter::Mode mode, const std::vector<double>& energies,
+    unsigned int units, unsigned int repetitions)
+{
+  auto rng = FSM::createRng(0);
+  SplitStatistics statistics;
+  statistics.resources.resize(energies.size(), 0.0);
+  for (unsigned int repetition = 0; repetition < repetitions; ++repetition)
+  {
+    auto population = create_population(energies);
+    ConstantSource source("Light", units);
+    ResourceSplitter::split(mode, source, population, rng);
+
+    for (std::size_t index = 0; index < population.size(); ++index)
+    {
+      statistics.resources[index] += population.getResourceCount(index);
+      statistics.deaths += population.isDead(index) ? 1 : 0;
+    }
+  }
+
+  for (auto& resource : statistics.resources)
+  {
+    resource /= repetitions;
+  }
+  statistics.deaths /= repetitions;
+  return statistics;
+}
+
+} // anonymous namespace
+
+TEST_CASE("Test that the batched splits are statistically equivalent to the unit split",
+    "[ResourceSplitterTest][TestBatchEquivalence][mt19937]")
+{
+  const unsigned int repetitions = 4000;
+
+  // Scarce resources (the satiety caps are rarely hit) and abundant resources (most of the
+  // individuals get satiated or die).
+  const std::vector<std::pair<std::vector<double>, unsigned int>> scenarios{
+    {{60, 10, 10, 10, 1}, 20},
+    {{20, 10, 5, 5, 2}, 100}};
+
+  for (const auto& scenario : scenarios)
+  {
+    const auto& energies = scenario.first;
+    const auto units = scenario.second;
+    const auto unit = split_statistics(ResourceSplitter::Mode::Unit, energies, units,
+        repetitions);
+
+    for (const auto mode : {ResourceSplitter::Mode::Bulk, ResourceSplitter::Mode::Sweep})
+    {
+      const auto batch = split_statistics(mode, energies, units, repetitions);
+      for (std::size_t index = 0; index < energies.size(); ++index)
+      {
+        CHECK(batch.resources[index] ==
+            Approx(unit.resources[index]).epsilon(0.05).margin(0.05));
+      }
+      CHECK(batch.deaths == Approx(unit.deaths).epsilon(0.05));
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,140 @@
+#include "catch/catch.hpp"
+
+#include "fictional-fiesta/world/itf/Snapshot.h"
+
+#include "fictional-fiesta/world/itf/Checkpoint.h"
+#include "fictional-fiesta/world/itf/ConstantSource.h"
+#include "fictional-fiesta/world/itf/Individual.h"
+#include "fictional-fiesta/world/itf/World.h"
+
+#include "fictional-fiesta/utils/itf/Exception.h"
+
+#include "test/test_utils/itf/CheckpointResume.h"
+
+#include <experimental/filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace fs = std::experimental::filesystem;
+using namespace fictionalfiesta;
+
+static const fs::path result_directory = fs::path(TEST_BINARY_DIRECTORY)
+    / fs::path("fictional-fiesta/world/result");
+
+namespace
+{
+
+std::string read_file(const fs::path& filePath)
+{
+  std::ifstream stream(filePath, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+void write_file(const fs::path& filePath, const std::string& contents)
+{
+  std::ofstream(filePath, std::ios::binary) << contents;
+}
+
+} // anonymous namespace
+
+TEST_CASE("Test saving and loading a world snapshot", "[SnapshotTest][TestWorldRoundTrip]")
+{
+  const auto world = testutils::createCheckpointWorld();
+
+  const auto snapshot_file = result_directory / fs::path("snapshot_world.ffsnap");
+  Snapshot::save(world, snapshot_file);
+  CHECK(Snapshot::isSnapshot(snapshot_file));
+  CHECK_FALSE(Snapshot::isCheckpoint(snapshot_file));
+
+  // The same world as the one saved in XML, down to the last bit of the traits.
+  const auto loaded = Snapshot::loadWorld(snapshot_file);
+  CHECK(loaded.saveXmlToString() == world.saveXmlToString());
+
+  // An empty world too.
+  const auto empty_file = result_directory / fs::path("snapshot_empty_world.ffsnap");
+  Snapshot::save(World{}, empty_file);
+  CHECK(Snapshot::loadWorld(empty_file).saveXmlToString() == World{}.saveXmlToString());
+}
+
+TEST_CASE("Test saving a snapshot with tombstones", "[SnapshotTest][TestTombstones]")
+{
+  Location location;
+  location.addSource(std::make_unique<ConstantSource>("Light", 3));
+  for (unsigned int index = 0; index < 50; ++index)
+  {
+    location.addIndividual(Individual{Genotype{4.1, 0.9, 0.03}, 1.0});
+  }
+
+  // The individuals that starve are left as tombstones until the population is compacted.
+  auto rng = FSM::createRng(3);
+  location.resourcePhase(rng);
+  location.maintenancePhase(rng);
+
+  World world;
+  world.addLocation(Location{location});
+
+  const auto snapshot_file = result_directory / fs::path("snapshot_tombstones.ffsnap");
+  Snapshot::save(world, snapshot_file);
+  CHECK(Snapshot::loadWorld(snapshot_file).saveXmlToString() == world.saveXmlToString());
+}
+
+TEST_CASE("Test resuming a run from a checkpoint snapshot", "[SnapshotTest][TestResume]")
+{
+  const auto snapshot_file = result_directory / fs::path("snapshot_checkpoint.ffsnap");
+  testutils::checkResume([&snapshot_file](const Checkpoint& interrupted)
+  {
+    Snapshot::save(interrupted, snapshot_file);
+    CHECK(Snapshot::isCheckpoint(snapshot_file));
+
+    // The world of a checkpoint snapshot can be loaded alone.
+    CHECK(Snapshot::loadWorld(snapshot_file).saveXmlToString() ==
+        interrupted.getWorld().saveXmlToString());
+    return Snapshot::loadCheckpoint(snapshot_file);
+  });
+}
+
+TEST_CASE("Test loading invalid snapshots", "[SnapshotTest][TestInvalid]")
+{
+  const auto world_file = result_directory / fs::path("snapshot_valid.ffsnap");
+  Snapshot::save(testutils::createCheckpointWorld(), world_file);
+  const auto contents = read_file(world_file);
+
+  SECTION("XML file")
+  {
+    const auto xml_file = result_directory / fs::path("snapshot_world.xml");
+    testutils::createCheckpointWorld().save(xml_file);
+    CHECK_FALSE(Snapshot::isSnapshot(xml_file));
+    CHECK_THROWS_AS(Snapshot::loadWorld(xml_file), Exception);
+  }
+
+  SECTION("Missing file")
+  {
+    const auto missing_file = result_directory / fs::path("snapshot_missing.ffsnap");
+    CHECK_FALSE(Snapshot::isSnapshot(missing_file));
+    CHECK_THROWS_AS(Snapshot::loadWorld(missing_file), Exception);
+  }
+
+  SECTION("Other version")
+  {
+    // The version follows the magic bytes and the byte order mark.
+    auto other_version = contents;
+    other_version[12] = static_cast<char>(other_version[12] + 1);
+    const auto other_version_file = result_directory / fs::path("snapshot_version.ffsnap");
+    write_file(other_version_file, other_version);
+    CHECK(Snapshot::isSnapshot(other_version_file));
+    CHECK_THROWS_AS(Snapshot::loadWorld(other_version_file), Exception);
+  }
+
+  SECTION("Truncated")
+  {
+    const auto truncated_file = result_directory / fs::path("snapshot_truncated.ffsnap");
+    write_file(truncated_file, contents.substr(0, contents.size() - 1));
+    CHECK_THROWS_AS(Snapshot::loadWorld(truncated_file), Exception);
+  }
+
+  SECTION("World as a checkpoint")
+  {
+    CHECK_THROWS_AS(Snapshot::loadCheckpoint(world_file), Exception);
+  }
+}
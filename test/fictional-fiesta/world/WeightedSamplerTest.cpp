@@ -0,0 +1,93 @@
+#include "catch/catch.hpp"
+
+#include "fictional-fiesta/world/itf/WeightedSampler.h"
+
+#include "fictional-fiesta/utils/itf/Exception.h"
+
+#include <vector>
+
+using namespace fictionalfiesta;
+
+TEST_CASE("Test weighted sampler construction", "[WeightedSamplerTest][TestConstructor]")
+{
+  {
+    const WeightedSampler sampler({});
+    CHECK(sampler.size() == 0);
+    CHECK(sampler.empty());
+    CHECK(sampler.getTotalWeight() == 0);
+  }
+  {
+    const WeightedSampler sampler({0, 0, 0});
+    CHECK(sampler.size() == 3);
+    CHECK(sampler.empty());
+    CHECK(sampler.getTotalWeight() == 0);
+  }
+  {
+    const WeightedSampler sampler({1, 0, 2, 3, 0.5});
+    CHECK(sampler.size() == 5);
+    CHECK(!sampler.empty());
+    CHECK(sampler.getWeight(2) == 2);
+    CHECK(sampler.getTotalWeight() == 6.5);
+  }
+
+  REQUIRE_THROWS_AS(WeightedSampler({1, -1}), Exception);
+}
+
+TEST_CASE("Test weighted sampler find", "[WeightedSamplerTest][TestFind]")
+{
+  const WeightedSampler sampler({1, 0, 2, 3, 0, 0.5, 0});
+
+  CHECK(sampler.find(0) == 0);
+  CHECK(sampler.find(0.99) == 0);
+  CHECK(sampler.find(1) == 2);
+  CHECK(sampler.find(2.99) == 2);
+  CHECK(sampler.find(3) == 3);
+  CHECK(sampler.find(5.99) == 3);
+  CHECK(sampler.find(6) == 5);
+  CHECK(sampler.find(6.49) == 5);
+
+  // Out of range targets fall on the closest index with weight.
+  CHECK(sampler.find(10) == 5);
+}
+
+TEST_CASE("Test weighted sampler weight updates", "[WeightedSamplerTest][TestSetWeight]")
+{
+  WeightedSampler sampler({1, 2, 3, 4});
+
+  sampler.setWeight(1, 0);
+  CHECK(sampler.getTotalWeight() == 8);
+  CHECK(sampler.find(1) == 2);
+
+  sampler.setWeight(0, 0);
+  sampler.setWeight(2, 0);
+  CHECK(sampler.getTotalWeight() == 4);
+  CHECK(sampler.find(0) == 3);
+
+  sampler.setWeight(3, 0);
+  CHECK(sampler.empty());
+  CHECK(sampler.getTotalWeight() == 0);
+  REQUIRE_THROWS_AS(sampler.find(0), Exception);
+
+  sampler.setWeight(1, 5);
+  CHECK(!sampler.empty());
+  CHECK(sampler.find(4.5) == 1);
+
+  REQUIRE_THROWS_AS(sampler.setWeight(1, -1), Exception);
+}
+
+TEST_CASE("Test weighted sampler draws like a discrete distribution",
+    "[WeightedSamplerTest][TestDraw]")
+{
+  const std::vector<double> weights{60, 10, 0, 10, 1, 25.5};
+
+  auto sampler_rng = FSM::createRng(0);
+  auto reference_rng = FSM::createRng(0);
+
+  const WeightedSampler sampler(weights);
+  std::discrete_distribution<std::size_t> reference(weights.begin(), weights.end());
+
+  for (int draw = 0; draw < 1000; ++draw)
+  {
+    REQUIRE(sampler.draw(sampler_rng) == reference(reference_rng));
+  }
+}
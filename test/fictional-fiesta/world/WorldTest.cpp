@@ -6,12 +6,16 @@
 #include "fictional-fiesta/world/itf/Individual.h"
 
 #include "fictional-fiesta/utils/itf/Exception.h"
+#include "fictional-fiesta/utils/itf/Parallel.h"
 #include "fictional-fiesta/utils/itf/XmlDocument.h"
 #include "fictional-fiesta/utils/itf/XmlNode.h"
+#include "fictional-fiesta/utils/itf/XmlStreamReader.h"
 
 #include "test/test_utils/itf/BenchmarkFiles.h"
 
+#include <chrono>
 #include <experimental/filesystem>
+#include <sstream>
 
 namespace fs = std::experimental::filesystem;
 using namespace fictionalfiesta;
@@ -74,3 +78,162 @@ TEST_CASE("Test loading and saving a world from XML", "[WorldTest][TestLoadSave]
   const auto& benchmark_file = benchmark_directory / fs::path("loaded_world_1.xml");
   benchmarkFiles(benchmark_file, result_file, result_directory);
 }
+
+TEST_CASE("Test streaming a world from XML", "[WorldTest][TestStreamedLoad]")
+{
+  const auto& input_file = input_directory / fs::path("world_1.xml");
+
+  std::stringstream expected;
+  World{XmlDocument{input_file}.getRootNode()}.save(expected);
+
+  std::stringstream result;
+  World{input_file}.save(result);
+
+  CHECK(result.str() == expected.str());
+}
+
+TEST_CASE("Test loading the locations in parallel", "[WorldTest][TestParallelLoad]")
+{
+  World world;
+  for (unsigned int location_index = 0; location_index < 12; ++location_index)
+  {
+    Location location;
+    location.addSource(std::make_unique<ConstantSource>("Light", 10 + location_index));
+
+    const Genotype genotype{4.0 + location_index, 0.5, 0.01 + 0.001 * location_index};
+    for (unsigned int index = 0; index < 50 * location_index; ++index)
+    {
+      location.addIndividual(Individual{genotype, 1.0 + index});
+    }
+    world.addLocation(std::move(location));
+  }
+
+  const auto& result_file = result_directory / fs::path("parallel_world.xml");
+  world.save(result_file);
+  const auto expected = world.saveXmlToString();
+
+  // From a file, the locations are parsed in parallel.
+  for (const unsigned int thread_count : {1u, 4u})
+  {
+    CHECK(World{result_file, thread_count}.saveXmlToString() == expected);
+    CHECK(World{XmlDocument{result_file}.getRootNode(), thread_count}.saveXmlToString() ==
+        expected);
+  }
+
+  // From a stream, they are parsed while they are read.
+  std::stringstream input{expected};
+  XmlStreamReader reader{input};
+  CHECK(World{reader, 4}.saveXmlToString() == expected);
+}
+
+TEST_CASE("Test that the cycles do not depend on the number of threads",
+    "[WorldTest][TestThreadCount]")
+{
+  const auto create_world = []()
+  {
+    World world;
+    for (unsigned int location_index = 0; location_index < 12; ++location_index)
+    {
+      Location location;
+      location.addSource(std::make_unique<ConstantSource>("Light", 100 + 10 * location_index));
+
+      const Genotype genotype{4, 1, 0.01};
+      for (unsigned int index = 0; index < 20; ++index)
+      {
+        location.addIndividual(Individual{genotype, 4.0});
+      }
+      world.addLocation(std::move(location));
+    }
+    return world;
+  };
+
+  std::string reference;
+  for (const unsigned int thread_count : {1u, 2u, 5u, 16u})
+  {
+    auto world = create_world();
+    world.setThreadCount(thread_count);
+    CHECK(world.getThreadCount() == thread_count);
+
+    auto rng = FSM::createRng(0);
+    for (unsigned int cycle = 0; cycle < 10; ++cycle)
+    {
+      world.cycle(rng);
+    }
+
+    const auto result = world.str(0);
+    if (reference.empty())
+    {
+      reference = result;
+    }
+    CHECK(result == reference);
+  }
+}
+
+TEST_CASE("Benchmark the location scheduling on a skewed world", "[WorldTest][.benchmark]")
+{
+  // A few crowded locations at the end of the list (the worst case for an in-order schedule)
+  // and lots of empty or tiny ones.
+  const auto create_locations = []()
+  {
+    std::vector<Location> locations;
+    for (unsigned int location_index = 0; location_index < 256; ++location_index)
+    {
+      Location location;
+      const bool is_big = (location_index % 64 == 63);
+      location.addSource(std::make_unique<ConstantSource>("Light", is_big ? 200000 : 20));
+
+      const Genotype genotype{4, 1, 0.01};
+      const unsigned int population = is_big ? 20000 : location_index % 3;
+      for (unsigned int index = 0; index < population; ++index)
+      {
+        location.addIndividual(Individual{genotype, 4.0});
+      }
+      locations.push_back(std::move(location));
+    }
+    return locations;
+  };
+
+  const unsigned int thread_count = Parallel::resolveThreadCount(0);
+  const unsigned int cycles = 5;
+
+  const auto run = [&](const std::string& name, bool useCosts, unsigned int threads)
+  {
+    auto locations = create_locations();
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int cycle = 0; cycle < cycles; ++cycle)
+    {
+      const auto task = [&locations, cycle](std::size_t index)
+      {
+        auto rng = FSM::createRng(cycle, index);
+        locations[index].cycle(rng);
+      };
+
+      if (useCosts)
+      {
+        std::vector<double> costs;
+        for (const auto& location : locations)
+        {
+          costs.push_back(location.getCostHint());
+        }
+        Parallel::forEach(costs, threads, task);
+      }
+      else
+      {
+        Parallel::forEach(locations.size(), threads, task);
+      }
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    WARN(name << " (" << threads << " threads): " << elapsed.count() << " s");
+
+    std::string result;
+    for (const auto& location : locations)
+    {
+      result += location.str(0);
+    }
+    return result;
+  };
+
+  const auto serial = run("Serial", false, 1);
+  CHECK(run("In-order dynamic schedule", false, thread_count) == serial);
+  CHECK(run("Cost-hinted work stealing", true, thread_count) == serial);
+}
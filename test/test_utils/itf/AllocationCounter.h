@@ -0,0 +1,20 @@
+#ifndef INCLUDE_TEST_TEST_UTILS_ALLOCATION_COUNTER_H
+#define INCLUDE_TEST_TEST_UTILS_ALLOCATION_COUNTER_H
+
+#include <cstddef>
+
+namespace testutils
+{
+
+/// @brief Gets the number of calls to the global operator new so far.
+///
+/// The test binary replaces the global operator new to count the calls, so the tests can check
+/// that some code does not allocate: the difference of two calls to this function is the number
+/// of allocations in between.
+///
+/// @return Number of allocations since the start of the program.
+std::size_t getAllocationCount();
+
+} // namespace testutils
+
+#endif
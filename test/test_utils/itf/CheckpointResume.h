@@ -0,0 +1,34 @@
+#ifndef INCLUDE_TEST_TEST_UTILS_CHECKPOINT_RESUME_H
+#define INCLUDE_TEST_TEST_UTILS_CHECKPOINT_RESUME_H
+
+#include "fictional-fiesta/world/itf/Checkpoint.h"
+#include "fictional-fiesta/world/itf/World.h"
+
+#include <functional>
+
+namespace testutils
+{
+
+/// @brief Creates the world used to check the checkpoints.
+///
+/// It has three locations, each one with a finite and an infinite source and a population with
+/// fed and dead individuals. The traits are not exactly representable, so they must be saved
+/// with all their bits to resume a run exactly.
+///
+/// @return The world.
+fictionalfiesta::World createCheckpointWorld();
+
+/// @brief Checks with test checks that a run resumed from a saved checkpoint ends in the same
+///   state as the uninterrupted run, down to the last bit.
+///
+/// The check is done with the default resource split settings and with sharded sweep splits,
+/// which must be restored from the checkpoint too.
+///
+/// @param saveAndLoad Function that saves the interrupted checkpoint and loads it back.
+void checkResume(
+    const std::function<fictionalfiesta::Checkpoint(const fictionalfiesta::Checkpoint&)>&
+    saveAndLoad);
+
+} // namespace testutils
+
+#endif
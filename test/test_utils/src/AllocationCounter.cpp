@@ -0,0 +1,47 @@
+/// @file AllocationCounter.cpp Replacement of the global operator new that counts the calls.
+
+#include "test/test_utils/itf/AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+
+/// Number of calls to the global operator new.
+std::atomic<std::size_t> allocation_count{0};
+
+} // anonymous namespace
+
+namespace testutils
+{
+
+std::size_t getAllocationCount()
+{
+  return allocation_count.load();
+}
+
+} // namespace testutils
+
+// The replacements apply to the whole test binary, but they only add a counter. They live in
+// their own translation unit so the compiler does not mix them up with the inlined library ones.
+void* operator new(std::size_t size)
+{
+  ++allocation_count;
+  if (auto pointer = std::malloc(size == 0 ? 1 : size))
+  {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+}
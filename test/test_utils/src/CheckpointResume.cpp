@@ -0,0 +1,91 @@
+/// @file CheckpointResume.cpp Implementation of the checkpoint resume test utilities.
+
+#include "test/test_utils/itf/CheckpointResume.h"
+
+#include "fictional-fiesta/world/itf/ConstantSource.h"
+#include "fictional-fiesta/world/itf/Individual.h"
+#include "fictional-fiesta/world/itf/Location.h"
+#include "fictional-fiesta/world/itf/ResourceSplitter.h"
+
+#include "catch/catch.hpp"
+
+#include <memory>
+
+using namespace fictionalfiesta;
+
+namespace testutils
+{
+
+World createCheckpointWorld()
+{
+  World world;
+  for (unsigned int location_index = 0; location_index < 3; ++location_index)
+  {
+    Location location;
+    location.addSource(std::make_unique<ConstantSource>("Light", 150 + 25 * location_index, 7));
+    location.addSource(std::make_unique<ConstantSource>("Water", Source::INFINITY_UNITS));
+
+    const Genotype genotype{4.1, 0.9, 0.03};
+    for (unsigned int index = 0; index < 20 + 10 * location_index; ++index)
+    {
+      Individual individual{genotype, 4.3 + index};
+      individual.feed(index % 3);
+      if (index % 7 == 0)
+      {
+        individual.die();
+      }
+      location.addIndividual(individual);
+    }
+    world.addLocation(std::move(location));
+  }
+  return world;
+}
+
+void checkResume(const std::function<Checkpoint(const Checkpoint&)>& saveAndLoad)
+{
+  for (const auto sharded_sweep : {false, true})
+  {
+    const auto create_world = [sharded_sweep]()
+    {
+      auto world = createCheckpointWorld();
+      if (sharded_sweep)
+      {
+        world.setResourceSplitMode(ResourceSplitter::Mode::Sweep);
+        world.setShardedResourceSplit(true);
+      }
+      return world;
+    };
+
+    const unsigned int cycle_count = 12;
+    Checkpoint uninterrupted{create_world(), FSM::createRng(4)};
+    for (unsigned int cycle = 0; cycle < cycle_count; ++cycle)
+    {
+      uninterrupted.cycle();
+    }
+    CHECK(uninterrupted.getCycleCount() == cycle_count);
+
+    Checkpoint interrupted{create_world(), FSM::createRng(4)};
+    for (unsigned int cycle = 0; cycle < 5; ++cycle)
+    {
+      interrupted.cycle();
+    }
+
+    auto resumed = saveAndLoad(interrupted);
+    CHECK(resumed.getCycleCount() == 5);
+    CHECK(resumed.getRng() == interrupted.getRng());
+    CHECK(resumed.getWorld().getResourceSplitMode() ==
+        interrupted.getWorld().getResourceSplitMode());
+    CHECK(resumed.getWorld().isShardedResourceSplit() == sharded_sweep);
+    CHECK(resumed.saveXmlToString() == interrupted.saveXmlToString());
+
+    while (resumed.getCycleCount() < cycle_count)
+    {
+      resumed.cycle();
+    }
+
+    CHECK(resumed.getRng() == uninterrupted.getRng());
+    CHECK(resumed.saveXmlToString() == uninterrupted.saveXmlToString());
+  }
+}
+
+} // namespace testutils
@@ -0,0 +1,113 @@
+#include "fictional-fiesta/world/itf/Checkpoint.h"
+#include "fictional-fiesta/world/itf/Snapshot.h"
+#include "fictional-fiesta/world/itf/World.h"
+
+#include "fictional-fiesta/utils/itf/XmlStreamReader.h"
+
+#include <boost/program_options.hpp>
+
+#include <experimental/filesystem>
+
+#include <iostream>
+
+namespace fs = std::experimental::filesystem;
+namespace po = boost::program_options;
+
+using namespace fictionalfiesta;
+
+namespace
+{
+void missing_option(const std::string& option);
+
+void snapshot_to_xml(const fs::path& input, const fs::path& output);
+
+void xml_to_snapshot(const fs::path& input, const fs::path& output);
+}
+
+int main(int argc, char* argv[])
+{
+  // Declare the supported options.
+  po::options_description description("Converts a world or a checkpoint between XML and the "
+      "binary snapshot format (the input format is detected from its contents).\n"
+      "Allowed options");
+  description.add_options()
+    ("help,h", "Produce help message.")
+    ("input,i", po::value<std::string>(), "Path to the world or checkpoint to be converted.")
+    ("output,o", po::value<std::string>(), "Path where the converted world or checkpoint is "
+        "saved.");
+
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, description), vm);
+  po::notify(vm);
+
+  if (vm.count("help"))
+  {
+    std::cout << description << "\n";
+    return 1;
+  }
+
+  for (const auto option : {"input", "output"})
+  {
+    if (!vm.count(option))
+    {
+      missing_option(option);
+      return 1;
+    }
+  }
+
+  const fs::path input{vm["input"].as<std::string>()};
+  const fs::path output{vm["output"].as<std::string>()};
+
+  if (Snapshot::isSnapshot(input))
+  {
+    snapshot_to_xml(input, output);
+  }
+  else
+  {
+    xml_to_snapshot(input, output);
+  }
+}
+
+namespace
+{
+
+void missing_option(const std::string& option)
+{
+  std::cerr << "Missing mandatory option '" + option + "'.\n";
+}
+
+void snapshot_to_xml(const fs::path& input, const fs::path& output)
+{
+  if (Snapshot::isCheckpoint(input))
+  {
+    Snapshot::loadCheckpoint(input).save(output);
+    std::cout << "Checkpoint snapshot " << input.string() << " converted to XML in " <<
+        output.string() << "\n";
+  }
+  else
+  {
+    Snapshot::loadWorld(input).save(output);
+    std::cout << "World snapshot " << input.string() << " converted to XML in " <<
+        output.string() << "\n";
+  }
+}
+
+void xml_to_snapshot(const fs::path& input, const fs::path& output)
+{
+  // Streamed, so no XML document larger than the world is held in memory.
+  XmlStreamReader reader{input};
+  if (reader.getName() == Checkpoint::XML_MAIN_NODE_NAME)
+  {
+    Snapshot::save(Checkpoint{reader}, output);
+    std::cout << "Checkpoint " << input.string() << " converted to a snapshot in " <<
+        output.string() << "\n";
+  }
+  else
+  {
+    Snapshot::save(World{reader}, output);
+    std::cout << "World " << input.string() << " converted to a snapshot in " <<
+        output.string() << "\n";
+  }
+}
+
+}
@@ -1,3 +1,5 @@
+#include "fictional-fiesta/world/itf/Checkpoint.h"
+#include "fictional-fiesta/world/itf/Snapshot.h"
 #include "fictional-fiesta/world/itf/World.h"
 #include "fictional-fiesta/world/itf/Location.h"
 
@@ -5,6 +7,7 @@
 
 #include <experimental/filesystem>
 
+#include <algorithm>
 #include <iostream>
 
 namespace fs = std::experimental::filesystem;
@@ -15,6 +18,8 @@ using namespace fictionalfiesta;
 namespace
 {
 void missing_option(const std::string& option);
+
+void save_checkpoint(const Checkpoint& checkpoint, const fs::path& path, bool binary);
 }
 
 int main(int argc, char* argv[])
@@ -23,9 +28,33 @@ int main(int argc, char* argv[])
   po::options_description description("Allowed options");
   description.add_options()
     ("help,h", "Produce help message.")
-    ("cycles,c", po::value<int>(), "Number of cycles (iterations).")
+    ("cycles,c", po::value<int>(), "Number of cycles (iterations), counted from the start of the "
+        "run (a resumed run only runs the missing ones).")
     ("seed,s", po::value<int>(), "Seed of the RNG engine.")
-    ("world,w", po::value<std::string>(), "Path to the initial world state.");
+    ("threads,t", po::value<unsigned int>()->default_value(1),
+        "Number of threads used to run the locations (0 means one per hardware thread). The "
+        "results do not depend on it.")
+    ("location-threads,l", po::value<unsigned int>()->default_value(1),
+        "Number of threads used inside each location for the maintenance and reproduction "
+        "phases (0 means one per hardware thread). The results do not depend on it.")
+    ("split-mode,m", po::value<std::string>()->default_value("unit"),
+        "Resource split mode: 'unit' (exact, one unit at a time), 'bulk' (multinomial rounds) "
+        "or 'sweep' (sorted uniform batches). A resumed run keeps the mode of its checkpoint.")
+    ("sharded-split", "Split the resources of each location in parallel shards of its "
+        "population, using the location threads. Statistically equivalent to the serial split. "
+        "A resumed run keeps the setting of its checkpoint.")
+    ("world,w", po::value<std::string>(), "Path to the initial world state, in XML or as a "
+        "binary snapshot (detected from its contents).")
+    ("resume,r", po::value<std::string>(), "Path to a checkpoint to resume the run from, "
+        "instead of an initial world, in XML or as a binary snapshot. The run continues "
+        "bit-identically with the resource split settings of the checkpoint (the seed is "
+        "ignored, and so are the split options unless they differ, which is an error).")
+    ("checkpoint,k", po::value<std::string>(), "Path where the checkpoint of the run (world, "
+        "RNG state and cycle count) is saved at the end and every checkpoint interval.")
+    ("checkpoint-interval,i", po::value<unsigned int>()->default_value(0),
+        "Number of cycles between checkpoints (0 means only at the end).")
+    ("checkpoint-format,f", po::value<std::string>()->default_value("binary"),
+        "Format of the checkpoints: 'binary' (snapshot, fast to save and load) or 'xml'.");
 
   po::variables_map vm;
   po::store(po::parse_command_line(argc, argv, description), vm);
@@ -48,37 +77,106 @@ int main(int argc, char* argv[])
   const auto cycle_count = vm[cycles_option].as<int>();
 
   constexpr auto world_option = "world";
-  if (!vm.count(world_option))
+  constexpr auto resume_option = "resume";
+  if (!vm.count(world_option) && !vm.count(resume_option))
   {
     missing_option(world_option);
     return 1;
   }
 
-  constexpr auto rng_seed_option = "seed";
+  // The loading uses the same threads as the cycles.
+  constexpr auto threads_option = "threads";
+  const auto thread_count = vm[threads_option].as<unsigned int>();
 
-  auto rng = vm.count(rng_seed_option) ?
-      FSM::createRng(vm[rng_seed_option].as<int>()) :
-      FSM::createRng();
+  auto checkpoint = [&vm, world_option, resume_option, thread_count]()
+  {
+    if (vm.count(resume_option))
+    {
+      const auto checkpoint_filename = vm[resume_option].as<std::string>();
+      std::cout << "Resumed checkpoint file: " << checkpoint_filename << "\n";
+      return Snapshot::isSnapshot(checkpoint_filename) ?
+          Snapshot::loadCheckpoint(checkpoint_filename) :
+          Checkpoint{fs::path(checkpoint_filename), thread_count};
+    }
+
+    constexpr auto rng_seed_option = "seed";
+    auto rng = vm.count(rng_seed_option) ?
+        FSM::createRng(vm[rng_seed_option].as<int>()) :
+        FSM::createRng();
+
+    const auto world_filename = vm[world_option].as<std::string>();
+    std::cout << "Initial world file: " << world_filename << "\n";
+    return Checkpoint{Snapshot::isSnapshot(world_filename) ?
+        Snapshot::loadWorld(world_filename) : World{fs::path(world_filename), thread_count}, rng};
+  }();
+
+  std::cout << "Evolving " << cycle_count << " cycles from cycle " <<
+      checkpoint.getCycleCount() << "...\n";
+
+  auto& world = checkpoint.getWorld();
+
+  constexpr auto split_mode_option = "split-mode";
+  const auto split_mode = ResourceSplitter::modeFromString(
+      vm[split_mode_option].as<std::string>());
+
+  constexpr auto sharded_split_option = "sharded-split";
+  const auto sharded_split = vm.count(sharded_split_option) > 0;
+
+  // A resumed run keeps the settings of its checkpoint, which are only checked against the
+  // options given explicitly.
+  if (!vm.count(resume_option))
+  {
+    world.setResourceSplitMode(split_mode);
+    world.setShardedResourceSplit(sharded_split);
+  }
+  else if ((!vm[split_mode_option].defaulted() && split_mode != world.getResourceSplitMode()) ||
+      (sharded_split && !world.isShardedResourceSplit()))
+  {
+    std::cerr << "The resource split options differ from the ones of the checkpoint ('" +
+        ResourceSplitter::modeToString(world.getResourceSplitMode()) + "' mode, " +
+        (world.isShardedResourceSplit() ? "sharded" : "not sharded") + ").\n";
+    return 1;
+  }
+
+  world.setThreadCount(thread_count);
 
-  const auto world_filename = vm[world_option].as<std::string>();
+  constexpr auto location_threads_option = "location-threads";
+  world.setLocationThreadCount(vm[location_threads_option].as<unsigned int>());
 
-  std::cout << "Evolving " << cycle_count << " cycles...\n";
-  std::cout << "Initial world file: " << world_filename << "\n";
+  constexpr auto checkpoint_option = "checkpoint";
+  constexpr auto checkpoint_interval_option = "checkpoint-interval";
+  const auto checkpoint_interval = vm[checkpoint_interval_option].as<unsigned int>();
 
-  const auto& world_path = fs::path(world_filename);
-  auto world = World{world_path};
+  constexpr auto checkpoint_format_option = "checkpoint-format";
+  const auto checkpoint_format = vm[checkpoint_format_option].as<std::string>();
+  if (checkpoint_format != "binary" && checkpoint_format != "xml")
+  {
+    std::cerr << "Unknown checkpoint format '" + checkpoint_format + "'.\n";
+    return 1;
+  }
+  const auto binary_checkpoints = checkpoint_format == "binary";
 
-  for (int cycle_index = 0; cycle_index < cycle_count; ++cycle_index)
+  while (checkpoint.getCycleCount() < static_cast<unsigned long long>(std::max(cycle_count, 0)))
   {
     std::cout << world << std::endl;
-    std::cout << "Cycle " << cycle_index << ":\n";
-    world.cycle(rng);
+    std::cout << "Cycle " << checkpoint.getCycleCount() << ":\n";
+    checkpoint.cycle();
     //std::cout << "Population : " << location.getIndividuals().size() << std::endl;
 
-    //location.cycle(rng);
+    if (vm.count(checkpoint_option) && checkpoint_interval != 0 &&
+        checkpoint.getCycleCount() % checkpoint_interval == 0)
+    {
+      save_checkpoint(checkpoint, vm[checkpoint_option].as<std::string>(),
+          binary_checkpoints);
+    }
   }
   std::cout << "End:\n";
   std::cout << world << std::endl;
+
+  if (vm.count(checkpoint_option))
+  {
+    save_checkpoint(checkpoint, vm[checkpoint_option].as<std::string>(), binary_checkpoints);
+  }
 }
 
 namespace
@@ -89,4 +187,22 @@ void missing_option(const std::string& option)
   std::cerr << "Missing mandatory option '" + option + "'.\n";
 }
 
+void save_checkpoint(const Checkpoint& checkpoint, const fs::path& path, bool binary)
+{
+  // Written aside and renamed, so a run stopped while saving keeps the previous checkpoint.
+  auto temporary_path = path;
+  temporary_path += ".tmp";
+  if (binary)
+  {
+    Snapshot::save(checkpoint, temporary_path);
+  }
+  else
+  {
+    checkpoint.save(temporary_path);
+  }
+  fs::rename(temporary_path, path);
+  std::cout << "Checkpoint of cycle " << checkpoint.getCycleCount() << " saved to " <<
+      path.string() << "\n";
+}
+
 }